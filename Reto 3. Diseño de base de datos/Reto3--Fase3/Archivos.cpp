@@ -0,0 +1,272 @@
+#include "Archivos.h"
+#include "LectorCSV.h"
+#include <algorithm>
+#include <charconv>
+#include <cinttypes>
+#include <cstring>
+#include <filesystem>
+#include <fcntl.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+const std::uint64_t PRIMO_FNV = 0x100000001b3ULL;
+
+// Línea de control de ancho fijo: se reserva al abrir y se reescribe al cerrar
+const char* const FORMATO_CONTROL = "#control,%020" PRIu64 ",%016" PRIx64 "\n";
+const std::size_t LARGO_CONTROL = 47;
+const std::string_view PREFIJO_CONTROL = "#control,";
+
+// Cabecera de los archivos de registros fijos, rellenada con espacios hasta LARGO_REGISTRO
+const char* const FORMATO_FIJO = "#fijo,%020" PRIu64 ",%020" PRIu64 ",%02" PRIu64;
+const std::string_view PREFIJO_FIJO = "#fijo,";
+
+// Registros interrumpidos que admite un archivo (ver leerVerificado)
+const std::size_t MAX_INTERRUMPIDOS = 1;
+
+// Checksum de 16 bits de los primeros 'n' bytes de un registro
+std::uint16_t checksumRegistro(const char* registro, std::size_t n) {
+    Checksum64 suma;
+    suma.agregar(registro, n);
+    return static_cast<std::uint16_t>(suma.valor());
+}
+
+// La cabecera y el largo deben ser correctos; ver leerVerificado para los registros
+EstadoArchivo verificarRegistros(std::string_view& contenido, std::uint64_t& generacion,
+                                 std::vector<std::size_t>* interrumpidos) {
+    std::uint64_t registros = 0;
+    std::uint64_t fijos = 0;
+    int campos = contenido.size() < LARGO_REGISTRO ? 0 :
+        std::sscanf(contenido.data(), "#fijo,%" SCNu64 ",%" SCNu64 ",%" SCNu64, &generacion, &registros, &fijos);
+    if (campos < 2 || contenido[LARGO_REGISTRO - 1] != '\n' || registros != contenido.size() / LARGO_REGISTRO - 1 ||
+        contenido.size() % LARGO_REGISTRO != 0 || (campos == 3 && fijos > LARGO_REGISTRO - LARGO_SELLO)) {
+        return ARCHIVO_DANADO;
+    }
+    contenido.remove_prefix(LARGO_REGISTRO);
+    if (campos == 2) return ARCHIVO_SIN_CONTROL; // Un solo sello por registro: se lee sin verificar
+    std::size_t cuantos = 0;
+    for (std::size_t i = 0; i < contenido.size(); i += LARGO_REGISTRO) {
+        EstadoRegistro estado = verificarRegistro(contenido.data() + i, static_cast<std::size_t>(fijos));
+        if (estado == REGISTRO_VALIDO) continue;
+        if (estado == REGISTRO_DANADO || !interrumpidos || ++cuantos > MAX_INTERRUMPIDOS) return ARCHIVO_DANADO;
+        interrumpidos->push_back(i / LARGO_REGISTRO);
+    }
+    return ARCHIVO_VALIDO;
+}
+
+// Fuerza a disco lo escrito en un archivo ya volcado con fflush
+bool sincronizarArchivo(std::FILE* archivo) {
+#ifdef _WIN32
+    return _commit(_fileno(archivo)) == 0;
+#else
+    return fsync(fileno(archivo)) == 0;
+#endif
+}
+
+} // namespace
+
+// --- Checksum64 ---
+
+void Checksum64::mezclar(const char* palabra) {
+    std::uint64_t w;
+    std::memcpy(&w, palabra, sizeof w);
+    h = (h ^ w) * PRIMO_FNV;
+    h ^= h >> 29;
+}
+
+// Completa primero la palabra pendiente de la llamada anterior
+void Checksum64::agregar(const char* datos, std::size_t n) {
+    total += n;
+    if (nPendiente > 0) {
+        std::size_t k = std::min(sizeof pendiente - nPendiente, n);
+        std::memcpy(pendiente + nPendiente, datos, k);
+        nPendiente += k;
+        datos += k;
+        n -= k;
+        if (nPendiente < sizeof pendiente) return;
+        mezclar(pendiente);
+        nPendiente = 0;
+    }
+    for (; n >= 8; n -= 8, datos += 8) mezclar(datos);
+    std::memcpy(pendiente, datos, n);
+    nPendiente = n;
+}
+
+std::uint64_t Checksum64::valor() const {
+    std::uint64_t r = h;
+    for (std::size_t i = 0; i < nPendiente; ++i) r = (r ^ static_cast<unsigned char>(pendiente[i])) * PRIMO_FNV;
+    return (r ^ total) * PRIMO_FNV;
+}
+
+// --- ArchivoSalida ---
+
+ArchivoSalida::~ArchivoSalida() {
+    if (archivo) std::fclose(archivo); // Escritura abandonada: el temporal se descarta después
+}
+
+bool ArchivoSalida::abrir(const std::string& ruta, bool control) {
+    archivo = std::fopen(ruta.c_str(), "wb");
+    if (!archivo) return false;
+    conControl = control;
+    error = false;
+    suma = Checksum64();
+    setp(buffer, buffer + sizeof buffer);
+    // La línea de control se escribe con ceros y se completa en cerrar()
+    if (conControl && std::fprintf(archivo, FORMATO_CONTROL, std::uint64_t(0), std::uint64_t(0)) < 0) error = true;
+    return true;
+}
+
+bool ArchivoSalida::vaciar() {
+    std::size_t n = static_cast<std::size_t>(pptr() - pbase());
+    if (n > 0) {
+        suma.agregar(pbase(), n);
+        if (std::fwrite(pbase(), 1, n, archivo) != n) error = true;
+    }
+    setp(buffer, buffer + sizeof buffer);
+    return !error;
+}
+
+// Un bloque que no cabe en lo que queda del buffer va directo al archivo tras vaciarlo
+bool ArchivoSalida::escribir(const char* datos, std::size_t n) {
+    if (!archivo) return false;
+    if (n < static_cast<std::size_t>(epptr() - pptr())) {
+        std::memcpy(pptr(), datos, n);
+        pbump(static_cast<int>(n));
+        return !error;
+    }
+    if (!vaciar()) return false;
+    suma.agregar(datos, n);
+    if (std::fwrite(datos, 1, n, archivo) != n) error = true;
+    return !error;
+}
+
+ArchivoSalida::int_type ArchivoSalida::overflow(int_type c) {
+    if (!archivo || !vaciar()) return traits_type::eof();
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+    }
+    return traits_type::not_eof(c);
+}
+
+int ArchivoSalida::sync() {
+    return archivo && vaciar() ? 0 : -1;
+}
+
+// Vuelca el buffer, completa la línea de control con el checksum del resto y hace fsync
+bool ArchivoSalida::cerrar(std::uint64_t generacion) {
+    if (!archivo) return false;
+    vaciar();
+    if (conControl) {
+        if (std::fseek(archivo, 0, SEEK_SET) != 0 ||
+            std::fprintf(archivo, FORMATO_CONTROL, generacion, suma.valor()) != static_cast<int>(LARGO_CONTROL)) {
+            error = true;
+        }
+    }
+    if (std::fflush(archivo) != 0 || !sincronizarArchivo(archivo)) error = true;
+    if (std::fclose(archivo) != 0) error = true;
+    archivo = nullptr;
+    return !error;
+}
+
+// --- Registros de ancho fijo ---
+
+void formatearCabeceraFija(char* destino, std::uint64_t generacion, std::uint64_t registros, std::size_t fijos) {
+    int n = std::snprintf(destino, LARGO_REGISTRO, FORMATO_FIJO, generacion, registros, std::uint64_t(fijos));
+    std::memset(destino + n, ' ', LARGO_REGISTRO - 1 - static_cast<std::size_t>(n));
+    destino[LARGO_REGISTRO - 1] = '\n';
+}
+
+// El checksum de la parte fija queda en los 4 primeros dígitos hexadecimales del sello:
+// una reescritura en su lugar los vuelve a escribir iguales
+void sellarRegistro(char* registro, std::size_t fijos) {
+    static const char HEX[] = "0123456789abcdef";
+    std::uint32_t suma = static_cast<std::uint32_t>(checksumRegistro(registro, fijos)) << 16 |
+                         checksumRegistro(registro, LARGO_REGISTRO - LARGO_SELLO);
+    char* sello = registro + LARGO_REGISTRO - LARGO_SELLO;
+    sello[0] = ',';
+    for (int i = 8; i >= 1; --i, suma >>= 4) sello[i] = HEX[suma & 0xF];
+    sello[9] = '\n';
+}
+
+EstadoRegistro verificarRegistro(const char* registro, std::size_t fijos) {
+    const char* sello = registro + LARGO_REGISTRO - LARGO_SELLO;
+    std::uint16_t parteFija = 0;
+    std::uint16_t todo = 0;
+    if (std::from_chars(sello + 1, sello + 5, parteFija, 16).ptr != sello + 5 ||
+        parteFija != checksumRegistro(registro, fijos)) {
+        return REGISTRO_DANADO;
+    }
+    bool completo = sello[0] == ',' && sello[9] == '\n' &&
+                    std::from_chars(sello + 5, sello + 9, todo, 16).ptr == sello + 9 &&
+                    todo == checksumRegistro(registro, LARGO_REGISTRO - LARGO_SELLO);
+    return completo ? REGISTRO_VALIDO : REGISTRO_INTERRUMPIDO;
+}
+
+bool conRegistrosFijos(std::string_view archivo) {
+    return archivo.compare(0, PREFIJO_FIJO.size(), PREFIJO_FIJO) == 0;
+}
+
+// Una sola escritura posicionada seguida de fsync, como la de cerrar()
+bool escribirEnPosicion(const std::string& ruta, std::uint64_t desplazamiento, const char* datos, std::size_t n) {
+#ifdef _WIN32
+    int fd = _open(ruta.c_str(), _O_WRONLY | _O_BINARY);
+    if (fd < 0) return false;
+    bool ok = _lseeki64(fd, static_cast<__int64>(desplazamiento), SEEK_SET) >= 0 &&
+              _write(fd, datos, static_cast<unsigned>(n)) == static_cast<int>(n) && _commit(fd) == 0;
+    return _close(fd) == 0 && ok;
+#else
+    int fd = open(ruta.c_str(), O_WRONLY);
+    if (fd < 0) return false;
+    bool ok = pwrite(fd, datos, n, static_cast<off_t>(desplazamiento)) == static_cast<ssize_t>(n) && fsync(fd) == 0;
+    return close(fd) == 0 && ok;
+#endif
+}
+
+// --- Lectura verificada ---
+
+EstadoArchivo leerVerificado(const std::string& ruta, std::string& buffer, std::string_view& contenido,
+                             std::uint64_t& generacion, std::vector<std::size_t>* interrumpidos) {
+    if (interrumpidos) interrumpidos->clear();
+    if (!csv::leerArchivo(ruta, buffer)) return ARCHIVO_AUSENTE;
+    contenido = buffer;
+    if (conRegistrosFijos(contenido)) return verificarRegistros(contenido, generacion, interrumpidos);
+    if (contenido.compare(0, PREFIJO_CONTROL.size(), PREFIJO_CONTROL) != 0) return ARCHIVO_SIN_CONTROL;
+    // Una línea de control incompleta o ilegible también es un archivo dañado
+    std::uint64_t esperado = 0;
+    if (buffer.size() < LARGO_CONTROL || buffer[LARGO_CONTROL - 1] != '\n' ||
+        std::sscanf(buffer.c_str(), "#control,%" SCNu64 ",%" SCNx64, &generacion, &esperado) != 2) {
+        return ARCHIVO_DANADO;
+    }
+    contenido.remove_prefix(LARGO_CONTROL);
+    Checksum64 suma;
+    suma.agregar(contenido.data(), contenido.size());
+    return suma.valor() == esperado ? ARCHIVO_VALIDO : ARCHIVO_DANADO;
+}
+
+// --- Reemplazo y sincronización ---
+
+bool reemplazarArchivo(const std::string& origen, const std::string& destino) {
+    std::error_code ec;
+    std::filesystem::rename(origen, destino, ec);
+    return !ec;
+}
+
+bool sincronizarDirectorio(const std::string& ruta) {
+#ifdef _WIN32
+    (void)ruta; // NTFS registra los renombrados en su propio diario
+    return true;
+#else
+    std::string directorio = std::filesystem::path(ruta).parent_path().string();
+    if (directorio.empty()) directorio = ".";
+    int fd = open(directorio.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    bool ok = fsync(fd) == 0;
+    close(fd);
+    return ok;
+#endif
+}
@@ -0,0 +1,102 @@
+#ifndef ARCHIVOS_H
+#define ARCHIVOS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Escritura segura de archivos de datos: checksum incremental, salida que termina con
+// fsync y reemplazo atomico por renombrado. Los CSV de las tablas empiezan con una linea
+// de control "#control,<generacion>,<checksum>" que cubre el resto del archivo.
+// Los archivos de registros de ancho fijo (ver mas abajo) se verifican registro por registro.
+
+// Checksum de 64 bits calculado por partes (FNV-1a por palabras de 8 bytes); el resultado
+// no depende de como se divida la entrada
+class Checksum64 {
+public:
+    void agregar(const char* datos, std::size_t n);
+    std::uint64_t valor() const;          // Incluye los bytes pendientes y la longitud total
+
+private:
+    void mezclar(const char* palabra);
+    std::uint64_t h = 0xcbf29ce484222325ULL;
+    char pendiente[8] = {};               // Bytes que aun no completan una palabra
+    std::size_t nPendiente = 0;
+    std::uint64_t total = 0;
+};
+
+// Salida a archivo para std::ostream que acumula el checksum de lo escrito.
+// cerrar() vuelca el buffer, escribe la linea de control (si se pidio) y hace fsync;
+// un archivo abandonado sin cerrar() no debe usarse.
+class ArchivoSalida : public std::streambuf {
+public:
+    ArchivoSalida() = default;
+    ~ArchivoSalida() override;
+    ArchivoSalida(const ArchivoSalida&) = delete;
+    ArchivoSalida& operator=(const ArchivoSalida&) = delete;
+
+    bool abrir(const std::string& ruta, bool conControl = false); // Reserva la linea de control
+    bool escribir(const char* datos, std::size_t n); // Sin std::ostream; los bloques grandes no se copian
+    bool cerrar(std::uint64_t generacion = 0);  // false ante cualquier error de escritura o fsync
+
+protected:
+    int_type overflow(int_type c) override;
+    int sync() override;
+
+private:
+    bool vaciar();                        // Pasa el buffer por el checksum y al archivo
+    std::FILE* archivo = nullptr;
+    bool conControl = false;
+    bool error = false;
+    Checksum64 suma;
+    char buffer[64 * 1024];
+};
+
+// Estado de un archivo leido con leerVerificado
+enum EstadoArchivo {
+    ARCHIVO_AUSENTE,       // No existe o no se puede abrir
+    ARCHIVO_VALIDO,        // Linea de control correcta
+    ARCHIVO_SIN_CONTROL,   // Escrito por una version anterior o a mano: no se puede verificar
+    ARCHIVO_DANADO         // Checksum distinto (archivo truncado o modificado)
+};
+
+// Archivo de registros de ancho fijo: la cabecera "#fijo,<generacion>,<registros>,<fijos>" y
+// cada registro ocupan LARGO_REGISTRO bytes. Los primeros <fijos> bytes de un registro nunca
+// se reescriben; el resto si, en su lugar (escribirEnPosicion), sin invalidar los demas
+// registros. Cada registro termina en un sello ",<fijos><todo>\n" de LARGO_SELLO bytes con
+// dos checksums de 16 bits: uno de la parte fija y otro de todo lo anterior al sello. Si solo
+// falla el segundo, la reescritura se interrumpio (REGISTRO_INTERRUMPIDO) y la parte fija es
+// fiable; si falla el primero, el registro esta danado. Alineados a LARGO_REGISTRO, los bytes
+// de un registro nunca quedan en dos sectores del disco.
+const std::size_t LARGO_REGISTRO = 64;
+const std::size_t LARGO_SELLO = 10;
+enum EstadoRegistro { REGISTRO_VALIDO, REGISTRO_INTERRUMPIDO, REGISTRO_DANADO };
+void formatearCabeceraFija(char* destino, std::uint64_t generacion, std::uint64_t registros, std::size_t fijos);
+void sellarRegistro(char* registro, std::size_t fijos);  // Escribe el sello al final del registro
+EstadoRegistro verificarRegistro(const char* registro, std::size_t fijos);
+bool conRegistrosFijos(std::string_view archivo);        // El archivo leido empieza con la cabecera fija
+
+// Lee el archivo en 'buffer' y verifica su linea de control (o sus registros fijos);
+// 'contenido' queda sin ella. Un registro fijo danado vuelve ARCHIVO_DANADO al archivo, y
+// tambien uno interrumpido salvo que se pase 'interrumpidos': entonces ahi queda su posicion
+// (0 es el primero tras la cabecera) para que quien lee lo repare. Como las reescrituras se
+// hacen de a una y con fsync, un corte deja como mucho un registro interrumpido: con mas, el
+// archivo esta danado. Una cabecera sin <fijos> (version anterior) da ARCHIVO_SIN_CONTROL.
+EstadoArchivo leerVerificado(const std::string& ruta, std::string& buffer, std::string_view& contenido,
+                             std::uint64_t& generacion, std::vector<std::size_t>* interrumpidos = nullptr);
+
+// Escribe 'n' bytes en 'desplazamiento' (pwrite) y hace fsync, sin truncar el archivo
+bool escribirEnPosicion(const std::string& ruta, std::uint64_t desplazamiento, const char* datos, std::size_t n);
+
+// Renombra 'origen' sobre 'destino' (atomico: se ve uno u otro, nunca un archivo a medias)
+bool reemplazarArchivo(const std::string& origen, const std::string& destino);
+
+// fsync del directorio que contiene 'ruta', para que los renombrados sobrevivan a un corte
+// de energia (sin efecto en Windows)
+bool sincronizarDirectorio(const std::string& ruta);
+
+#endif // ARCHIVOS_H
@@ -0,0 +1,45 @@
+#include "ArenaTextos.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// Tamaño de cada bloque: miles de nombres por reserva de memoria
+const std::size_t TAMANO_BLOQUE = 64 * 1024;
+
+// Bytes sin uso a partir de los cuales se considera compactar (como en ColumnaTexto)
+const std::size_t MINIMO_COMPACTAR = 64 * 1024;
+
+} // namespace
+
+std::string_view ArenaTextos::guardar(std::string_view texto) {
+    if (texto.empty()) return std::string_view();
+    reservar(texto.size());
+    char* destino = libre;
+    std::memcpy(destino, texto.data(), texto.size());
+    libre += texto.size();
+    disponibles -= texto.size();
+    usados += texto.size();
+    return std::string_view(destino, texto.size());
+}
+
+// Un texto más grande que un bloque recibe su propio bloque a la medida
+void ArenaTextos::reservar(std::size_t bytes) {
+    if (bytes <= disponibles) return;
+    std::size_t tamano = std::max(TAMANO_BLOQUE, bytes);
+    bloques.emplace_back(new char[tamano]);
+    libre = bloques.back().get();
+    disponibles = tamano;
+}
+
+void ArenaTextos::limpiar() {
+    bloques.clear();
+    libre = nullptr;
+    disponibles = 0;
+    usados = 0;
+    sinUso = 0;
+}
+
+bool ArenaTextos::convieneCompactar() const {
+    return sinUso > MINIMO_COMPACTAR && sinUso > usados / 2;
+}
@@ -0,0 +1,39 @@
+#ifndef ARENA_TEXTOS_H
+#define ARENA_TEXTOS_H
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+// Almacen monotono de textos: cada texto se copia al final del bloque actual y se
+// entrega como vista. Los bloques nunca se mueven ni se liberan uno a uno, asi que las
+// vistas siguen validas hasta limpiar() o hasta reemplazar la arena al compactar.
+// Los textos reemplazados o eliminados solo se cuentan como sin uso; el dueno decide
+// cuando copiar los vivos a una arena nueva (ver BibliotecaDB::compactarTextos).
+class ArenaTextos {
+public:
+    ArenaTextos() = default;
+    ArenaTextos(const ArenaTextos&) = delete;               // Las vistas apuntan a sus bloques
+    ArenaTextos& operator=(const ArenaTextos&) = delete;
+    ArenaTextos(ArenaTextos&&) = default;                   // Mover conserva los bloques
+    ArenaTextos& operator=(ArenaTextos&&) = default;
+
+    std::string_view guardar(std::string_view texto);      // Copia el texto a la arena
+    void liberar(std::string_view texto) { sinUso += texto.size(); } // Marca el texto como sin uso
+    void reservar(std::size_t bytes);                       // Asegura un bloque con 'bytes' libres
+    void limpiar();
+
+    std::size_t bytes() const { return usados; }            // Bytes guardados, incluido el espacio sin uso
+    std::size_t bytesSinUso() const { return sinUso; }
+    bool convieneCompactar() const;                         // El espacio sin uso supera la mitad
+
+private:
+    std::vector<std::unique_ptr<char[]>> bloques;
+    char* libre = nullptr;             // Siguiente byte libre del bloque actual
+    std::size_t disponibles = 0;       // Bytes libres en el bloque actual
+    std::size_t usados = 0;
+    std::size_t sinUso = 0;
+};
+
+#endif // ARENA_TEXTOS_H
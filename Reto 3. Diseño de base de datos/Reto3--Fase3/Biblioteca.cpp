@@ -1,39 +1,203 @@
 #include "Biblioteca.h"
+#include "LectorCSV.h"
+#include "Paralelo.h"
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <filesystem>
 #include <fstream>
 #include <sstream>
-#include <ctime>
 #include <iostream>
 #include <algorithm>
+#include <array>
 #include <limits>
-#include <regex>
 
-// --- Métodos auxiliares para la biblioteca ---
+// --- Índices por clave primaria ---
 
-// Divide una línea CSV en campos, respetando comillas para valores que contienen comas
-std::vector<std::string> BibliotecaDB::splitLine(const std::string& s, char delimiter) const {
-    std::vector<std::string> tokens;
-    std::string token;
-    bool inQuotes = false;
-    // Itera cada carácter de la línea para separar campos
-    for (char c : s) {
-        if (c == '"') {
-            inQuotes = !inQuotes; // Alterna estado de comillas
-        } else if (c == delimiter && !inQuotes) {
-            tokens.push_back(unescapeField(token)); // Procesa y añade campo completo
-            token.clear();
-        } else {
-            token += c; // Acumula caracteres en el campo actual
-        }
-    }
-    if (!token.empty()) {
-        tokens.push_back(unescapeField(token)); // Añade el último campo
+namespace {
+
+// Busca un ID en el índice y retorna puntero al elemento del vector (nullptr si no existe)
+template <typename T>
+T* buscarPorIndice(std::vector<T>& filas, const std::unordered_map<int, std::size_t>& indice, int id) {
+    auto it = indice.find(id);
+    return it != indice.end() ? &filas[it->second] : nullptr;
+}
+
+// Versión de solo lectura de buscarPorIndice
+template <typename T>
+const T* buscarPorIndice(const std::vector<T>& filas, const std::unordered_map<int, std::size_t>& indice, int id) {
+    auto it = indice.find(id);
+    return it != indice.end() ? &filas[it->second] : nullptr;
+}
+
+// Busca un ID en el índice de una tabla por columnas y retorna una copia de la fila
+template <typename Tabla>
+std::optional<typename Tabla::value_type> filaPorIndice(const Tabla& filas, const std::unordered_map<int, std::size_t>& indice,
+                                                        int id) {
+    auto it = indice.find(id);
+    if (it == indice.end()) return std::nullopt;
+    return filas[it->second];
+}
+
+// Acceso uniforme a vectores de structs y a tablas por columnas (Columnas.h):
+// ID de la fila en una posición, borrado y reemplazo de una fila
+template <typename T>
+int idEn(const std::vector<T>& filas, std::size_t i) {
+    return filas[i].id;
+}
+int idEn(const TablaLibros& filas, std::size_t i) {
+    return filas.ids()[i];
+}
+int idEn(const TablaPrestamos& filas, std::size_t i) {
+    return filas.ids()[i];
+}
+// Mayor ID de una tabla (0 si está vacía)
+template <typename Filas>
+int mayorId(const Filas& filas) {
+    int maxId = 0;
+    for (std::size_t i = 0; i < filas.size(); ++i) maxId = std::max(maxId, idEn(filas, i));
+    return maxId;
+}
+template <typename T>
+void borrarFila(std::vector<T>& filas, std::size_t pos) {
+    filas.erase(filas.begin() + static_cast<std::ptrdiff_t>(pos));
+}
+template <typename Tabla>
+void borrarFila(Tabla& filas, std::size_t pos) {
+    filas.erase(pos);
+}
+template <typename T>
+void asignarFila(std::vector<T>& filas, std::size_t pos, const T& fila) {
+    filas[pos] = fila;
+}
+template <typename Tabla, typename T>
+void asignarFila(Tabla& filas, std::size_t pos, const T& fila) {
+    filas.asignar(pos, fila);
+}
+
+// Añade una fila al vector y registra su posición; retorna false si el ID ya existe
+template <typename Filas, typename T>
+bool insertarConIndice(Filas& filas, std::unordered_map<int, std::size_t>& indice, const T& fila) {
+    if (!indice.emplace(fila.id, filas.size()).second) return false;
+    filas.push_back(fila);
+    return true;
+}
+
+// Elimina la fila con el ID dado conservando el orden del vector y corrigiendo
+// las posiciones de las filas desplazadas; retorna false si el ID no existe
+template <typename Filas>
+bool eliminarConIndice(Filas& filas, std::unordered_map<int, std::size_t>& indice, int id) {
+    auto it = indice.find(id);
+    if (it == indice.end()) return false;
+    std::size_t pos = it->second;
+    indice.erase(it);
+    borrarFila(filas, pos);
+    for (std::size_t i = pos; i < filas.size(); ++i) {
+        indice[idEn(filas, i)] = i;
     }
-    return tokens;
+    return true;
 }
 
+// Quita 'id' de la lista de referencias de 'clave' (y la lista, si queda vacía)
+void quitarReferencia(std::unordered_map<int, std::vector<int>>& referencias, int clave, int id) {
+    auto it = referencias.find(clave);
+    if (it == referencias.end()) return;
+    auto& ids = it->second;
+    ids.erase(std::remove(ids.begin(), ids.end(), id), ids.end());
+    if (ids.empty()) referencias.erase(it);
+}
+
+// Código en memoria de un campo codificado: texto a codificar o, con 'codigos', código
+// del archivo traducido con la tabla leída de su cabecera
+bool leerCodificado(std::string_view campo, Diccionario& dic, const std::vector<std::uint32_t>* codigos,
+                    std::uint32_t& codigo) {
+    if (codigos) {
+        int n;
+        if (!csv::parsearEntero(campo, n) || n < 0 || static_cast<std::size_t>(n) >= codigos->size()) return false;
+        codigo = (*codigos)[static_cast<std::size_t>(n)];
+        return true;
+    }
+    // Sin comillas ni barras escapadas el campo se busca tal cual, sin copiarlo
+    std::string espacio;
+    codigo = dic.codificar(csv::vistaCampo(campo, espacio));
+    return true;
+}
+
+// Cuenta las filas por código de diccionario y retorna (texto, cantidad) de mayor a menor
+template <typename T>
+std::vector<std::pair<std::string_view, std::size_t>> agruparPorCodigo(const std::vector<T>& filas,
+                                                                       std::uint32_t T::*campo, const Diccionario& dic) {
+    std::vector<std::size_t> conteo(dic.size());
+    for (const auto& f : filas) ++conteo[f.*campo];
+    std::vector<std::pair<std::string_view, std::size_t>> grupos;
+    for (std::uint32_t c = 0; c < conteo.size(); ++c) {
+        if (conteo[c] > 0) grupos.emplace_back(dic.texto(c), conteo[c]);
+    }
+    std::sort(grupos.begin(), grupos.end(), [](const auto& a, const auto& b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    });
+    return grupos;
+}
+
+// Copia los nombres vivos de una tabla a una arena nueva, que reemplaza a la anterior
+template <typename T>
+void compactarArena(std::vector<T>& filas, std::string_view T::*campo, ArenaTextos& arena) {
+    ArenaTextos nueva;
+    nueva.reservar(arena.bytes() - arena.bytesSinUso()); // Un solo bloque a la medida
+    for (auto& f : filas) f.*campo = nueva.guardar(f.*campo);
+    arena = std::move(nueva);
+}
+
+// Lista de referencias de 'clave', o una lista vacía si no tiene
+const std::vector<int>& referenciasDe(const std::unordered_map<int, std::vector<int>>& referencias, int clave) {
+    static const std::vector<int> ninguna;
+    auto it = referencias.find(clave);
+    return it != referencias.end() ? it->second : ninguna;
+}
+
+} // namespace
+
+// Recalcula los índices de todas las tablas (tras reemplazar los vectores completos)
+void BibliotecaDB::reconstruirIndices() {
+    auto reconstruir = [](const auto& filas, std::unordered_map<int, std::size_t>& indice) {
+        indice.clear();
+        indice.reserve(filas.size());
+        for (std::size_t i = 0; i < filas.size(); ++i) indice.emplace(idEn(filas, i), i);
+    };
+    // Cada índice lee solo su tabla: se reconstruyen a la vez
+    enParalelo(NUM_TABLAS, [&](std::size_t t) {
+        switch (t) {
+            case TABLA_ESTUDIANTES: reconstruir(estudiantes, indiceEstudiantes); break;
+            case TABLA_AUTORES: reconstruir(autores, indiceAutores); break;
+            case TABLA_EDITORIALES: reconstruir(editoriales, indiceEditoriales); break;
+            case TABLA_LIBROS: reconstruir(libros, indiceLibros); break;
+            default: reconstruir(prestamos, indicePrestamos); break;
+        }
+        return true;
+    });
+    reconstruirIndicesDerivados();
+}
+
+// Índices secundarios de préstamos y libros e índices de texto: cada grupo escribe solo sus
+// propias estructuras y las tablas ya no cambian, así que se construyen en paralelo
+void BibliotecaDB::reconstruirIndicesDerivados() {
+    maxEstudianteId = mayorId(estudiantes);
+    maxAutorId = mayorId(autores);
+    maxEditorialId = mayorId(editoriales);
+    enParalelo(3, [this](std::size_t i) {
+        if (i == 0) reconstruirIndicesPrestamos(); // Libro -> préstamo activo, estudiante -> préstamos
+        else if (i == 1) reconstruirIndicesLibros(); // ISBN -> libro y mayor ID
+        else reconstruirIndicesTexto();             // Títulos y nombres para la búsqueda de texto
+        return true;
+    });
+}
+
+// --- Métodos auxiliares para la biblioteca ---
+
 // Escapa comas y barras verticales en un campo para cumplir con el formato CSV
-std::string BibliotecaDB::escapeField(const std::string& s) const {
-    std::string result = s;
+std::string BibliotecaDB::escapeField(std::string_view s) const {
+    std::string result(s);
     // Reemplaza barras verticales por punto y coma para evitar conflictos
     std::replace(result.begin(), result.end(), '|', ';');
     // Encierra el campo en comillas si contiene comas o barras
@@ -43,68 +207,147 @@ std::string BibliotecaDB::escapeField(const std::string& s) const {
     return result;
 }
 
-// Revierte el escape de un campo CSV, eliminando comillas y restaurando barras verticales
-std::string BibliotecaDB::unescapeField(const std::string& s) const {
-    std::string result = s;
-    // Elimina comillas iniciales y finales si existen
-    if (!result.empty() && result.front() == '"' && result.back() == '"') {
-        result = result.substr(1, result.size() - 2);
-    }
-    // Restaura barras verticales reemplazando punto y coma
-    std::replace(result.begin(), result.end(), ';', '|');
-    return result;
-}
-
-// Obtiene la fecha actual en formato YYYY-MM-DD para registrar préstamos o devoluciones
+// Obtiene la fecha actual en formato YYYY-MM-DD para mostrarla en el menú
 std::string BibliotecaDB::fechaHoy() const {
-    std::time_t now = std::time(nullptr);
-    std::tm tm_now;
-#ifdef _WIN32
-    localtime_s(&tm_now, &now); // Versión segura para Windows
-#else
-    localtime_r(&now, &tm_now); // Versión segura para sistemas POSIX
-#endif
-    char buffer[11];
-    // Formatea la fecha como YYYY-MM-DD
-    std::strftime(buffer, sizeof(buffer), "%Y-%m-%d", &tm_now);
-    return std::string(buffer);
+    return Fecha::hoy().texto();
 }
 
 // Carga todos los datos desde archivos CSV al iniciar el sistema
 bool BibliotecaDB::cargarDatos() {
     // Intenta cargar todas las entidades; retorna false si alguna falla
-    return cargarEstudiantes() && cargarAutores() && cargarEditoriales() && cargarLibros() && cargarPrestamos();
+    // Después aplica los diarios pendientes sobre los snapshots
+    if (!replica) recuperarEscritura(); // Una escritura interrumpida se completa o se descarta antes de leer
+    // Cada tabla se lee en sus propios miembros, así que las cinco se cargan a la vez.
+    // Una tabla dañada sin generación anterior válida no impide cargar las demás
+    static bool (BibliotecaDB::* const cargas[NUM_TABLAS])() = {
+        &BibliotecaDB::cargarEstudiantes, &BibliotecaDB::cargarAutores, &BibliotecaDB::cargarEditoriales,
+        &BibliotecaDB::cargarLibros, &BibliotecaDB::cargarPrestamos
+    };
+    bool ok = enParalelo(NUM_TABLAS, [this](std::size_t t) { return (this->*cargas[t])(); });
+    for (std::uint64_t gen : generacionLeida) generacion = std::max(generacion, gen);
+    // Recién leídas, las tablas reflejan sus CSV; las que tienen diario quedan modificadas
+    std::copy(cambiosTabla, cambiosTabla + NUM_TABLAS, cambiosEscritos);
+    std::fill(tablaPendiente, tablaPendiente + NUM_TABLAS, false);
+    ok = reproducirDiarios() && ok;
+    // Una devolución interrumpida que no se pudo reparar en su lugar deja prestamos.txt completo
+    if (prestamosPorReescribir && !guardarTabla(TABLA_PRESTAMOS)) {
+        mensajes() << "Error: no se pudo reparar prestamos.txt; se reintentara al guardar.\n";
+    }
+    reconstruirIndicesDerivados();
+    validarReferencias();
+    return ok;
 }
 
 // Guarda todas las entidades en sus respectivos archivos CSV
 bool BibliotecaDB::guardarDatos() {
-    // Intenta guardar todas las entidades; retorna false si alguna falla
-    return guardarEstudiantes() && guardarAutores() && guardarEditoriales() && guardarLibros() && guardarPrestamos();
+    // Las cinco tablas se reemplazan juntas: si alguna falla, ningún archivo cambia.
+    // Cada snapshot escrito vacía el diario de su tabla (checkpoint)
+    bool todas[NUM_TABLAS];
+    std::fill(todas, todas + NUM_TABLAS, true);
+    return escribirTablas(todas);
+}
+
+// Reemplaza solo las tablas cuyo CSV no refleja la memoria, todas o ninguna. Con el diario
+// activo son las que tienen registros, así que solo se compactan esos diarios
+bool BibliotecaDB::guardarCambios() {
+    bool tablas[NUM_TABLAS];
+    for (int t = 0; t < NUM_TABLAS; ++t) tablas[t] = tablaModificada(static_cast<Tabla>(t));
+    return escribirTablas(tablas);
+}
+
+// --- Valores codificados (grado y nacionalidad) ---
+
+std::uint32_t BibliotecaDB::codificarGrado(std::string_view grado) {
+    return grados.codificar(grado);
+}
+
+std::string_view BibliotecaDB::textoGrado(std::uint32_t codigo) const {
+    return grados.texto(codigo);
+}
+
+std::uint32_t BibliotecaDB::codificarNacionalidad(std::string_view nacionalidad) {
+    return nacionalidades.codificar(nacionalidad);
+}
+
+std::string_view BibliotecaDB::textoNacionalidad(std::uint32_t codigo) const {
+    return nacionalidades.texto(codigo);
+}
+
+// Estudiantes por grado: cuenta códigos enteros en lugar de comparar textos
+std::vector<std::pair<std::string_view, std::size_t>> BibliotecaDB::estudiantesPorGrado() const {
+    return agruparPorCodigo(estudiantes, &Estudiante::grado, grados);
+}
+
+std::vector<std::pair<std::string_view, std::size_t>> BibliotecaDB::autoresPorNacionalidad() const {
+    return agruparPorCodigo(autores, &Autor::nacionalidad, nacionalidades);
+}
+
+void BibliotecaDB::listarEstudiantesPorGrado() const {
+    std::cout << "\n---- Estudiantes por grado ----\n";
+    auto grupos = estudiantesPorGrado();
+    for (const auto& g : grupos) std::cout << g.first << ": " << g.second << "\n";
+    if (grupos.empty()) std::cout << "No hay estudiantes registrados.\n";
+}
+
+void BibliotecaDB::listarAutoresPorNacionalidad() const {
+    std::cout << "\n---- Autores por nacionalidad ----\n";
+    auto grupos = autoresPorNacionalidad();
+    for (const auto& g : grupos) std::cout << g.first << ": " << g.second << "\n";
+    if (grupos.empty()) std::cout << "No hay autores registrados.\n";
+}
+
+// --- Memoria de textos ---
+
+// Reemplaza cada arena por una con solo los nombres vivos y compacta los títulos
+void BibliotecaDB::compactarTextos() {
+    compactarArena(estudiantes, &Estudiante::nombre, textosEstudiantes);
+    compactarArena(autores, &Autor::nombre, textosAutores);
+    compactarArena(editoriales, &Editorial::nombre, textosEditoriales);
+    libros.compactarTitulos();
+}
+
+// Solo copia las arenas con más de la mitad de su espacio sin uso (los títulos se compactan solos)
+void BibliotecaDB::compactarTextosSiConviene() {
+    if (textosEstudiantes.convieneCompactar()) compactarArena(estudiantes, &Estudiante::nombre, textosEstudiantes);
+    if (textosAutores.convieneCompactar()) compactarArena(autores, &Autor::nombre, textosAutores);
+    if (textosEditoriales.convieneCompactar()) compactarArena(editoriales, &Editorial::nombre, textosEditoriales);
+}
+
+std::size_t BibliotecaDB::bytesTextos() const {
+    return textosEstudiantes.bytes() + textosAutores.bytes() + textosEditoriales.bytes() + libros.titulos().bytes();
 }
 
 // --- Gestión de Estudiantes ---
 
 // Genera el siguiente ID único para un nuevo estudiante
 int BibliotecaDB::nextEstudianteId() const {
-    int maxId = 0;
-    // Busca el mayor ID existente en la lista de estudiantes
-    for (const auto& e : estudiantes) {
-        maxId = std::max(maxId, e.id);
-    }
-    return maxId + 1; // Retorna el siguiente ID disponible
+    // El mayor ID se mantiene al agregar y eliminar, sin recorrer la lista
+    return maxEstudianteId + 1;
 }
 
 // Agrega un estudiante nuevo, asegurando que el ID sea único
 bool BibliotecaDB::agregarEstudiante(const Estudiante& e) {
-    // Verifica si el ID ya está en uso
-    for (const auto& est : estudiantes) {
-        if (est.id == e.id) {
-            std::cout << "Error: ID de estudiante " << e.id << " ya existe.\n";
-            return false;
-        }
+    recordarFila(TABLA_ESTUDIANTES, e.id);
+    // Inserta en el vector y en el índice con el nombre copiado a la arena; falla si el ID ya está en uso
+    Estudiante nuevo = e;
+    nuevo.nombre = textosEstudiantes.guardar(e.nombre);
+    if (!insertarConIndice(estudiantes, indiceEstudiantes, nuevo)) {
+        textosEstudiantes.liberar(nuevo.nombre);
+        mensajes() << "Error: ID de estudiante " << e.id << " ya existe.\n";
+        return false;
+    }
+    maxEstudianteId = std::max(maxEstudianteId, nuevo.id);
+    prefijosEstudiantes.agregar(nuevo.id, nuevo.nombre);
+    return persistir(TABLA_ESTUDIANTES, 'A', filaEstudiante(nuevo)); // Persiste los cambios
+}
+
+// Valida el ID antes de codificar: un alta rechazada no deja su grado en el diccionario
+bool BibliotecaDB::agregarEstudiante(int id, std::string_view nombre, std::string_view grado) {
+    if (buscarEstudiantePorId(id)) {
+        mensajes() << "Error: ID de estudiante " << id << " ya existe.\n";
+        return false;
     }
-    estudiantes.push_back(e); // Añade el estudiante al vector
-    return guardarEstudiantes(); // Persiste los cambios en el archivo
+    return agregarEstudiante(Estudiante{id, nombre, codificarGrado(grado)});
 }
 
 // Muestra la lista completa de estudiantes registrados
@@ -116,92 +359,109 @@ void BibliotecaDB::listarEstudiantes() const {
     }
     // Itera e imprime cada estudiante con su ID, nombre y grado
     for (const auto& e : estudiantes) {
-        std::cout << "ID: " << e.id << " | Nombre: " << e.nombre << " | Grado: " << e.grado << "\n";
+        std::cout << "ID: " << e.id << " | Nombre: " << e.nombre << " | Grado: " << textoGrado(e.grado) << "\n";
     }
 }
 
 // Busca un estudiante por ID, retorna puntero constante para acceso de solo lectura
 const Estudiante* BibliotecaDB::buscarEstudiantePorId(int id) const {
-    // Itera la lista de estudiantes para encontrar el ID solicitado
-    for (const auto& e : estudiantes) {
-        if (e.id == id) return &e;
-    }
-    return nullptr; // Retorna nullptr si no se encuentra
+    // Consulta el índice por ID en tiempo constante
+    return buscarPorIndice(estudiantes, indiceEstudiantes, id);
 }
 
 // Busca un estudiante por ID, retorna puntero modificable para edición
-Estudiante* BibliotecaDB::buscarEstudiantePorId(int id) {
-    // Itera la lista de estudiantes para encontrar el ID solicitado
-    for (auto& e : estudiantes) {
-        if (e.id == id) return &e;
-    }
-    return nullptr; // Retorna nullptr si no se encuentra
+Estudiante* BibliotecaDB::estudianteEditable(int id) {
+    // Consulta el índice por ID en tiempo constante
+    return buscarPorIndice(estudiantes, indiceEstudiantes, id);
 }
 
 // Actualiza los datos de un estudiante existente (nombre o grado)
 bool BibliotecaDB::actualizarEstudiante(int id) {
-    Estudiante* e = buscarEstudiantePorId(id);
+    Estudiante* e = estudianteEditable(id);
     if (!e) {
         std::cout << "Error: Estudiante ID " << id << " no encontrado.\n";
         return false;
     }
+    recordarFila(TABLA_ESTUDIANTES, id);
     std::cout << "Actualizar Estudiante ID " << id << " (Enter para mantener valor):\n";
     std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
     std::cout << "Nombre actual: " << e->nombre << "\nNuevo nombre: ";
     std::string s;
     std::getline(std::cin, s);
-    // Actualiza el nombre solo si se ingresa un valor nuevo
-    if (!s.empty()) e->nombre = s;
-    std::cout << "Grado actual: " << e->grado << "\nNuevo grado: ";
+    // Actualiza el nombre solo si se ingresa un valor nuevo (y su entrada de autocompletado)
+    if (!s.empty()) {
+        prefijosEstudiantes.eliminar(e->id, e->nombre);
+        textosEstudiantes.liberar(e->nombre);
+        e->nombre = textosEstudiantes.guardar(s);
+        prefijosEstudiantes.agregar(e->id, e->nombre);
+        compactarTextosSiConviene();
+    }
+    std::cout << "Grado actual: " << textoGrado(e->grado) << "\nNuevo grado: ";
     std::getline(std::cin, s);
     // Actualiza el grado solo si se ingresa un valor nuevo
-    if (!s.empty()) e->grado = s;
-    return guardarEstudiantes(); // Persiste los cambios
+    if (!s.empty()) e->grado = codificarGrado(s);
+    return persistir(TABLA_ESTUDIANTES, 'A', filaEstudiante(*e)); // Persiste los cambios
 }
 
 // Elimina un estudiante, verificando que no tenga préstamos activos
 bool BibliotecaDB::eliminarEstudiante(int id) {
-    // Verifica si el estudiante tiene préstamos pendientes
-    for (const auto& p : prestamos) {
-        if (p.id_estudiante == id && p.fecha_devolucion.empty()) {
-            std::cout << "Error: Estudiante tiene prestamo activo (ID Prestamo " << p.id << ").\n";
-            return false;
+    // Verifica si el estudiante tiene préstamos pendientes (solo recorre los suyos)
+    auto suyos = prestamosPorEstudiante.find(id);
+    if (suyos != prestamosPorEstudiante.end()) {
+        for (int idp : suyos->second) {
+            if (prestamosActivos.count(idp)) {
+                mensajes() << "Error: Estudiante tiene prestamo activo (ID Prestamo " << idp << ").\n";
+                return false;
+            }
         }
     }
-    // Elimina el estudiante de la lista usando remove_if
-    auto it = std::remove_if(estudiantes.begin(), estudiantes.end(),
-                             [id](const Estudiante& e) { return e.id == id; });
-    if (it == estudiantes.end()) {
-        std::cout << "Error: Estudiante ID " << id << " no encontrado.\n";
+    // Elimina el estudiante del vector y actualiza los índices
+    recordarFila(TABLA_ESTUDIANTES, id);
+    const Estudiante* e = buscarEstudiantePorId(id);
+    if (e) {
+        prefijosEstudiantes.eliminar(id, e->nombre);
+        textosEstudiantes.liberar(e->nombre);
+    }
+    if (!eliminarConIndice(estudiantes, indiceEstudiantes, id)) {
+        mensajes() << "Error: Estudiante ID " << id << " no encontrado.\n";
         return false;
     }
-    estudiantes.erase(it, estudiantes.end()); // Borra los elementos eliminados
-    return guardarEstudiantes(); // Persiste los cambios
+    if (id == maxEstudianteId) maxEstudianteId = mayorId(estudiantes); // Solo si se eliminó el mayor ID
+    compactarTextosSiConviene();
+    return persistir(TABLA_ESTUDIANTES, 'B', std::to_string(id)); // Persiste los cambios
 }
 
 // --- Gestión de Autores ---
 
 // Genera el siguiente ID único para un nuevo autor
 int BibliotecaDB::nextAutorId() const {
-    int maxId = 0;
-    // Busca el mayor ID existente en la lista de autores
-    for (const auto& a : autores) {
-        maxId = std::max(maxId, a.id);
-    }
-    return maxId + 1; // Retorna el siguiente ID disponible
+    // El mayor ID se mantiene al agregar y eliminar, sin recorrer la lista
+    return maxAutorId + 1;
 }
 
 // Agrega un autor nuevo, asegurando que el ID sea único
 bool BibliotecaDB::agregarAutor(const Autor& a) {
-    // Verifica si el ID ya está en uso
-    for (const auto& aut : autores) {
-        if (aut.id == a.id) {
-            std::cout << "Error: ID de autor " << a.id << " ya existe.\n";
-            return false;
-        }
+    recordarFila(TABLA_AUTORES, a.id);
+    // Inserta en el vector y en el índice con el nombre copiado a la arena; falla si el ID ya está en uso
+    Autor nuevo = a;
+    nuevo.nombre = textosAutores.guardar(a.nombre);
+    if (!insertarConIndice(autores, indiceAutores, nuevo)) {
+        textosAutores.liberar(nuevo.nombre);
+        mensajes() << "Error: ID de autor " << a.id << " ya existe.\n";
+        return false;
     }
-    autores.push_back(a); // Añade el autor al vector
-    return guardarAutores(); // Persiste los cambios en el archivo
+    maxAutorId = std::max(maxAutorId, nuevo.id);
+    textoAutores.agregar(nuevo.id, nuevo.nombre);
+    return persistir(TABLA_AUTORES, 'A', filaAutor(nuevo)); // Persiste los cambios
+}
+
+// Valida el ID antes de codificar: un alta rechazada no deja su nacionalidad en el diccionario
+bool BibliotecaDB::agregarAutor(int id, std::string_view nombre, std::string_view nacionalidad) {
+    if (buscarAutorPorId(id)) {
+        mensajes() << "Error: ID de autor " << id << " ya existe.\n";
+        return false;
+    }
+    return agregarAutor(Autor{id, nombre, codificarNacionalidad(nacionalidad)});
 }
 
 // Muestra la lista completa de autores registrados
@@ -213,92 +473,97 @@ void BibliotecaDB::listarAutores() const {
     }
     // Itera e imprime cada autor con su ID, nombre y nacionalidad
     for (const auto& a : autores) {
-        std::cout << "ID: " << a.id << " | Nombre: " << a.nombre << " | Nacionalidad: " << a.nacionalidad << "\n";
+        std::cout << "ID: " << a.id << " | Nombre: " << a.nombre << " | Nacionalidad: " << textoNacionalidad(a.nacionalidad)
+                  << "\n";
     }
 }
 
 // Busca un autor por ID, retorna puntero constante para acceso de solo lectura
 const Autor* BibliotecaDB::buscarAutorPorId(int id) const {
-    // Itera la lista de autores para encontrar el ID solicitado
-    for (const auto& a : autores) {
-        if (a.id == id) return &a;
-    }
-    return nullptr; // Retorna nullptr si no se encuentra
+    // Consulta el índice por ID en tiempo constante
+    return buscarPorIndice(autores, indiceAutores, id);
 }
 
 // Busca un autor por ID, retorna puntero modificable para edición
-Autor* BibliotecaDB::buscarAutorPorId(int id) {
-    // Itera la lista de autores para encontrar el ID solicitado
-    for (auto& a : autores) {
-        if (a.id == id) return &a;
-    }
-    return nullptr; // Retorna nullptr si no se encuentra
+Autor* BibliotecaDB::autorEditable(int id) {
+    // Consulta el índice por ID en tiempo constante
+    return buscarPorIndice(autores, indiceAutores, id);
 }
 
 // Actualiza los datos de un autor existente (nombre o nacionalidad)
 bool BibliotecaDB::actualizarAutor(int id) {
-    Autor* a = buscarAutorPorId(id);
+    Autor* a = autorEditable(id);
     if (!a) {
         std::cout << "Error: Autor ID " << id << " no encontrado.\n";
         return false;
     }
+    recordarFila(TABLA_AUTORES, id);
     std::cout << "Actualizar Autor ID " << id << " (Enter para mantener valor):\n";
     std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
     std::cout << "Nombre actual: " << a->nombre << "\nNuevo nombre: ";
     std::string s;
     std::getline(std::cin, s);
-    // Actualiza el nombre solo si se ingresa un valor nuevo
-    if (!s.empty()) a->nombre = s;
-    std::cout << "Nacionalidad actual: " << a->nacionalidad << "\nNueva nacionalidad: ";
+    // Actualiza el nombre solo si se ingresa un valor nuevo (y su entrada en el índice de texto)
+    if (!s.empty()) {
+        textoAutores.eliminar(a->id, a->nombre);
+        textosAutores.liberar(a->nombre);
+        a->nombre = textosAutores.guardar(s);
+        textoAutores.agregar(a->id, a->nombre);
+        compactarTextosSiConviene();
+    }
+    std::cout << "Nacionalidad actual: " << textoNacionalidad(a->nacionalidad) << "\nNueva nacionalidad: ";
     std::getline(std::cin, s);
     // Actualiza la nacionalidad solo si se ingresa un valor nuevo
-    if (!s.empty()) a->nacionalidad = s;
-    return guardarAutores(); // Persiste los cambios
+    if (!s.empty()) a->nacionalidad = codificarNacionalidad(s);
+    return persistir(TABLA_AUTORES, 'A', filaAutor(*a)); // Persiste los cambios
 }
 
 // Elimina un autor, verificando que no esté asociado a ningún libro
 bool BibliotecaDB::eliminarAutor(int id) {
-    // Verifica si el autor está referenciado por algún libro
-    for (const auto& l : libros) {
-        if (l.id_autor == id) {
-            std::cout << "Error: Autor referenciado por libro ID " << l.id << ".\n";
-            return false;
-        }
+    // Verifica si el autor está referenciado por algún libro (índice inverso)
+    const std::vector<int>& suyos = librosDeAutor(id);
+    if (!suyos.empty()) {
+        mensajes() << "Error: Autor referenciado por libro ID " << suyos.front() << ".\n";
+        return false;
     }
-    // Elimina el autor de la lista usando remove_if
-    auto it = std::remove_if(autores.begin(), autores.end(),
-                             [id](const Autor& a) { return a.id == id; });
-    if (it == autores.end()) {
-        std::cout << "Error: Autor ID " << id << " no encontrado.\n";
+    // Elimina el autor del vector y actualiza los índices
+    recordarFila(TABLA_AUTORES, id);
+    const Autor* a = buscarAutorPorId(id);
+    if (a) {
+        textoAutores.eliminar(id, a->nombre);
+        textosAutores.liberar(a->nombre);
+    }
+    if (!eliminarConIndice(autores, indiceAutores, id)) {
+        mensajes() << "Error: Autor ID " << id << " no encontrado.\n";
         return false;
     }
-    autores.erase(it, autores.end()); // Borra los elementos eliminados
-    return guardarAutores(); // Persiste los cambios
+    if (id == maxAutorId) maxAutorId = mayorId(autores); // Solo si se eliminó el mayor ID
+    compactarTextosSiConviene();
+    return persistir(TABLA_AUTORES, 'B', std::to_string(id)); // Persiste los cambios
 }
 
 // --- Gestión de Editoriales ---
 
 // Genera el siguiente ID único para una nueva editorial
 int BibliotecaDB::nextEditorialId() const {
-    int maxId = 0;
-    // Busca el mayor ID existente en la lista de editoriales
-    for (const auto& ed : editoriales) {
-        maxId = std::max(maxId, ed.id);
-    }
-    return maxId + 1; // Retorna el siguiente ID disponible
+    // El mayor ID se mantiene al agregar y eliminar, sin recorrer la lista
+    return maxEditorialId + 1;
 }
 
 // Agrega una editorial nueva, asegurando que el ID sea único
 bool BibliotecaDB::agregarEditorial(const Editorial& ed) {
-    // Verifica si el ID ya está en uso
-    for (const auto& e : editoriales) {
-        if (e.id == ed.id) {
-            std::cout << "Error: ID de editorial " << ed.id << " ya existe.\n";
-            return false;
-        }
+    recordarFila(TABLA_EDITORIALES, ed.id);
+    // Inserta en el vector y en el índice con el nombre copiado a la arena; falla si el ID ya está en uso
+    Editorial nuevo = ed;
+    nuevo.nombre = textosEditoriales.guardar(ed.nombre);
+    if (!insertarConIndice(editoriales, indiceEditoriales, nuevo)) {
+        textosEditoriales.liberar(nuevo.nombre);
+        mensajes() << "Error: ID de editorial " << ed.id << " ya existe.\n";
+        return false;
     }
-    editoriales.push_back(ed); // Añade la editorial al vector
-    return guardarEditoriales(); // Persiste los cambios en el archivo
+    maxEditorialId = std::max(maxEditorialId, nuevo.id);
+    textoEditoriales.agregar(nuevo.id, nuevo.nombre);
+    return persistir(TABLA_EDITORIALES, 'A', filaEditorial(nuevo)); // Persiste los cambios
 }
 
 // Muestra la lista completa de editoriales registradas
@@ -316,102 +581,113 @@ void BibliotecaDB::listarEditoriales() const {
 
 // Busca una editorial por ID, retorna puntero constante para acceso de solo lectura
 const Editorial* BibliotecaDB::buscarEditorialPorId(int id) const {
-    // Itera la lista de editoriales para encontrar el ID solicitado
-    for (const auto& ed : editoriales) {
-        if (ed.id == id) return &ed;
-    }
-    return nullptr; // Retorna nullptr si no se encuentra
+    // Consulta el índice por ID en tiempo constante
+    return buscarPorIndice(editoriales, indiceEditoriales, id);
 }
 
 // Busca una editorial por ID, retorna puntero modificable para edición
-Editorial* BibliotecaDB::buscarEditorialPorId(int id) {
-    // Itera la lista de editoriales para encontrar el ID solicitado
-    for (auto& ed : editoriales) {
-        if (ed.id == id) return &ed;
-    }
-    return nullptr; // Retorna nullptr si no se encuentra
+Editorial* BibliotecaDB::editorialEditable(int id) {
+    // Consulta el índice por ID en tiempo constante
+    return buscarPorIndice(editoriales, indiceEditoriales, id);
 }
 
 // Actualiza el nombre de una editorial existente
 bool BibliotecaDB::actualizarEditorial(int id) {
-    Editorial* ed = buscarEditorialPorId(id);
+    Editorial* ed = editorialEditable(id);
     if (!ed) {
         std::cout << "Error: Editorial ID " << id << " no encontrada.\n";
         return false;
     }
+    recordarFila(TABLA_EDITORIALES, id);
     std::cout << "Actualizar Editorial ID " << id << " (Enter para mantener valor):\n";
     std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
     std::cout << "Nombre actual: " << ed->nombre << "\nNuevo nombre: ";
     std::string s;
     std::getline(std::cin, s);
-    // Actualiza el nombre solo si se ingresa un valor nuevo
-    if (!s.empty()) ed->nombre = s;
-    return guardarEditoriales(); // Persiste los cambios
+    // Actualiza el nombre solo si se ingresa un valor nuevo (y su entrada en el índice de texto)
+    if (!s.empty()) {
+        textoEditoriales.eliminar(ed->id, ed->nombre);
+        textosEditoriales.liberar(ed->nombre);
+        ed->nombre = textosEditoriales.guardar(s);
+        textoEditoriales.agregar(ed->id, ed->nombre);
+        compactarTextosSiConviene();
+    }
+    return persistir(TABLA_EDITORIALES, 'A', filaEditorial(*ed)); // Persiste los cambios
 }
 
 // Elimina una editorial, verificando que no esté asociada a ningún libro
 bool BibliotecaDB::eliminarEditorial(int id) {
-    // Verifica si la editorial está referenciada por algún libro
-    for (const auto& l : libros) {
-        if (l.id_editorial == id) {
-            std::cout << "Error: Editorial referenciada por libro ID " << l.id << ".\n";
-            return false;
-        }
+    // Verifica si la editorial está referenciada por algún libro (índice inverso)
+    const std::vector<int>& suyos = librosDeEditorial(id);
+    if (!suyos.empty()) {
+        mensajes() << "Error: Editorial referenciada por libro ID " << suyos.front() << ".\n";
+        return false;
     }
-    // Elimina la editorial de la lista usando remove_if
-    auto it = std::remove_if(editoriales.begin(), editoriales.end(),
-                             [id](const Editorial& ed) { return ed.id == id; });
-    if (it == editoriales.end()) {
-        std::cout << "Error: Editorial ID " << id << " no encontrada.\n";
+    // Elimina la editorial del vector y actualiza los índices
+    recordarFila(TABLA_EDITORIALES, id);
+    const Editorial* ed = buscarEditorialPorId(id);
+    if (ed) {
+        textoEditoriales.eliminar(id, ed->nombre);
+        textosEditoriales.liberar(ed->nombre);
+    }
+    if (!eliminarConIndice(editoriales, indiceEditoriales, id)) {
+        mensajes() << "Error: Editorial ID " << id << " no encontrada.\n";
         return false;
     }
-    editoriales.erase(it, editoriales.end()); // Borra los elementos eliminados
-    return guardarEditoriales(); // Persiste los cambios
+    if (id == maxEditorialId) maxEditorialId = mayorId(editoriales); // Solo si se eliminó el mayor ID
+    compactarTextosSiConviene();
+    return persistir(TABLA_EDITORIALES, 'B', std::to_string(id)); // Persiste los cambios
 }
 
 // --- Gestión de Libros ---
 
 // Genera el siguiente ID único para un nuevo libro
 int BibliotecaDB::nextLibroId() const {
-    int maxId = 0;
-    // Busca el mayor ID existente en la lista de libros
-    for (const auto& l : libros) {
-        maxId = std::max(maxId, l.id);
-    }
-    return maxId + 1; // Retorna el siguiente ID disponible
+    // El mayor ID se mantiene al agregar y eliminar, sin recorrer la lista
+    return maxLibroId + 1;
 }
 
 // Agrega un libro nuevo, validando ID, ISBN, autor y editorial
 bool BibliotecaDB::agregarLibro(const Libro& l) {
     // Verifica unicidad del ID del libro
-    for (const auto& lib : libros) {
-        if (lib.id == l.id) {
-            std::cout << "Error: ID de libro " << l.id << " ya existe.\n";
-            return false;
-        }
-        // Verifica unicidad del ISBN
-        if (lib.isbn == l.isbn) {
-            std::cout << "Error: ISBN " << l.isbn << " ya existe (Libro ID " << lib.id << ").\n";
-            return false;
-        }
+    if (indiceLibros.count(l.id)) {
+        mensajes() << "Error: ID de libro " << l.id << " ya existe.\n";
+        return false;
+    }
+    // Verifica unicidad del ISBN en el índice
+    if (l.isbn.vacio()) {
+        mensajes() << "Error: ISBN invalido.\n";
+        return false;
+    }
+    auto repetido = indiceIsbn.find(l.isbn.valor);
+    if (repetido != indiceIsbn.end()) {
+        mensajes() << "Error: ISBN " << l.isbn << " ya existe (Libro ID " << repetido->second << ").\n";
+        return false;
     }
     // Valida que el año esté en un rango razonable
     if (l.anio < 0 || l.anio > 2025) {
-        std::cout << "Error: Ano invalido (debe ser entre 0 y 2025).\n";
+        mensajes() << "Error: Ano invalido (debe ser entre 0 y 2025).\n";
         return false;
     }
     // Valida la existencia del autor
     if (!buscarAutorPorId(l.id_autor)) {
-        std::cout << "Error: Autor ID " << l.id_autor << " no existe.\n";
+        mensajes() << "Error: Autor ID " << l.id_autor << " no existe.\n";
         return false;
     }
     // Valida la existencia de la editorial
     if (!buscarEditorialPorId(l.id_editorial)) {
-        std::cout << "Error: Editorial ID " << l.id_editorial << " no existe.\n";
+        mensajes() << "Error: Editorial ID " << l.id_editorial << " no existe.\n";
         return false;
     }
-    libros.push_back(l); // Añade el libro al vector
-    return guardarLibros(); // Persiste los cambios
+    recordarFila(TABLA_LIBROS, l.id);
+    insertarConIndice(libros, indiceLibros, l); // Añade el libro al vector y al índice
+    indiceIsbn.emplace(l.isbn.valor, l.id);
+    maxLibroId = std::max(maxLibroId, l.id);
+    librosPorAutor[l.id_autor].push_back(l.id);
+    librosPorEditorial[l.id_editorial].push_back(l.id);
+    textoLibros.agregar(l.id, l.titulo);
+    prefijosLibros.agregar(l.id, l.titulo);
+    return persistir(TABLA_LIBROS, 'A', filaLibro(l)); // Persiste los cambios
 }
 
 // Muestra la lista completa de libros con detalles de autor y editorial
@@ -421,37 +697,125 @@ void BibliotecaDB::listarLibros() const {
         std::cout << "No hay libros registrados.\n";
         return;
     }
-    // Itera cada libro, recuperando autor y editorial asociados
-    for (const auto& l : libros) {
-        const Autor* a = buscarAutorPorId(l.id_autor);
-        const Editorial* ed = buscarEditorialPorId(l.id_editorial);
-        std::cout << "ID: " << l.id << " | Titulo: " << l.titulo << " | ISBN: " << l.isbn
-                  << " | Ano: " << l.anio << " | Autor: " << (a ? a->nombre : "Desconocido")
+    // Itera cada libro por posición leyendo sus columnas, recuperando autor y editorial asociados
+    for (std::size_t i = 0; i < libros.size(); ++i) {
+        const Autor* a = buscarAutorPorId(libros.idsAutor()[i]);
+        const Editorial* ed = buscarEditorialPorId(libros.idsEditorial()[i]);
+        std::cout << "ID: " << libros.ids()[i] << " | Titulo: " << libros.titulos()[i] << " | ISBN: " << libros.isbns()[i]
+                  << " | Ano: " << libros.anios()[i] << " | Autor: " << (a ? a->nombre : "Desconocido")
                   << " | Editorial: " << (ed ? ed->nombre : "Desconocida") << "\n";
     }
 }
 
-// Busca un libro por ID, retorna puntero constante para acceso de solo lectura
-const Libro* BibliotecaDB::buscarLibroPorId(int id) const {
-    // Itera la lista de libros para encontrar el ID solicitado
-    for (const auto& l : libros) {
-        if (l.id == id) return &l;
+// Busca un libro por ID; retorna una copia de la fila reconstruida desde sus columnas
+std::optional<Libro> BibliotecaDB::buscarLibroPorId(int id) const {
+    // Consulta el índice por ID en tiempo constante
+    return filaPorIndice(libros, indiceLibros, id);
+}
+
+// Título de un libro leído directamente de su columna (para listados que solo lo muestran)
+std::string_view BibliotecaDB::tituloLibro(int id) const {
+    auto it = indiceLibros.find(id);
+    return it != indiceLibros.end() ? libros.titulos()[it->second] : std::string_view("Desconocido");
+}
+
+// Busca un libro por ISBN (con o sin guiones, ISBN-10 o ISBN-13) en el índice de ISBN
+std::optional<Libro> BibliotecaDB::buscarLibroPorIsbn(std::string_view isbn) const {
+    Isbn clave;
+    if (!Isbn::parsear(isbn, clave)) return std::nullopt;
+    auto it = indiceIsbn.find(clave.valor);
+    return it != indiceIsbn.end() ? buscarLibroPorId(it->second) : std::nullopt;
+}
+
+// Reconstruye el índice ISBN -> ID (ante ISBN repetidos en los datos conserva el primero),
+// los índices inversos autor/editorial -> libros y el mayor ID
+void BibliotecaDB::reconstruirIndicesLibros() {
+    indiceIsbn.clear();
+    indiceIsbn.reserve(libros.size());
+    librosPorAutor.clear();
+    librosPorEditorial.clear();
+    maxLibroId = 0;
+    // Solo se leen las columnas de ID, ISBN, autor y editorial (no los títulos)
+    const std::vector<int>& ids = libros.ids();
+    const std::vector<Isbn>& isbns = libros.isbns();
+    for (std::size_t i = 0; i < ids.size(); ++i) {
+        if (!isbns[i].vacio()) indiceIsbn.emplace(isbns[i].valor, ids[i]);
+        librosPorAutor[libros.idsAutor()[i]].push_back(ids[i]);
+        librosPorEditorial[libros.idsEditorial()[i]].push_back(ids[i]);
+        maxLibroId = std::max(maxLibroId, ids[i]);
     }
-    return nullptr; // Retorna nullptr si no se encuentra
 }
 
-// Busca un libro por ID, retorna puntero modificable para edición
-Libro* BibliotecaDB::buscarLibroPorId(int id) {
-    // Itera la lista de libros para encontrar el ID solicitado
-    for (auto& l : libros) {
-        if (l.id == id) return &l;
+// IDs de los libros de un autor (vacío si no tiene) usando el índice inverso
+const std::vector<int>& BibliotecaDB::librosDeAutor(int id_autor) const {
+    return referenciasDe(librosPorAutor, id_autor);
+}
+
+// IDs de los libros de una editorial (vacío si no tiene) usando el índice inverso
+const std::vector<int>& BibliotecaDB::librosDeEditorial(int id_editorial) const {
+    return referenciasDe(librosPorEditorial, id_editorial);
+}
+
+// Muestra los libros de un autor o editorial a partir de la lista de IDs del índice inverso
+void BibliotecaDB::listarLibrosDe(const std::vector<int>& ids) const {
+    if (ids.empty()) {
+        std::cout << "  (Ningun libro registrado)\n";
+        return;
     }
-    return nullptr; // Retorna nullptr si no se encuentra
+    for (int id : ids) {
+        auto it = indiceLibros.find(id);
+        if (it == indiceLibros.end()) continue;
+        std::size_t i = it->second;
+        std::cout << "  ID: " << id << " | Titulo: " << libros.titulos()[i] << " | ISBN: " << libros.isbns()[i]
+                  << " | Ano: " << libros.anios()[i] << "\n";
+    }
+}
+
+void BibliotecaDB::listarLibrosPorAutor(int id_autor) const {
+    const Autor* a = buscarAutorPorId(id_autor);
+    std::cout << "\n---- Libros del Autor ID " << id_autor << " (" << (a ? a->nombre : "Desconocido") << ") ----\n";
+    listarLibrosDe(librosDeAutor(id_autor));
+}
+
+void BibliotecaDB::listarLibrosPorEditorial(int id_editorial) const {
+    const Editorial* ed = buscarEditorialPorId(id_editorial);
+    std::cout << "\n---- Libros de la Editorial ID " << id_editorial << " (" << (ed ? ed->nombre : "Desconocida")
+              << ") ----\n";
+    listarLibrosDe(librosDeEditorial(id_editorial));
+}
+
+// Cantidad de libros por año de publicación; recorre solo la columna de años
+std::vector<std::pair<int, std::size_t>> BibliotecaDB::librosPorAnio() const {
+    std::unordered_map<int, std::size_t> conteo;
+    for (int anio : libros.anios()) ++conteo[anio];
+    std::vector<std::pair<int, std::size_t>> resultado(conteo.begin(), conteo.end());
+    std::sort(resultado.begin(), resultado.end());
+    return resultado;
+}
+
+// IDs de los libros publicados entre dos años (inclusive), en el orden de la tabla
+std::vector<int> BibliotecaDB::librosEntreAnios(int desde, int hasta) const {
+    std::vector<int> ids;
+    const std::vector<int>& anios = libros.anios();
+    for (std::size_t i = 0; i < anios.size(); ++i) {
+        if (anios[i] >= desde && anios[i] <= hasta) ids.push_back(libros.ids()[i]);
+    }
+    return ids;
+}
+
+// Muestra cuántos libros hay de cada año de publicación
+void BibliotecaDB::listarLibrosPorAnio() const {
+    std::cout << "\n---- Libros por ano ----\n";
+    auto conteo = librosPorAnio();
+    for (const auto& c : conteo) std::cout << "Ano " << c.first << ": " << c.second << "\n";
+    if (conteo.empty()) std::cout << "No hay libros registrados.\n";
 }
 
 // Actualiza los datos de un libro existente (título, ISBN, año, autor, editorial)
 bool BibliotecaDB::actualizarLibro(int id) {
-    Libro* l = buscarLibroPorId(id);
+    // Se leen y validan todos los campos sobre una copia de la fila; solo después se tocan
+    // los índices y las columnas, así que un ISBN rechazado no deja cambios a medias
+    std::optional<Libro> l = buscarLibroPorId(id);
     if (!l) {
         std::cout << "Error: Libro ID " << id << " no encontrado.\n";
         return false;
@@ -460,163 +824,251 @@ bool BibliotecaDB::actualizarLibro(int id) {
     std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
     std::string s;
 
-    // Actualiza el título si se ingresa un valor nuevo
+    // Título nuevo, si se ingresa
     std::cout << "Titulo actual: " << l->titulo << "\nNuevo titulo: ";
-    std::getline(std::cin, s);
-    if (!s.empty()) l->titulo = s;
+    std::string titulo;
+    std::getline(std::cin, titulo);
 
-    // Actualiza el ISBN, verificando unicidad
+    // ISBN nuevo, verificando formato, dígito de control y unicidad
     std::cout << "ISBN actual: " << l->isbn << "\nNuevo ISBN: ";
     std::getline(std::cin, s);
+    Isbn isbn = l->isbn;
     if (!s.empty()) {
-        for (const auto& other : libros) {
-            if (other.id != l->id && other.isbn == s) {
-                std::cout << "Error: ISBN " << s << " ya usado por otro libro.\n";
-                return false;
-            }
+        if (!Isbn::parsear(s, isbn) || !isbn.controlValido()) {
+            std::cout << "Error: ISBN " << s << " invalido (10 o 13 digitos con digito de control correcto).\n";
+            return false;
+        }
+        auto otro = indiceIsbn.find(isbn.valor);
+        if (otro != indiceIsbn.end() && otro->second != l->id) {
+            std::cout << "Error: ISBN " << s << " ya usado por otro libro.\n";
+            return false;
         }
-        l->isbn = s;
     }
 
-    // Actualiza el año, validando el rango
+    // Año nuevo, validando el rango
     std::cout << "Ano actual: " << l->anio << "\nNuevo ano (Enter para mantener): ";
     std::getline(std::cin, s);
+    int anio = l->anio;
     if (!s.empty()) {
         try {
             int nuevoAno = std::stoi(s);
             if (nuevoAno < 0 || nuevoAno > 2025) {
                 std::cout << "Error: Ano invalido, se mantiene el anterior.\n";
             } else {
-                l->anio = nuevoAno;
+                anio = nuevoAno;
             }
         } catch (...) {
             std::cout << "Error: Ano invalido, se mantiene el anterior.\n";
         }
     }
 
-    // Actualiza el ID del autor, validando su existencia
+    // ID del autor nuevo, validando su existencia
     std::cout << "ID Autor actual: " << l->id_autor << "\nNuevo ID Autor (Enter para mantener): ";
     std::getline(std::cin, s);
+    int id_autor = l->id_autor;
     if (!s.empty()) {
         try {
             int idaut = std::stoi(s);
             if (!buscarAutorPorId(idaut)) {
                 std::cout << "Error: Autor ID " << idaut << " no existe, se mantiene el anterior.\n";
             } else {
-                l->id_autor = idaut;
+                id_autor = idaut;
             }
         } catch (...) {
             std::cout << "Error: ID Autor invalido, se mantiene el anterior.\n";
         }
     }
 
-    // Actualiza el ID de la editorial, validando su existencia
+    // ID de la editorial nueva, validando su existencia
     std::cout << "ID Editorial actual: " << l->id_editorial << "\nNuevo ID Editorial (Enter para mantener): ";
     std::getline(std::cin, s);
+    int id_editorial = l->id_editorial;
     if (!s.empty()) {
         try {
             int ided = std::stoi(s);
             if (!buscarEditorialPorId(ided)) {
                 std::cout << "Error: Editorial ID " << ided << " no existe, se mantiene la anterior.\n";
             } else {
-                l->id_editorial = ided;
+                id_editorial = ided;
             }
         } catch (...) {
             std::cout << "Error: ID Editorial invalido, se mantiene la anterior.\n";
         }
     }
 
-    return guardarLibros(); // Persiste los cambios
+    // Todo validado: se actualizan los índices y la fila, y se persiste una sola vez
+    recordarFila(TABLA_LIBROS, id);
+    std::size_t pos = indiceLibros.at(id);
+    if (!titulo.empty()) {
+        textoLibros.eliminar(l->id, l->titulo);
+        prefijosLibros.eliminar(l->id, l->titulo);
+        l->titulo = titulo;
+        textoLibros.agregar(l->id, l->titulo);
+        prefijosLibros.agregar(l->id, l->titulo);
+    }
+    if (isbn.valor != l->isbn.valor) {
+        // Mueve la entrada del índice solo si apuntaba a este libro
+        auto actual = indiceIsbn.find(l->isbn.valor);
+        if (actual != indiceIsbn.end() && actual->second == l->id) indiceIsbn.erase(actual);
+        indiceIsbn[isbn.valor] = l->id;
+    }
+    l->isbn = isbn;
+    l->anio = anio;
+    if (id_autor != l->id_autor) {
+        quitarReferencia(librosPorAutor, l->id_autor, l->id);
+        librosPorAutor[id_autor].push_back(l->id);
+        l->id_autor = id_autor;
+    }
+    if (id_editorial != l->id_editorial) {
+        quitarReferencia(librosPorEditorial, l->id_editorial, l->id);
+        librosPorEditorial[id_editorial].push_back(l->id);
+        l->id_editorial = id_editorial;
+    }
+    libros.asignar(pos, *l);
+    return persistir(TABLA_LIBROS, 'A', filaLibro(*l)); // Persiste los cambios
 }
 
 // Elimina un libro, verificando que no tenga préstamos activos
 bool BibliotecaDB::eliminarLibro(int id) {
     // Verifica si el libro está en un préstamo activo
-    for (const auto& p : prestamos) {
-        if (p.id_libro == id && p.fecha_devolucion.empty()) {
-            std::cout << "Error: Libro tiene prestamo activo (ID Prestamo " << p.id << ").\n";
-            return false;
-        }
+    if (int idp = prestamoActivoDeLibro(id)) {
+        mensajes() << "Error: Libro tiene prestamo activo (ID Prestamo " << idp << ").\n";
+        return false;
     }
-    // Elimina el libro de la lista usando remove_if
-    auto it = std::remove_if(libros.begin(), libros.end(),
-                             [id](const Libro& l) { return l.id == id; });
-    if (it == libros.end()) {
-        std::cout << "Error: Libro ID " << id << " no encontrado.\n";
+    // Elimina el libro de la tabla y actualiza los índices
+    recordarFila(TABLA_LIBROS, id);
+    std::optional<Libro> l = buscarLibroPorId(id);
+    if (l) {
+        auto isbn = indiceIsbn.find(l->isbn.valor);
+        if (isbn != indiceIsbn.end() && isbn->second == id) indiceIsbn.erase(isbn);
+        quitarReferencia(librosPorAutor, l->id_autor, id);
+        quitarReferencia(librosPorEditorial, l->id_editorial, id);
+        textoLibros.eliminar(id, l->titulo);
+        prefijosLibros.eliminar(id, l->titulo);
+    }
+    if (!eliminarConIndice(libros, indiceLibros, id)) {
+        mensajes() << "Error: Libro ID " << id << " no encontrado.\n";
         return false;
     }
-    libros.erase(it, libros.end()); // Borra los elementos eliminados
-    return guardarLibros(); // Persiste los cambios
+    // Solo si se eliminó el mayor ID hay que buscar el nuevo máximo
+    if (id == maxLibroId) {
+        maxLibroId = 0;
+        for (int otro : libros.ids()) maxLibroId = std::max(maxLibroId, otro);
+    }
+    return persistir(TABLA_LIBROS, 'B', std::to_string(id)); // Persiste los cambios
 }
 
 // --- Gestión de Préstamos ---
 
 // Genera el siguiente ID único para un nuevo préstamo
 int BibliotecaDB::nextPrestamoId() const {
-    int maxId = 0;
-    // Busca el mayor ID existente en la lista de préstamos
-    for (const auto& p : prestamos) {
-        maxId = std::max(maxId, p.id);
+    // Los préstamos no se eliminan, así que basta con el mayor ID registrado
+    return maxPrestamoId + 1;
+}
+
+// Retorna el ID del préstamo activo de un libro, o 0 si está disponible
+int BibliotecaDB::prestamoActivoDeLibro(int id_libro) const {
+    auto it = prestamoActivoPorLibro.find(id_libro);
+    return it != prestamoActivoPorLibro.end() ? it->second : 0;
+}
+
+// Registra un préstamo en los índices secundarios (libro, estudiante y activos)
+void BibliotecaDB::indexarPrestamo(const Prestamo& p) {
+    maxPrestamoId = std::max(maxPrestamoId, p.id);
+    prestamosPorEstudiante[p.id_estudiante].push_back(p.id);
+    if (p.fecha_devolucion.vacia()) {
+        prestamosActivos.insert(p.id);
+        prestamoActivoPorLibro[p.id_libro] = p.id;
     }
-    return maxId + 1; // Retorna el siguiente ID disponible
+}
+
+// Reconstruye los índices secundarios de préstamos a partir del vector
+void BibliotecaDB::reconstruirIndicesPrestamos() {
+    maxPrestamoId = 0;
+    prestamosPorEstudiante.clear();
+    prestamosActivos.clear();
+    prestamoActivoPorLibro.clear();
+    for (std::size_t i = 0; i < prestamos.size(); ++i) indexarPrestamo(prestamos[i]);
 }
 
 // Registra un nuevo préstamo, validando libro, estudiante y disponibilidad
-bool BibliotecaDB::prestarLibro(int id_libro, int id_estudiante, const std::string& fecha_prestamo) {
-    // Valida el formato de la fecha (YYYY-MM-DD)
-    std::regex dateRegex("\\d{4}-\\d{2}-\\d{2}");
-    if (!std::regex_match(fecha_prestamo, dateRegex)) {
-        std::cout << "Error: Formato de fecha invalido (use YYYY-MM-DD).\n";
+bool BibliotecaDB::prestarLibro(int id_libro, int id_estudiante, Fecha fecha_prestamo) {
+    // Valida la existencia del estudiante
+    if (!buscarEstudiantePorId(id_estudiante)) {
+        mensajes() << "Error: Estudiante ID " << id_estudiante << " no existe.\n";
         return false;
     }
 
-    // Valida la existencia del libro
-    Libro* l = buscarLibroPorId(id_libro);
-    if (!l) {
-        std::cout << "Error: Libro ID " << id_libro << " no existe.\n";
+    // Crea y registra el nuevo préstamo
+    Prestamo p;
+    p.id = nextPrestamoId();
+    p.id_libro = id_libro;
+    p.id_estudiante = id_estudiante;
+    p.fecha_prestamo = fecha_prestamo;
+    p.fecha_devolucion = Fecha(); // Vacía: préstamo activo
+    return agregarPrestamo(p);
+}
+
+// Registra un préstamo con su ID y fechas ya asignados. Valida el libro y su disponibilidad
+// pero no al estudiante: lo hace quien llama (prestarLibro, o BibliotecaFragmentada cuando
+// el estudiante vive en otro fragmento)
+bool BibliotecaDB::agregarPrestamo(const Prestamo& p) {
+    // La fecha de préstamo es obligatoria y la devolución no puede ser anterior
+    if (p.fecha_prestamo.vacia() || (!p.fecha_devolucion.vacia() && p.fecha_devolucion < p.fecha_prestamo)) {
+        mensajes() << "Error: Fecha de prestamo invalida.\n";
         return false;
     }
 
-    // Valida la existencia del estudiante
-    Estudiante* e = buscarEstudiantePorId(id_estudiante);
-    if (!e) {
-        std::cout << "Error: Estudiante ID " << id_estudiante << " no existe.\n";
+    // Valida la existencia del libro
+    if (!indiceLibros.count(p.id_libro)) {
+        mensajes() << "Error: Libro ID " << p.id_libro << " no existe.\n";
         return false;
     }
 
     // Verifica si el libro ya está prestado
-    for (const auto& p : prestamos) {
-        if (p.id_libro == id_libro && p.fecha_devolucion.empty()) {
-            std::cout << "Error: Libro ya esta prestado (ID Prestamo " << p.id << ").\n";
+    if (p.fecha_devolucion.vacia()) {
+        if (int activo = prestamoActivoDeLibro(p.id_libro)) {
+            mensajes() << "Error: Libro ya esta prestado (ID Prestamo " << activo << ").\n";
             return false;
         }
     }
 
-    // Crea y registra el nuevo préstamo
-    Prestamo p;
-    p.id = nextPrestamoId();
-    p.id_libro = id_libro;
-    p.id_estudiante = id_estudiante;
-    p.fecha_prestamo = fecha_prestamo;
-    p.fecha_devolucion = "";
-    prestamos.push_back(p);
-    return guardarPrestamos(); // Persiste los cambios
+    recordarFila(TABLA_PRESTAMOS, p.id);
+    if (!insertarConIndice(prestamos, indicePrestamos, p)) {
+        mensajes() << "Error: ID de prestamo " << p.id << " ya existe.\n";
+        return false;
+    }
+    indexarPrestamo(p);
+    return persistir(TABLA_PRESTAMOS, 'A', filaPrestamo(p)); // Persiste los cambios
 }
 
-// Registra la devolución de un préstamo, actualizando la fecha de devolución
-bool BibliotecaDB::devolverPrestamo(int id_prestamo) {
-    Prestamo* p = buscarPrestamoPorId(id_prestamo);
+// Registra la devolución de un préstamo con la fecha indicada (hoy por omisión)
+bool BibliotecaDB::devolverPrestamo(int id_prestamo, Fecha fecha_devolucion) {
+    std::optional<Prestamo> p = buscarPrestamoPorId(id_prestamo);
     if (!p) {
-        std::cout << "Error: Prestamo ID " << id_prestamo << " no existe.\n";
+        mensajes() << "Error: Prestamo ID " << id_prestamo << " no existe.\n";
         return false;
     }
     // Verifica si el préstamo ya fue devuelto
-    if (!p->fecha_devolucion.empty()) {
-        std::cout << "Error: Prestamo ya devuelto el " << p->fecha_devolucion << ".\n";
+    if (!p->fecha_devolucion.vacia()) {
+        mensajes() << "Error: Prestamo ya devuelto el " << p->fecha_devolucion << ".\n";
+        return false;
+    }
+    if (fecha_devolucion.vacia() || fecha_devolucion < p->fecha_prestamo) {
+        mensajes() << "Error: Fecha de devolucion anterior al prestamo (" << p->fecha_prestamo << ").\n";
         return false;
     }
-    p->fecha_devolucion = fechaHoy(); // Asigna la fecha actual
-    return guardarPrestamos(); // Persiste los cambios
+    // Solo cambia la columna de fecha de devolución
+    recordarFila(TABLA_PRESTAMOS, id_prestamo);
+    p->fecha_devolucion = fecha_devolucion;
+    std::size_t pos = indicePrestamos.at(id_prestamo);
+    prestamos.asignarDevolucion(pos, fecha_devolucion);
+    // El libro queda disponible
+    prestamosActivos.erase(p->id);
+    auto activo = prestamoActivoPorLibro.find(p->id_libro);
+    if (activo != prestamoActivoPorLibro.end() && activo->second == p->id) prestamoActivoPorLibro.erase(activo);
+    if (devolverEnLugar(pos)) return true; // Solo se reescribió su registro
+    return persistir(TABLA_PRESTAMOS, 'A', filaPrestamo(*p)); // Persiste los cambios
 }
 
 // Muestra todos los préstamos o solo los activos, con detalles de libro y estudiante
@@ -626,16 +1078,22 @@ void BibliotecaDB::listarPrestamos(bool soloActivos) const {
         std::cout << "No hay prestamos registrados.\n";
         return;
     }
+    // Con soloActivos recorre únicamente los préstamos activos, en el orden del vector
+    std::vector<std::size_t> posiciones;
+    if (soloActivos) {
+        posiciones.reserve(prestamosActivos.size());
+        for (int idp : prestamosActivos) posiciones.push_back(indicePrestamos.at(idp));
+        std::sort(posiciones.begin(), posiciones.end());
+    }
+    std::size_t total = soloActivos ? posiciones.size() : prestamos.size();
     int activos = 0;
-    // Itera cada préstamo, mostrando solo los activos si se especifica
-    for (const auto& p : prestamos) {
-        if (soloActivos && !p.fecha_devolucion.empty()) continue;
-        const Libro* l = buscarLibroPorId(p.id_libro);
+    for (std::size_t i = 0; i < total; ++i) {
+        const Prestamo p = prestamos[soloActivos ? posiciones[i] : i];
         const Estudiante* e = buscarEstudiantePorId(p.id_estudiante);
-        std::cout << "ID Prestamo: " << p.id << " | Libro ID: " << p.id_libro << " (" << (l ? l->titulo : "Desconocido") << ")"
+        std::cout << "ID Prestamo: " << p.id << " | Libro ID: " << p.id_libro << " (" << tituloLibro(p.id_libro) << ")"
                   << " | Estudiante ID: " << p.id_estudiante << " (" << (e ? e->nombre : "Desconocido") << ")"
                   << " | Fecha Prestamo: " << p.fecha_prestamo
-                  << " | Fecha Devolucion: " << (p.fecha_devolucion.empty() ? "(Pendiente)" : p.fecha_devolucion)
+                  << " | Fecha Devolucion: " << (p.fecha_devolucion.vacia() ? "(Pendiente)" : p.fecha_devolucion.texto())
                   << "\n";
         if (soloActivos) activos++;
     }
@@ -648,245 +1106,1225 @@ void BibliotecaDB::listarPrestamos(bool soloActivos) const {
 void BibliotecaDB::listarPrestamosPorEstudiante(int id_estudiante) const {
     std::cout << "\n---- Prestamos para Estudiante ID " << id_estudiante << " ----\n";
     const Estudiante* e = buscarEstudiantePorId(id_estudiante);
-    std::string nombre = e ? e->nombre : "Desconocido";
+    std::string_view nombre = e ? e->nombre : "Desconocido";
     std::cout << "Estudiante: " << nombre << "\n";
     bool found = false;
-    // Itera los préstamos filtrando por ID de estudiante
-    for (const auto& p : prestamos) {
-        if (p.id_estudiante == id_estudiante) {
+    // Recorre solo los préstamos del estudiante mediante el índice secundario
+    auto suyos = prestamosPorEstudiante.find(id_estudiante);
+    if (suyos != prestamosPorEstudiante.end()) {
+        for (int idp : suyos->second) {
+            std::optional<Prestamo> p = buscarPrestamoPorId(idp);
+            if (!p) continue;
             found = true;
-            const Libro* l = buscarLibroPorId(p.id_libro);
-            std::cout << "  ID Prestamo: " << p.id << " | Libro: " << (l ? l->titulo : "Desconocido")
-                      << " | Fecha Prestamo: " << p.fecha_prestamo
-                      << " | Fecha Devolucion: " << (p.fecha_devolucion.empty() ? "(Pendiente)" : p.fecha_devolucion)
+            std::cout << "  ID Prestamo: " << p->id << " | Libro: " << tituloLibro(p->id_libro)
+                      << " | Fecha Prestamo: " << p->fecha_prestamo
+                      << " | Fecha Devolucion: " << (p->fecha_devolucion.vacia() ? "(Pendiente)" : p->fecha_devolucion.texto())
                       << "\n";
         }
     }
     if (!found) std::cout << "  (Ningun prestamo registrado)\n";
 }
 
-// Busca un préstamo por ID, retorna puntero constante para acceso de solo lectura
-const Prestamo* BibliotecaDB::buscarPrestamoPorId(int id) const {
-    // Itera la lista de préstamos para encontrar el ID solicitado
-    for (const auto& p : prestamos) {
-        if (p.id == id) return &p;
+// Retorna los IDs de préstamos de un estudiante (vacío si no tiene) usando el índice secundario
+const std::vector<int>& BibliotecaDB::prestamosDeEstudiante(int id_estudiante) const {
+    static const std::vector<int> ninguno;
+    auto suyos = prestamosPorEstudiante.find(id_estudiante);
+    return suyos != prestamosPorEstudiante.end() ? suyos->second : ninguno;
+}
+
+// Retorna los préstamos cuya fecha de préstamo cae en [desde, hasta], en el orden de la tabla
+std::vector<Prestamo> BibliotecaDB::prestamosEntre(Fecha desde, Fecha hasta) const {
+    std::vector<Prestamo> resultado;
+    // El filtro recorre solo la columna de fechas de préstamo (enteros contiguos)
+    const std::vector<Fecha>& fechas = prestamos.fechasPrestamo();
+    for (std::size_t i = 0; i < fechas.size(); ++i) {
+        if (fechas[i] >= desde && fechas[i] <= hasta) resultado.push_back(prestamos[i]);
     }
-    return nullptr; // Retorna nullptr si no se encuentra
+    return resultado;
 }
 
-// Busca un préstamo por ID, retorna puntero modificable para edición
-Prestamo* BibliotecaDB::buscarPrestamoPorId(int id) {
-    // Itera la lista de préstamos para encontrar el ID solicitado
-    for (auto& p : prestamos) {
-        if (p.id == id) return &p;
+// Muestra los préstamos realizados dentro de un rango de fechas
+void BibliotecaDB::listarPrestamosEntre(Fecha desde, Fecha hasta) const {
+    std::cout << "\n---- Prestamos entre " << desde << " y " << hasta << " ----\n";
+    auto encontrados = prestamosEntre(desde, hasta);
+    for (const Prestamo& p : encontrados) {
+        const Estudiante* e = buscarEstudiantePorId(p.id_estudiante);
+        std::cout << "ID Prestamo: " << p.id << " | Libro: " << tituloLibro(p.id_libro)
+                  << " | Estudiante: " << (e ? e->nombre : "Desconocido")
+                  << " | Fecha Prestamo: " << p.fecha_prestamo
+                  << " | Fecha Devolucion: " << (p.fecha_devolucion.vacia() ? "(Pendiente)" : p.fecha_devolucion.texto())
+                  << "\n";
     }
-    return nullptr; // Retorna nullptr si no se encuentra
+    if (encontrados.empty()) std::cout << "No hay prestamos en ese rango.\n";
+}
+
+// Busca un préstamo por ID; retorna una copia de la fila reconstruida desde sus columnas
+std::optional<Prestamo> BibliotecaDB::buscarPrestamoPorId(int id) const {
+    // Consulta el índice por ID en tiempo constante
+    return filaPorIndice(prestamos, indicePrestamos, id);
+}
+
+// --- Búsqueda de texto ---
+
+// Reconstruye los índices de texto y de autocompletado desde los vectores (tras cargar o reproducir diarios)
+void BibliotecaDB::reconstruirIndicesTexto() {
+    textoLibros.limpiar();
+    textoAutores.limpiar();
+    textoEditoriales.limpiar();
+    textoLibros.reservar(libros.size());
+    textoAutores.reservar(autores.size());
+    textoEditoriales.reservar(editoriales.size());
+    // Los cinco índices son independientes y solo leen las tablas
+    enParalelo(4, [this](std::size_t i) {
+        std::vector<std::pair<int, std::string_view>> documentos;
+        switch (i) {
+            case 0:
+                for (std::size_t j = 0; j < libros.size(); ++j) textoLibros.agregar(libros.ids()[j], libros.titulos()[j]);
+                break;
+            case 1:
+                for (const auto& a : autores) textoAutores.agregar(a.id, a.nombre);
+                for (const auto& ed : editoriales) textoEditoriales.agregar(ed.id, ed.nombre);
+                break;
+            case 2:
+                documentos.reserve(estudiantes.size());
+                for (const auto& e : estudiantes) documentos.emplace_back(e.id, e.nombre);
+                prefijosEstudiantes.construir(documentos);
+                break;
+            default:
+                documentos.reserve(libros.size());
+                for (std::size_t j = 0; j < libros.size(); ++j) documentos.emplace_back(libros.ids()[j], libros.titulos()[j]);
+                prefijosLibros.construir(documentos);
+                break;
+        }
+        return true;
+    });
+}
+
+// Busca los términos de la consulta en títulos y nombres; cada lista queda ordenada por relevancia
+ResultadosTexto BibliotecaDB::buscarTexto(std::string_view consulta, std::size_t k) const {
+    std::vector<std::string> terminos;
+    IndiceTexto::tokenizar(consulta, terminos);
+    ResultadosTexto r;
+    r.libros = textoLibros.buscar(terminos, k);
+    r.autores = textoAutores.buscar(terminos, k);
+    r.editoriales = textoEditoriales.buscar(terminos, k);
+    return r;
+}
+
+// Muestra los resultados de una búsqueda de texto con los datos de cada entidad
+void BibliotecaDB::mostrarBusquedaTexto(std::string_view consulta, std::size_t k) const {
+    ResultadosTexto r = buscarTexto(consulta, k);
+    std::cout << "\n---- Resultados para \"" << consulta << "\" ----\n";
+    for (const Acierto& a : r.libros) {
+        std::optional<Libro> l = buscarLibroPorId(a.id);
+        if (!l) continue;
+        const Autor* au = buscarAutorPorId(l->id_autor);
+        std::cout << "Libro ID: " << l->id << " | Titulo: " << l->titulo
+                  << " | Autor: " << (au ? au->nombre : "Desconocido") << "\n";
+    }
+    for (const Acierto& a : r.autores) {
+        const Autor* au = buscarAutorPorId(a.id);
+        if (au) {
+            std::cout << "Autor ID: " << au->id << " | Nombre: " << au->nombre
+                      << " | Libros: " << librosDeAutor(au->id).size() << "\n";
+        }
+    }
+    for (const Acierto& a : r.editoriales) {
+        const Editorial* ed = buscarEditorialPorId(a.id);
+        if (ed) {
+            std::cout << "Editorial ID: " << ed->id << " | Nombre: " << ed->nombre
+                      << " | Libros: " << librosDeEditorial(ed->id).size() << "\n";
+        }
+    }
+    if (r.libros.empty() && r.autores.empty() && r.editoriales.empty()) std::cout << "Sin resultados.\n";
+}
+
+// IDs de los estudiantes cuyo nombre empieza por el prefijo, en orden alfabético
+std::vector<int> BibliotecaDB::completarEstudiantes(std::string_view prefijo, std::size_t k, std::size_t saltar) const {
+    return prefijosEstudiantes.completar(prefijo, k, saltar);
+}
+
+// IDs de los libros cuyo título empieza por el prefijo, en orden alfabético
+std::vector<int> BibliotecaDB::completarLibros(std::string_view prefijo, std::size_t k, std::size_t saltar) const {
+    return prefijosLibros.completar(prefijo, k, saltar);
 }
 
 // --- Persistencia (guardar/cargar) ---
 
-// Guarda la lista de estudiantes en estudiantes.txt en formato CSV
-bool BibliotecaDB::guardarEstudiantes() const {
-    std::ofstream file("estudiantes.txt");
-    if (!file.is_open()) {
-        std::cout << "Error al abrir estudiantes.txt para guardar.\n";
-        return false;
+namespace {
+
+// Archivos CSV y diarios de cada tabla, en el orden del enum Tabla
+const char* const ARCHIVOS_TABLA[NUM_TABLAS] = {
+    "estudiantes.txt", "autores.txt", "editoriales.txt", "libros.txt", "prestamos.txt"
+};
+const char* const ARCHIVOS_DIARIO[NUM_TABLAS] = {
+    "estudiantes.log", "autores.log", "editoriales.log", "libros.log", "prestamos.log"
+};
+
+// Sufijo de las copias temporales de una escritura y registro que la confirma (ver escribirTablas)
+const char* const SUFIJO_TEMPORAL = ".tmp";
+const char* const ARCHIVO_CONFIRMACION = "escritura.commit";
+
+// Generación previa de cada CSV (la que reemplazó la última escritura) y copia apartada
+// de un CSV cuyo checksum no coincide (ver leerTabla)
+const char* const SUFIJO_ANTERIOR = ".anterior";
+const char* const SUFIJO_DANADO = ".danado";
+
+// Cabecera del diccionario en estudiantes.txt y autores.txt: "#diccionario,<n>" seguida de
+// n líneas con un valor cada una; las filas guardan en su tercera columna el número de línea
+const std::string_view CABECERA_DICCIONARIO = "#diccionario,";
+
+// Las filas se formatean en un bloque de este tamaño antes de pasar a ArchivoSalida, que
+// lo escribe con una sola llamada; el bloque se reutiliza sin volver a reservar memoria
+const std::size_t BYTES_BLOQUE = 1 << 20;
+
+// Registros de ancho fijo de prestamos.txt (ver Archivos.h): id, id_libro, id_estudiante y
+// las dos fechas ocupan ANCHO_CAMPO columnas cada uno, separados por comas, y después va el
+// sello. La fecha de devolución empieza en DESPLAZAMIENTO_DEVOLUCION dentro del registro
+const std::size_t ANCHO_CAMPO = Fecha::LARGO_TEXTO;
+const std::size_t DESPLAZAMIENTO_DEVOLUCION = 4 * (ANCHO_CAMPO + 1);
+static_assert(5 * (ANCHO_CAMPO + 1) - 1 == LARGO_REGISTRO - LARGO_SELLO, "los campos deben llenar el registro");
+
+// Los enteros se alinean a la derecha en su campo: "-999999999" es el menor que cabe
+bool cabeEnRegistro(int v) {
+    return v >= -999999999;
+}
+
+// Un registro interrumpido (ver Archivos.h) tiene su parte fija verificada, pero no su fecha
+// de devolución: esa devolución nunca se confirmó, así que el préstamo sigue activo, como si
+// no hubiera empezado. La fecha queda en blanco y el registro se vuelve a sellar.
+void sanearRegistro(char* registro) {
+    std::memset(registro + DESPLAZAMIENTO_DEVOLUCION, ' ', ANCHO_CAMPO);
+    sellarRegistro(registro, DESPLAZAMIENTO_DEVOLUCION);
+}
+
+// Escribe el bloque si ya se llenó (o siempre, con 'final') y lo deja vacío; un error
+// de escritura queda registrado en ArchivoSalida y lo reporta cerrar()
+void vaciarBloque(ArchivoSalida& salida, std::string& bloque, bool final = false) {
+    if (!final && bloque.size() < BYTES_BLOQUE) return;
+    salida.escribir(bloque.data(), bloque.size());
+    bloque.clear();
+}
+
+// Escribe la cabecera con todos los valores del diccionario (el código es la posición)
+void escribirDiccionario(std::string& bloque, const Diccionario& dic) {
+    bloque.append(CABECERA_DICCIONARIO.data(), CABECERA_DICCIONARIO.size());
+    csv::anexarEntero(bloque, dic.size());
+    bloque += '\n';
+    for (std::uint32_t c = 0; c < dic.size(); ++c) {
+        csv::anexarCampo(bloque, dic.texto(c));
+        bloque += '\n';
     }
-    // Escribe cada estudiante como una línea CSV: id,nombre,grado
-    for (const auto& e : estudiantes) {
-        file << e.id << "," << escapeField(e.nombre) << "," << escapeField(e.grado) << "\n";
+}
+
+// Lee la cabecera del diccionario si el archivo la tiene y traduce cada código del archivo
+// al del diccionario en memoria; los archivos sin cabecera traen el texto en cada fila
+bool leerDiccionario(std::string_view& resto, Diccionario& dic, std::vector<std::uint32_t>& codigos) {
+    if (resto.compare(0, CABECERA_DICCIONARIO.size(), CABECERA_DICCIONARIO) != 0) return false;
+    std::string_view linea;
+    csv::siguienteLinea(resto, linea);
+    int n = 0;
+    if (!csv::parsearEntero(linea.substr(CABECERA_DICCIONARIO.size()), n)) n = 0;
+    std::string texto;
+    for (int i = 0; i < n && csv::siguienteLinea(resto, linea); ++i) {
+        csv::asignarCampo(linea, texto);
+        codigos.push_back(dic.codificar(texto));
     }
-    file.close();
     return true;
 }
 
-// Carga los estudiantes desde estudiantes.txt al vector en memoria
-bool BibliotecaDB::cargarEstudiantes() {
-    estudiantes.clear(); // Limpia el vector antes de cargar
-    std::ifstream file("estudiantes.txt");
-    if (!file.is_open()) return true; // No es error si el archivo no existe
-    std::string line;
-    // Lee cada línea y procesa los campos
-    while (std::getline(file, line)) {
-        auto tokens = splitLine(line, ',');
-        if (tokens.size() >= 3) {
+// Conserva el CSV vigente como <archivo>.anterior antes de reemplazarlo; un enlace duro
+// evita copiar el archivo (la copia queda para sistemas de archivos sin enlaces)
+void conservarAnterior(const std::string& destino) {
+    std::error_code ec;
+    if (!std::filesystem::exists(destino, ec)) return;
+    std::string anterior = destino + SUFIJO_ANTERIOR;
+    std::filesystem::remove(anterior, ec);
+    std::filesystem::create_hard_link(destino, anterior, ec);
+    if (ec) std::filesystem::copy_file(destino, anterior, ec);
+}
+
+// Inserta la fila o reemplaza la existente con el mismo ID
+template <typename Filas, typename T>
+void reemplazarConIndice(Filas& filas, std::unordered_map<int, std::size_t>& indice, const T& fila) {
+    auto it = indice.find(fila.id);
+    if (it != indice.end()) {
+        asignarFila(filas, it->second, fila);
+    } else {
+        insertarConIndice(filas, indice, fila);
+    }
+}
+
+// Aplica los registros de un diario sobre una tabla ya cargada desde su CSV
+template <typename Filas, typename Parser>
+void reproducir(const std::vector<RegistroDiario>& registros, const char* archivo,
+                Filas& filas, std::unordered_map<int, std::size_t>& indice, Parser parsear) {
+    for (const auto& r : registros) {
+        if (r.operacion == 'A') {
+            typename Filas::value_type fila;
+            if (parsear(r.fila, fila)) {
+                reemplazarConIndice(filas, indice, fila);
+                continue;
+            }
+        } else if (r.operacion == 'B') {
             try {
-                Estudiante e;
-                e.id = std::stoi(tokens[0]);
-                e.nombre = tokens[1];
-                e.grado = tokens[2];
-                estudiantes.push_back(e);
+                eliminarConIndice(filas, indice, std::stoi(r.fila));
+                continue;
             } catch (...) {
-                std::cout << "Error al procesar linea en estudiantes.txt: " << line << "\n";
             }
         }
+        std::cout << "Registro invalido ignorado en " << archivo << ": " << r.fila << "\n";
     }
-    file.close();
+}
+
+// Parte de un CSV interpretada por un hilo. Los mensajes de error se emiten al fundir los
+// trozos, en el orden del archivo, así que se conserva cada línea
+template <typename Fila>
+struct Trozo {
+    std::vector<std::string_view> lineas;     // Líneas no vacías
+    std::vector<Fila> filas;                  // Una por línea
+    std::vector<char> validas;                // La línea se pudo interpretar
+    std::deque<std::string> escapados;        // Textos con comillas o barras (las vistas apuntan aquí)
+};
+
+// Los archivos de menos de un trozo se interpretan en el hilo que los carga
+const std::size_t BYTES_POR_TROZO = 1 << 20;
+
+// Divide el contenido en trozos terminados en fin de línea y los interpreta en paralelo;
+// parsear(linea, fila, escapados) no debe modificar la base
+template <typename Fila, typename Parser>
+std::vector<Trozo<Fila>> interpretarEnTrozos(std::string_view contenido, Parser parsear) {
+    std::vector<std::string_view> partes = csv::dividirEnTrozos(contenido, BYTES_POR_TROZO);
+    std::vector<Trozo<Fila>> trozos(partes.size());
+    enParalelo(partes.size(), [&](std::size_t i) {
+        Trozo<Fila>& trozo = trozos[i];
+        std::string_view resto = partes[i], linea;
+        std::size_t n = csv::contarLineas(resto);
+        trozo.lineas.reserve(n);
+        trozo.filas.reserve(n);
+        trozo.validas.reserve(n);
+        while (csv::siguienteLinea(resto, linea)) {
+            if (linea.empty()) continue;
+            trozo.lineas.push_back(linea);
+            trozo.filas.emplace_back();
+            trozo.validas.push_back(parsear(linea, trozo.filas.back(), trozo.escapados));
+        }
+        return true;
+    });
+    return trozos;
+}
+
+} // namespace
+
+// Define el directorio donde se leen y escriben los archivos de datos
+void BibliotecaDB::setDirectorio(const std::string& dir) {
+    directorio = dir;
+    if (!directorio.empty() && directorio.back() != '/' && directorio.back() != '\\') directorio += '/';
+    // Los archivos del nuevo directorio no tienen por qué coincidir con la memoria
+    for (auto& cambios : cambiosTabla) ++cambios;
+}
+
+// Construye la ruta de un archivo de datos dentro del directorio configurado
+std::string BibliotecaDB::ruta(const char* archivo) const {
+    return directorio + archivo;
+}
+
+// Los mensajes de una réplica repetirían los de la base principal
+std::ostream& BibliotecaDB::mensajes() const {
+    thread_local std::ostream nula(nullptr);
+    return replica ? nula : std::cout;
+}
+
+// Activa el modo diario: abre un diario por tabla en modo anexado
+bool BibliotecaDB::activarDiario(std::size_t loteSync, std::size_t umbral) {
+    for (int t = 0; t < NUM_TABLAS; ++t) {
+        if (!diarios[t].abrir(ruta(ARCHIVOS_DIARIO[t]))) {
+            mensajes() << "Error al abrir " << ARCHIVOS_DIARIO[t] << ".\n";
+            desactivarDiario();
+            return false;
+        }
+        diarios[t].setLoteSync(loteSync);
+    }
+    umbralCompactacion = umbral == 0 ? 1 : umbral;
+    modoDiario = true;
     return true;
 }
 
-// Guarda la lista de autores en autores.txt en formato CSV
-bool BibliotecaDB::guardarAutores() const {
-    std::ofstream file("autores.txt");
-    if (!file.is_open()) {
-        std::cout << "Error al abrir autores.txt para guardar.\n";
+// Desactiva el modo diario; los registros pendientes se sincronizan al cerrar
+void BibliotecaDB::desactivarDiario() {
+    for (auto& d : diarios) d.cerrar();
+    modoDiario = false;
+}
+
+// Fuerza fsync de todos los diarios abiertos
+bool BibliotecaDB::sincronizarDiario() {
+    bool ok = true;
+    for (auto& d : diarios) {
+        if (d.abierto()) ok = d.sincronizar() && ok;
+    }
+    return ok;
+}
+
+// Inicia un lote: las tablas modificadas se escriben al terminarlo
+void BibliotecaDB::iniciarLote() {
+    enLote = true;
+}
+
+// Termina el lote: una escritura por tabla modificada (todas o ninguna) y un fsync del diario
+bool BibliotecaDB::terminarLote() {
+    enLote = false;
+    return volcarCambios();
+}
+
+// --- Escritura diferida ---
+
+void BibliotecaDB::activarEscrituraDiferida(std::chrono::milliseconds intervalo) {
+    diferida = true;
+    intervaloVolcado = intervalo;
+    ultimoVolcado = std::chrono::steady_clock::now();
+}
+
+// Dentro de un lote lo pendiente se escribe al terminarlo
+bool BibliotecaDB::desactivarEscrituraDiferida() {
+    diferida = false;
+    return enLote || volcarCambios();
+}
+
+// Escribe una vez cada tabla pendiente (todas o ninguna) y sincroniza el diario. Si la
+// escritura falla las tablas siguen pendientes para el próximo volcado
+bool BibliotecaDB::volcarCambios() {
+    ultimoVolcado = std::chrono::steady_clock::now();
+    bool tablas[NUM_TABLAS]; // escribirTablas limpia tablaPendiente al terminar
+    std::copy(tablaPendiente, tablaPendiente + NUM_TABLAS, tablas);
+    bool ok = escribirTablas(tablas);
+    if (modoDiario) ok = sincronizarDiario() && ok;
+    return ok;
+}
+
+// Un volcado dentro de un lote o una transacción escribiría cambios aún sin confirmar
+bool BibliotecaDB::volcarSiVencido() {
+    if (!diferida || enLote || enTransaccion || intervaloVolcado.count() == 0) return true;
+    if (std::chrono::steady_clock::now() - ultimoVolcado < intervaloVolcado) return true;
+    return volcarCambios();
+}
+
+// --- Transacciones ---
+
+bool BibliotecaDB::iniciarTransaccion() {
+    if (enTransaccion) return false;
+    enTransaccion = true;
+    gradosAlIniciar = grados.size();
+    nacionalidadesAlIniciar = nacionalidades.size();
+    return true;
+}
+
+// Escribe de una vez las tablas modificadas; si la escritura falla también se revierte la memoria
+bool BibliotecaDB::confirmarTransaccion() {
+    if (!enTransaccion) return false;
+    if (enLote || diferida) {
+        // El lote (o el próximo volcado) escribe estas tablas junto con las suyas
+        for (int t = 0; t < NUM_TABLAS; ++t) tablaPendiente[t] = tablaPendiente[t] || tablaTransaccion[t];
+    } else if (!escribirTablas(tablaTransaccion)) {
+        mensajes() << "Error: no se pudo guardar la transaccion; se revierten sus cambios.\n";
+        revertirTransaccion();
         return false;
     }
-    // Escribe cada autor como una línea CSV: id,nombre,nacionalidad
-    for (const auto& a : autores) {
-        file << a.id << "," << escapeField(a.nombre) << "," << escapeField(a.nacionalidad) << "\n";
+    terminarTransaccion();
+    volcarSiVencido(); // Si falla, las tablas siguen pendientes
+    return true;
+}
+
+// Restaura cada fila modificada a su imagen previa (alta de la fila anterior o baja si no
+// existía) con la misma reproducción que los diarios, y recalcula los índices derivados
+void BibliotecaDB::revertirTransaccion() {
+    if (!enTransaccion) return;
+    std::vector<RegistroDiario> registros[NUM_TABLAS];
+    for (const auto& imagen : deshacer) {
+        registros[imagen.tabla].push_back(imagen.fila ? RegistroDiario{'A', *imagen.fila}
+                                                      : RegistroDiario{'B', std::to_string(imagen.id)});
+    }
+    for (int t = 0; t < NUM_TABLAS; ++t) {
+        if (!registros[t].empty()) aplicarRegistros(static_cast<Tabla>(t), registros[t]);
+    }
+    // Ninguna fila restaurada usa los valores codificados durante la transacción
+    grados.recortar(gradosAlIniciar);
+    nacionalidades.recortar(nacionalidadesAlIniciar);
+    reconstruirIndicesDerivados();
+    compactarTextos(); // Los nombres descartados quedan sin uso en las arenas
+    terminarTransaccion();
+}
+
+void BibliotecaDB::terminarTransaccion() {
+    enTransaccion = false;
+    deshacer.clear();
+    for (auto& ids : filasRecordadas) ids.clear();
+    std::fill(tablaTransaccion, tablaTransaccion + NUM_TABLAS, false);
+}
+
+// Guarda la fila tal como estaba antes de la transacción; solo importa la primera modificación
+void BibliotecaDB::recordarFila(Tabla t, int id) {
+    if (!enTransaccion || !filasRecordadas[t].insert(id).second) return;
+    deshacer.push_back({t, id, filaActual(t, id)});
+}
+
+// Fila CSV actual del ID en la tabla, o sin valor si no existe
+std::optional<std::string> BibliotecaDB::filaActual(Tabla t, int id) const {
+    switch (t) {
+        case TABLA_ESTUDIANTES:
+            if (const Estudiante* e = buscarEstudiantePorId(id)) return filaEstudiante(*e);
+            break;
+        case TABLA_AUTORES:
+            if (const Autor* a = buscarAutorPorId(id)) return filaAutor(*a);
+            break;
+        case TABLA_EDITORIALES:
+            if (const Editorial* ed = buscarEditorialPorId(id)) return filaEditorial(*ed);
+            break;
+        case TABLA_LIBROS:
+            if (std::optional<Libro> l = buscarLibroPorId(id)) return filaLibro(*l);
+            break;
+        case TABLA_PRESTAMOS:
+            if (std::optional<Prestamo> p = buscarPrestamoPorId(id)) return filaPrestamo(*p);
+            break;
+        default: break;
+    }
+    return std::nullopt;
+}
+
+// Persiste una mutación: anexa al diario o, sin diario, reescribe el archivo completo
+// (dentro de un lote o una transacción solo se marca la tabla como pendiente)
+bool BibliotecaDB::persistir(Tabla t, char operacion, const std::string& fila) {
+    ++cambiosTabla[t];
+    if (replica) return true; // La base principal ya persistió la misma mutación
+    if (enTransaccion) {
+        tablaTransaccion[t] = true;
+        return true;
+    }
+    if (!modoDiario) {
+        if (enLote || diferida) {
+            tablaPendiente[t] = true;
+            return volcarSiVencido();
+        }
+        return guardarTabla(t);
     }
-    file.close();
+    if (!diarios[t].registrar(operacion, fila)) {
+        mensajes() << "Error al escribir en " << ARCHIVOS_DIARIO[t] << ".\n";
+        return false;
+    }
+    // Compacta la tabla cuando su diario crece demasiado
+    if (diarios[t].registrosPendientes() >= umbralCompactacion) return guardarTabla(t);
     return true;
 }
 
-// Carga los autores desde autores.txt al vector en memoria
-bool BibliotecaDB::cargarAutores() {
-    autores.clear(); // Limpia el vector antes de cargar
-    std::ifstream file("autores.txt");
-    if (!file.is_open()) return true;
-    std::string line;
-    // Lee cada línea y procesa los campos
-    while (std::getline(file, line)) {
-        auto tokens = splitLine(line, ',');
-        if (tokens.size() >= 3) {
-            try {
-                Autor a;
-                a.id = std::stoi(tokens[0]);
-                a.nombre = tokens[1];
-                a.nacionalidad = tokens[2];
-                autores.push_back(a);
-            } catch (...) {
-                std::cout << "Error al procesar linea en autores.txt: " << line << "\n";
+// Escribe el snapshot CSV de una tabla y vacía su diario (checkpoint)
+bool BibliotecaDB::guardarTabla(Tabla t) {
+    bool tablas[NUM_TABLAS] = {};
+    tablas[t] = true;
+    return escribirTablas(tablas);
+}
+
+// Escribe el CSV de una tabla en 'archivo'; para los préstamos informa su formato en 'enRegistros'
+bool BibliotecaDB::guardarTablaEn(Tabla t, const std::string& archivo, bool* enRegistros) const {
+    switch (t) {
+        case TABLA_ESTUDIANTES: return guardarEstudiantes(archivo);
+        case TABLA_AUTORES: return guardarAutores(archivo);
+        case TABLA_EDITORIALES: return guardarEditoriales(archivo);
+        case TABLA_LIBROS: return guardarLibros(archivo);
+        case TABLA_PRESTAMOS: return guardarPrestamos(archivo, enRegistros);
+        default: return false;
+    }
+}
+
+// Reemplaza las tablas indicadas todas o ninguna. Cada una se escribe primero en
+// <archivo>.tmp; después se escribe la lista de tablas en escritura.commit, cuyo
+// renombrado es el punto de confirmación, y por último se renombran los temporales.
+// Un fallo antes de confirmar deja los archivos anteriores intactos; una escritura
+// confirmada que no llegó a renombrarlo todo se completa al cargar. Cada archivo pasa
+// por fsync antes de renombrarse, así que ni un kill -9 ni un corte de energía dejan
+// un CSV a medias con su nombre definitivo.
+bool BibliotecaDB::escribirTablas(const bool tablas[NUM_TABLAS]) {
+    if (replica) return true;
+    recuperarEscritura(); // No debe quedar otra escritura a medias
+    ++generacion;         // Todas las tablas de esta escritura llevan la misma generación
+    // Cada tabla se escribe en su propio hilo (ver Paralelo.h); solo leen la base.
+    // La escritura habitual cambia una sola tabla: esa se escribe en este hilo.
+    std::vector<Tabla> sucias;
+    for (int t = 0; t < NUM_TABLAS; ++t) {
+        if (tablas[t]) sucias.push_back(static_cast<Tabla>(t));
+    }
+    bool temporalEnRegistros = false; // Formato del prestamos.txt escrito
+    auto escribir = [&](std::size_t i) {
+        return guardarTablaEn(sucias[i], ruta(ARCHIVOS_TABLA[sucias[i]]) + SUFIJO_TEMPORAL, &temporalEnRegistros);
+    };
+    bool escritas = sucias.size() == 1 ? escribir(0) : enParalelo(sucias.size(), escribir);
+    if (!escritas) {
+        descartarTemporales();
+        return false;
+    }
+    std::string lista;
+    for (int t = 0; t < NUM_TABLAS; ++t) {
+        if (tablas[t]) lista += std::to_string(t) + "\n";
+    }
+    if (lista.empty()) return true;
+    std::string confirmacion = ruta(ARCHIVO_CONFIRMACION);
+    ArchivoSalida salida;
+    bool ok = salida.abrir(confirmacion + SUFIJO_TEMPORAL);
+    if (ok) {
+        std::ostream file(&salida);
+        file << lista;
+        ok = salida.cerrar();
+    }
+    // El renombrado confirma la escritura cuando llega a disco junto con el directorio
+    ok = ok && reemplazarArchivo(confirmacion + SUFIJO_TEMPORAL, confirmacion) && sincronizarDirectorio(confirmacion);
+    if (!ok) {
+        mensajes() << "Error al confirmar la escritura de las tablas.\n";
+        descartarTemporales();
+        return false;
+    }
+    if (!completarEscritura(tablas)) return false;
+    // Los CSV escritos ya reflejan la memoria: sus tablas dejan de estar modificadas y pendientes
+    for (int t = 0; t < NUM_TABLAS; ++t) {
+        if (!tablas[t]) continue;
+        cambiosEscritos[t] = cambiosTabla[t];
+        tablaPendiente[t] = false;
+        if (t == TABLA_PRESTAMOS) prestamosEnRegistros = temporalEnRegistros;
+    }
+    return true;
+}
+
+// Reemplaza cada tabla confirmada por su temporal, vacía su diario (el snapshot ya
+// contiene sus cambios) y, si todo salió bien, borra el registro de confirmación
+bool BibliotecaDB::completarEscritura(const bool tablas[NUM_TABLAS]) {
+    bool ok = true;
+    for (int t = 0; t < NUM_TABLAS; ++t) {
+        if (!tablas[t]) continue;
+        std::string destino = ruta(ARCHIVOS_TABLA[t]);
+        std::error_code ec;
+        // Sin temporal la tabla ya se renombró antes de una interrupción
+        if (std::filesystem::exists(destino + SUFIJO_TEMPORAL, ec)) {
+            conservarAnterior(destino);
+            if (!reemplazarArchivo(destino + SUFIJO_TEMPORAL, destino)) {
+                mensajes() << "Error al reemplazar " << ARCHIVOS_TABLA[t] << ".\n";
+                ok = false;
+                continue;
             }
         }
+        if (diarios[t].abierto()) {
+            ok = diarios[t].truncar() && ok;
+        } else {
+            std::remove(ruta(ARCHIVOS_DIARIO[t]).c_str());
+        }
+    }
+    // Los renombrados deben llegar a disco antes de borrar el registro de confirmación
+    ok = sincronizarDirectorio(ruta(ARCHIVO_CONFIRMACION)) && ok;
+    if (ok) std::remove(ruta(ARCHIVO_CONFIRMACION).c_str());
+    return ok;
+}
+
+// Con un registro de confirmación la escritura se completa; sin él, sus temporales se descartan
+void BibliotecaDB::recuperarEscritura() {
+    std::ifstream file(ruta(ARCHIVO_CONFIRMACION));
+    if (!file.is_open()) {
+        descartarTemporales();
+        return;
+    }
+    bool tablas[NUM_TABLAS] = {};
+    int t;
+    while (file >> t) {
+        if (t >= 0 && t < NUM_TABLAS) tablas[t] = true;
     }
     file.close();
+    completarEscritura(tablas);
+}
+
+void BibliotecaDB::descartarTemporales() const {
+    for (const char* archivo : ARCHIVOS_TABLA) std::remove((ruta(archivo) + SUFIJO_TEMPORAL).c_str());
+    std::remove((ruta(ARCHIVO_CONFIRMACION) + SUFIJO_TEMPORAL).c_str());
+}
+
+// Lee el CSV de una tabla y verifica su línea de control. Un archivo dañado se aparta como
+// <archivo>.danado (para no sobrescribirlo al guardar) y se carga en su lugar la generación
+// anterior; los diarios, que se vacían al escribir la actual, no cubren esa diferencia
+EstadoArchivo BibliotecaDB::leerTabla(Tabla t, std::string& buffer, std::string_view& contenido,
+                                      std::vector<std::size_t>* interrumpidos) {
+    std::string destino = ruta(ARCHIVOS_TABLA[t]);
+    std::uint64_t gen = 0;
+    EstadoArchivo estado = leerVerificado(destino, buffer, contenido, gen, interrumpidos);
+    if (estado == ARCHIVO_DANADO && !replica) {
+        mensajes() << "Error: " << ARCHIVOS_TABLA[t] << " esta danado (checksum invalido); se conserva como "
+                  << ARCHIVOS_TABLA[t] << SUFIJO_DANADO << ".\n";
+        reemplazarArchivo(destino, destino + SUFIJO_DANADO);
+        estado = leerVerificado(destino + SUFIJO_ANTERIOR, buffer, contenido, gen, interrumpidos);
+        if ((estado == ARCHIVO_VALIDO || estado == ARCHIVO_SIN_CONTROL) &&
+            reemplazarArchivo(destino + SUFIJO_ANTERIOR, destino)) {
+            mensajes() << "Se cargo la generacion anterior de " << ARCHIVOS_TABLA[t] << ".\n";
+        } else {
+            mensajes() << "No hay una generacion anterior valida de " << ARCHIVOS_TABLA[t] << ".\n";
+            buffer.clear();
+            contenido = std::string_view();
+            return ARCHIVO_DANADO;
+        }
+    }
+    generacionLeida[t] = estado == ARCHIVO_VALIDO ? gen : 0;
+    return estado;
+}
+
+// Las bajas no dejan estas referencias colgando (eliminar un autor, una editorial, o el libro
+// o estudiante de un préstamo activo se rechaza), así que indican archivos editados a mano
+// o incompletos; los préstamos devueltos sí pueden citar filas ya eliminadas. También se cuentan
+// los ISBN con dígito de control incorrecto, que el menú y los lotes ya no aceptan. Solo se
+// advierte: las filas se conservan. Libros y préstamos se recorren por trozos en paralelo
+void BibliotecaDB::validarReferencias() const {
+    enum { AUTOR, EDITORIAL, ISBN, LIBRO, ESTUDIANTE, REFERENCIAS };
+    struct Huerfanas {
+        std::size_t cantidad = 0;
+        int ejemplo = 0;                      // Primera fila con la referencia rota
+        void contar(int id) {
+            if (cantidad++ == 0) ejemplo = id;
+        }
+    };
+    const std::size_t FILAS_POR_TROZO = 1 << 16;
+    std::size_t trozosLibros = (libros.size() + FILAS_POR_TROZO - 1) / FILAS_POR_TROZO;
+    std::size_t trozosPrestamos = (prestamos.size() + FILAS_POR_TROZO - 1) / FILAS_POR_TROZO;
+    std::vector<std::array<Huerfanas, REFERENCIAS>> parciales(trozosLibros + trozosPrestamos);
+    enParalelo(parciales.size(), [&](std::size_t t) {
+        std::array<Huerfanas, REFERENCIAS>& h = parciales[t];
+        bool deLibros = t < trozosLibros;
+        std::size_t inicio = (deLibros ? t : t - trozosLibros) * FILAS_POR_TROZO;
+        std::size_t fin = std::min(inicio + FILAS_POR_TROZO, deLibros ? libros.size() : prestamos.size());
+        for (std::size_t i = inicio; i < fin; ++i) {
+            if (deLibros) {
+                if (!indiceAutores.count(libros.idsAutor()[i])) h[AUTOR].contar(libros.ids()[i]);
+                if (!indiceEditoriales.count(libros.idsEditorial()[i])) h[EDITORIAL].contar(libros.ids()[i]);
+                if (!libros.isbns()[i].controlValido()) h[ISBN].contar(libros.ids()[i]);
+            } else if (prestamos.fechasDevolucion()[i].vacia()) {
+                if (!indiceLibros.count(prestamos.idsLibro()[i])) h[LIBRO].contar(prestamos.ids()[i]);
+                if (!estudiantesExternos && !indiceEstudiantes.count(prestamos.idsEstudiante()[i])) {
+                    h[ESTUDIANTE].contar(prestamos.ids()[i]);
+                }
+            }
+        }
+        return true;
+    });
+    // Los trozos se combinan en orden: el ejemplo es la primera fila del archivo
+    std::array<Huerfanas, REFERENCIAS> total;
+    for (const auto& h : parciales) {
+        for (int r = 0; r < REFERENCIAS; ++r) {
+            if (total[r].cantidad == 0) total[r].ejemplo = h[r].ejemplo;
+            total[r].cantidad += h[r].cantidad;
+        }
+    }
+    static const char* const DESCRIPCION[REFERENCIAS] = {
+        "libros citan un autor inexistente (p. ej. libro ID ",
+        "libros citan una editorial inexistente (p. ej. libro ID ",
+        "libros tienen un ISBN con digito de control incorrecto (p. ej. libro ID ",
+        "prestamos activos citan un libro inexistente (p. ej. prestamo ID ",
+        "prestamos activos citan un estudiante inexistente (p. ej. prestamo ID "
+    };
+    for (int r = 0; r < REFERENCIAS; ++r) {
+        if (total[r].cantidad > 0) {
+            mensajes() << "Advertencia: " << total[r].cantidad << " " << DESCRIPCION[r] << total[r].ejemplo << ").\n";
+        }
+    }
+}
+
+// Aplica los diarios existentes sobre los datos recién cargados de los CSV
+bool BibliotecaDB::reproducirDiarios() {
+    std::vector<RegistroDiario> registros;
+    bool conNombres = false; // Los nombres reemplazados o eliminados quedan sin uso en sus arenas
+    for (int t = 0; t < NUM_TABLAS; ++t) {
+        Diario::leer(ruta(ARCHIVOS_DIARIO[t]), registros);
+        if (registros.empty()) continue;
+        aplicarRegistros(static_cast<Tabla>(t), registros);
+        ++cambiosTabla[t]; // Su CSV no contiene los registros: guardarCambios la compacta
+        if (t != TABLA_LIBROS && t != TABLA_PRESTAMOS) conNombres = true;
+    }
+    if (conNombres) compactarTextos();
     return true;
 }
 
-// Guarda la lista de editoriales en editoriales.txt en formato CSV
-bool BibliotecaDB::guardarEditoriales() const {
-    std::ofstream file("editoriales.txt");
-    if (!file.is_open()) {
-        std::cout << "Error al abrir editoriales.txt para guardar.\n";
+// Aplica registros de alta/modificación y baja sobre una tabla (solo su índice por ID)
+void BibliotecaDB::aplicarRegistros(Tabla t, const std::vector<RegistroDiario>& registros) {
+    std::string espacio;
+    switch (t) {
+        case TABLA_ESTUDIANTES:
+            reproducir(registros, ARCHIVOS_DIARIO[t], estudiantes, indiceEstudiantes,
+                       [this](std::string_view f, Estudiante& e) { return parsearEstudiante(f, e); });
+            break;
+        case TABLA_AUTORES:
+            reproducir(registros, ARCHIVOS_DIARIO[t], autores, indiceAutores,
+                       [this](std::string_view f, Autor& a) { return parsearAutor(f, a); });
+            break;
+        case TABLA_EDITORIALES:
+            reproducir(registros, ARCHIVOS_DIARIO[t], editoriales, indiceEditoriales,
+                       [this](std::string_view f, Editorial& ed) { return parsearEditorial(f, ed); });
+            break;
+        case TABLA_LIBROS:
+            reproducir(registros, ARCHIVOS_DIARIO[t], libros, indiceLibros,
+                       [this, &espacio](std::string_view f, Libro& l) { return parsearLibro(f, l, espacio); });
+            break;
+        case TABLA_PRESTAMOS:
+            reproducir(registros, ARCHIVOS_DIARIO[t], prestamos, indicePrestamos,
+                       [this](std::string_view f, Prestamo& p) { return parsearPrestamo(f, p); });
+            break;
+        default: break;
+    }
+}
+
+// Convierte un estudiante en una línea CSV: id,nombre,grado
+std::string BibliotecaDB::filaEstudiante(const Estudiante& e) const {
+    return std::to_string(e.id) + "," + escapeField(e.nombre) + "," + escapeField(textoGrado(e.grado));
+}
+
+// Convierte un autor en una línea CSV: id,nombre,nacionalidad
+std::string BibliotecaDB::filaAutor(const Autor& a) const {
+    return std::to_string(a.id) + "," + escapeField(a.nombre) + "," +
+           escapeField(textoNacionalidad(a.nacionalidad));
+}
+
+// Convierte una editorial en una línea CSV: id,nombre
+std::string BibliotecaDB::filaEditorial(const Editorial& ed) const {
+    return std::to_string(ed.id) + "," + escapeField(ed.nombre);
+}
+
+// Convierte un libro en una línea CSV: id,título,isbn,año,id_autor,id_editorial
+std::string BibliotecaDB::filaLibro(const Libro& l) const {
+    return std::to_string(l.id) + "," + escapeField(l.titulo) + "," + l.isbn.texto() + "," +
+           std::to_string(l.anio) + "," + std::to_string(l.id_autor) + "," + std::to_string(l.id_editorial);
+}
+
+// Convierte un préstamo en una línea CSV: id,id_libro,id_estudiante,fecha_prestamo,fecha_devolucion
+std::string BibliotecaDB::filaPrestamo(const Prestamo& p) const {
+    return std::to_string(p.id) + "," + std::to_string(p.id_libro) + "," + std::to_string(p.id_estudiante) + "," +
+           p.fecha_prestamo.texto() + "," + p.fecha_devolucion.texto();
+}
+
+// Convierte un préstamo en su registro de ancho fijo, que sigue siendo una línea CSV válida
+// (parsearPrestamo ignora los espacios de relleno); los IDs deben caber (cabeEnRegistro)
+bool BibliotecaDB::registroPrestamo(const Prestamo& p, char* registro) const {
+    std::memset(registro, ' ', LARGO_REGISTRO - LARGO_SELLO);
+    char* campo = registro;
+    for (int v : {p.id, p.id_libro, p.id_estudiante}) {
+        char digitos[16];
+        std::size_t n = static_cast<std::size_t>(std::to_chars(digitos, digitos + sizeof digitos, v).ptr - digitos);
+        if (n > ANCHO_CAMPO) return false;
+        std::memcpy(campo + ANCHO_CAMPO - n, digitos, n);
+        campo[ANCHO_CAMPO] = ',';
+        campo += ANCHO_CAMPO + 1;
+    }
+    p.fecha_prestamo.formatear(campo);
+    campo[ANCHO_CAMPO] = ',';
+    p.fecha_devolucion.formatear(campo + ANCHO_CAMPO + 1); // Sin fecha quedan los espacios
+    sellarRegistro(registro, DESPLAZAMIENTO_DEVOLUCION);  // Una devolución no cambia lo anterior
+    return true;
+}
+
+// Interpreta una línea CSV de estudiante; retorna false si está incompleta o mal formada
+bool BibliotecaDB::parsearEstudiante(std::string_view linea, Estudiante& e, const std::vector<std::uint32_t>* codigos) {
+    std::string_view campos[3];
+    if (csv::dividirCampos(linea, ',', campos, 3) < 3 || !csv::parsearEntero(campos[0], e.id) ||
+        !leerCodificado(campos[2], grados, codigos, e.grado)) {
         return false;
     }
-    // Escribe cada editorial como una línea CSV: id,nombre
-    for (const auto& ed : editoriales) {
-        file << ed.id << "," << escapeField(ed.nombre) << "\n";
+    std::string espacio;
+    e.nombre = textosEstudiantes.guardar(csv::vistaCampo(campos[1], espacio));
+    return true;
+}
+
+// Interpreta una línea CSV de autor
+bool BibliotecaDB::parsearAutor(std::string_view linea, Autor& a, const std::vector<std::uint32_t>* codigos) {
+    std::string_view campos[3];
+    if (csv::dividirCampos(linea, ',', campos, 3) < 3 || !csv::parsearEntero(campos[0], a.id) ||
+        !leerCodificado(campos[2], nacionalidades, codigos, a.nacionalidad)) {
+        return false;
     }
-    file.close();
+    std::string espacio;
+    a.nombre = textosAutores.guardar(csv::vistaCampo(campos[1], espacio));
     return true;
 }
 
-// Carga las editoriales desde editoriales.txt al vector en memoria
-bool BibliotecaDB::cargarEditoriales() {
-    editoriales.clear(); // Limpia el vector antes de cargar
-    std::ifstream file("editoriales.txt");
-    if (!file.is_open()) return true;
-    std::string line;
-    // Lee cada línea y procesa los campos
-    while (std::getline(file, line)) {
-        auto tokens = splitLine(line, ',');
-        if (tokens.size() >= 2) {
-            try {
-                Editorial ed;
-                ed.id = std::stoi(tokens[0]);
-                ed.nombre = tokens[1];
-                editoriales.push_back(ed);
-            } catch (...) {
-                std::cout << "Error al procesar linea en editoriales.txt: " << line << "\n";
-            }
+// Interpreta una línea CSV de editorial
+bool BibliotecaDB::parsearEditorial(std::string_view linea, Editorial& ed) {
+    std::string_view campos[2];
+    if (csv::dividirCampos(linea, ',', campos, 2) < 2 || !csv::parsearEntero(campos[0], ed.id)) return false;
+    std::string espacio;
+    ed.nombre = textosEditoriales.guardar(csv::vistaCampo(campos[1], espacio));
+    return true;
+}
+
+// Interpreta una línea CSV de libro
+bool BibliotecaDB::parsearLibro(std::string_view linea, Libro& l, std::string& espacio) const {
+    std::string_view campos[6];
+    if (csv::dividirCampos(linea, ',', campos, 6) < 6) return false;
+    if (!csv::parsearEntero(campos[0], l.id) || !csv::parsearEntero(campos[3], l.anio) ||
+        !csv::parsearEntero(campos[4], l.id_autor) || !csv::parsearEntero(campos[5], l.id_editorial)) {
+        return false;
+    }
+    l.titulo = csv::vistaCampo(campos[1], espacio);
+    return Isbn::parsear(campos[2], l.isbn);
+}
+
+// Interpreta una línea CSV de préstamo
+bool BibliotecaDB::parsearPrestamo(std::string_view linea, Prestamo& p) const {
+    std::string_view campos[5];
+    std::size_t n = csv::dividirCampos(linea, ',', campos, 5);
+    if (n < 4) return false;
+    if (!csv::parsearEntero(campos[0], p.id) || !csv::parsearEntero(campos[1], p.id_libro) ||
+        !csv::parsearEntero(campos[2], p.id_estudiante)) {
+        return false;
+    }
+    // Sin quinto campo (o vacío, o solo espacios en un registro fijo) el préstamo sigue activo
+    std::string_view devolucion = n > 4 ? campos[4] : std::string_view();
+    while (!devolucion.empty() && devolucion.back() == ' ') devolucion.remove_suffix(1);
+    return Fecha::parsear(campos[3], p.fecha_prestamo) && !p.fecha_prestamo.vacia() &&
+           Fecha::parsear(devolucion, p.fecha_devolucion);
+}
+
+// Guarda la lista de estudiantes en formato CSV (estudiantes.txt) en 'archivo', con los grados codificados
+bool BibliotecaDB::guardarEstudiantes(const std::string& archivo) const {
+    ArchivoSalida salida;
+    if (!salida.abrir(archivo, true)) {
+        mensajes() << "Error al abrir estudiantes.txt para guardar.\n";
+        return false;
+    }
+    // Las filas se formatean en el bloque sin cadenas intermedias ni std::ostream
+    std::string bloque;
+    bloque.reserve(BYTES_BLOQUE + BYTES_BLOQUE / 8);
+    // Los grados se escriben una vez en la cabecera y cada fila lleva su código
+    escribirDiccionario(bloque, grados);
+    for (const auto& e : estudiantes) {
+        csv::anexarEntero(bloque, e.id);
+        bloque += ',';
+        csv::anexarCampo(bloque, e.nombre);
+        bloque += ',';
+        csv::anexarEntero(bloque, e.grado);
+        bloque += '\n';
+        vaciarBloque(salida, bloque);
+    }
+    vaciarBloque(salida, bloque, true);
+    // Un error de escritura o de fsync (p. ej. disco lleno) invalida el archivo
+    return salida.cerrar(generacion);
+}
+
+// Carga los estudiantes desde estudiantes.txt al vector en memoria
+bool BibliotecaDB::cargarEstudiantes() {
+    estudiantes.clear(); // Limpia el vector, su arena, su índice y el diccionario de grados antes de cargar
+    indiceEstudiantes.clear();
+    textosEstudiantes.limpiar();
+    grados.limpiar();
+    std::string buffer;
+    std::string_view resto, line;
+    EstadoArchivo estado = leerTabla(TABLA_ESTUDIANTES, buffer, resto);
+    if (estado == ARCHIVO_AUSENTE) return true; // No es error si el archivo no existe
+    if (estado == ARCHIVO_DANADO) return false;
+    std::size_t lineas = csv::contarLineas(resto);
+    estudiantes.reserve(lineas);
+    indiceEstudiantes.reserve(lineas);
+    textosEstudiantes.reservar(buffer.size()); // Los nombres caben en el tamaño del archivo: un solo bloque
+    std::vector<std::uint32_t> codigos;
+    const std::vector<std::uint32_t>* conCodigos = leerDiccionario(resto, grados, codigos) ? &codigos : nullptr;
+    // Recorre el buffer línea a línea sin copiarlo
+    while (csv::siguienteLinea(resto, line)) {
+        if (line.empty()) continue;
+        Estudiante e;
+        if (!parsearEstudiante(line, e, conCodigos)) {
+            mensajes() << "Error al procesar linea en estudiantes.txt: " << line << "\n";
+        } else if (!insertarConIndice(estudiantes, indiceEstudiantes, e)) {
+            textosEstudiantes.liberar(e.nombre);
+            mensajes() << "ID duplicado ignorado en estudiantes.txt: " << line << "\n";
         }
     }
-    file.close();
     return true;
 }
 
-// Guarda la lista de libros en libros.txt en formato CSV
-bool BibliotecaDB::guardarLibros() const {
-    std::ofstream file("libros.txt");
-    if (!file.is_open()) {
-        std::cout << "Error al abrir libros.txt para guardar.\n";
+// Guarda la lista de autores en formato CSV (autores.txt) en 'archivo', con las nacionalidades codificadas
+bool BibliotecaDB::guardarAutores(const std::string& archivo) const {
+    ArchivoSalida salida;
+    if (!salida.abrir(archivo, true)) {
+        mensajes() << "Error al abrir autores.txt para guardar.\n";
         return false;
     }
-    // Escribe cada libro como una línea CSV: id,título,isbn,año,id_autor,id_editorial
-    for (const auto& l : libros) {
-        file << l.id << "," << escapeField(l.titulo) << "," << escapeField(l.isbn) << "," << l.anio
-             << "," << l.id_autor << "," << l.id_editorial << "\n";
+    std::string bloque;
+    bloque.reserve(BYTES_BLOQUE + BYTES_BLOQUE / 8);
+    // Las nacionalidades se escriben una vez en la cabecera y cada fila lleva su código
+    escribirDiccionario(bloque, nacionalidades);
+    for (const auto& a : autores) {
+        csv::anexarEntero(bloque, a.id);
+        bloque += ',';
+        csv::anexarCampo(bloque, a.nombre);
+        bloque += ',';
+        csv::anexarEntero(bloque, a.nacionalidad);
+        bloque += '\n';
+        vaciarBloque(salida, bloque);
+    }
+    vaciarBloque(salida, bloque, true);
+    return salida.cerrar(generacion);
+}
+
+// Carga los autores desde autores.txt al vector en memoria
+bool BibliotecaDB::cargarAutores() {
+    autores.clear(); // Limpia el vector, su arena, su índice y el diccionario de nacionalidades antes de cargar
+    indiceAutores.clear();
+    textosAutores.limpiar();
+    nacionalidades.limpiar();
+    std::string buffer;
+    std::string_view resto, line;
+    EstadoArchivo estado = leerTabla(TABLA_AUTORES, buffer, resto);
+    if (estado == ARCHIVO_AUSENTE) return true; // No es error si el archivo no existe
+    if (estado == ARCHIVO_DANADO) return false;
+    std::size_t lineas = csv::contarLineas(resto);
+    autores.reserve(lineas);
+    indiceAutores.reserve(lineas);
+    textosAutores.reservar(buffer.size()); // Los nombres caben en el tamaño del archivo: un solo bloque
+    std::vector<std::uint32_t> codigos;
+    const std::vector<std::uint32_t>* conCodigos = leerDiccionario(resto, nacionalidades, codigos) ? &codigos : nullptr;
+    // Recorre el buffer línea a línea sin copiarlo
+    while (csv::siguienteLinea(resto, line)) {
+        if (line.empty()) continue;
+        Autor a;
+        if (!parsearAutor(line, a, conCodigos)) {
+            mensajes() << "Error al procesar linea en autores.txt: " << line << "\n";
+        } else if (!insertarConIndice(autores, indiceAutores, a)) {
+            textosAutores.liberar(a.nombre);
+            mensajes() << "ID duplicado ignorado en autores.txt: " << line << "\n";
+        }
+    }
+    return true;
+}
+
+// Guarda la lista de editoriales en formato CSV (editoriales.txt) en 'archivo'
+bool BibliotecaDB::guardarEditoriales(const std::string& archivo) const {
+    ArchivoSalida salida;
+    if (!salida.abrir(archivo, true)) {
+        mensajes() << "Error al abrir editoriales.txt para guardar.\n";
+        return false;
+    }
+    std::string bloque;
+    bloque.reserve(BYTES_BLOQUE + BYTES_BLOQUE / 8);
+    for (const auto& ed : editoriales) {
+        csv::anexarEntero(bloque, ed.id);
+        bloque += ',';
+        csv::anexarCampo(bloque, ed.nombre);
+        bloque += '\n';
+        vaciarBloque(salida, bloque);
+    }
+    vaciarBloque(salida, bloque, true);
+    return salida.cerrar(generacion);
+}
+
+// Carga las editoriales desde editoriales.txt al vector en memoria
+bool BibliotecaDB::cargarEditoriales() {
+    editoriales.clear(); // Limpia el vector, su arena y su índice antes de cargar
+    indiceEditoriales.clear();
+    textosEditoriales.limpiar();
+    std::string buffer;
+    std::string_view resto, line;
+    EstadoArchivo estado = leerTabla(TABLA_EDITORIALES, buffer, resto);
+    if (estado == ARCHIVO_AUSENTE) return true; // No es error si el archivo no existe
+    if (estado == ARCHIVO_DANADO) return false;
+    std::size_t lineas = csv::contarLineas(resto);
+    editoriales.reserve(lineas);
+    indiceEditoriales.reserve(lineas);
+    textosEditoriales.reservar(buffer.size()); // Los nombres caben en el tamaño del archivo: un solo bloque
+    // Recorre el buffer línea a línea sin copiarlo
+    while (csv::siguienteLinea(resto, line)) {
+        if (line.empty()) continue;
+        Editorial ed;
+        if (!parsearEditorial(line, ed)) {
+            mensajes() << "Error al procesar linea en editoriales.txt: " << line << "\n";
+        } else if (!insertarConIndice(editoriales, indiceEditoriales, ed)) {
+            textosEditoriales.liberar(ed.nombre);
+            mensajes() << "ID duplicado ignorado en editoriales.txt: " << line << "\n";
+        }
     }
-    file.close();
     return true;
 }
 
+// Guarda la lista de libros en formato CSV (libros.txt) en 'archivo'
+bool BibliotecaDB::guardarLibros(const std::string& archivo) const {
+    ArchivoSalida salida;
+    if (!salida.abrir(archivo, true)) {
+        mensajes() << "Error al abrir libros.txt para guardar.\n";
+        return false;
+    }
+    std::string bloque;
+    bloque.reserve(BYTES_BLOQUE + BYTES_BLOQUE / 8);
+    char isbn[Isbn::MAX_DIGITOS];
+    for (std::size_t i = 0; i < libros.size(); ++i) {
+        const auto& l = libros[i];
+        csv::anexarEntero(bloque, l.id);
+        bloque += ',';
+        csv::anexarCampo(bloque, l.titulo);
+        bloque += ',';
+        bloque.append(isbn, l.isbn.formatear(isbn));
+        bloque += ',';
+        csv::anexarEntero(bloque, l.anio);
+        bloque += ',';
+        csv::anexarEntero(bloque, l.id_autor);
+        bloque += ',';
+        csv::anexarEntero(bloque, l.id_editorial);
+        bloque += '\n';
+        vaciarBloque(salida, bloque);
+    }
+    vaciarBloque(salida, bloque, true);
+    return salida.cerrar(generacion);
+}
+
 // Carga los libros desde libros.txt al vector en memoria
 bool BibliotecaDB::cargarLibros() {
-    libros.clear(); // Limpia el vector antes de cargar
-    std::ifstream file("libros.txt");
-    if (!file.is_open()) return true;
-    std::string line;
-    // Lee cada línea y procesa los campos
-    while (std::getline(file, line)) {
-        auto tokens = splitLine(line, ',');
-        if (tokens.size() >= 6) {
-            try {
-                Libro l;
-                l.id = std::stoi(tokens[0]);
-                l.titulo = tokens[1];
-                l.isbn = tokens[2];
-                l.anio = std::stoi(tokens[3]);
-                l.id_autor = std::stoi(tokens[4]);
-                l.id_editorial = std::stoi(tokens[5]);
-                libros.push_back(l);
-            } catch (...) {
-                std::cout << "Error al procesar linea en libros.txt: " << line << "\n";
+    libros.clear(); // Limpia el vector y su índice antes de cargar
+    indiceLibros.clear();
+    std::string buffer;
+    std::string_view resto;
+    EstadoArchivo estado = leerTabla(TABLA_LIBROS, buffer, resto);
+    if (estado == ARCHIVO_AUSENTE) return true; // No es error si el archivo no existe
+    if (estado == ARCHIVO_DANADO) return false;
+    // Los trozos se interpretan en paralelo; los títulos son vistas al buffer (o a 'escapados')
+    // hasta que push_back los copia a la columna
+    auto trozos = interpretarEnTrozos<Libro>(resto, [this](std::string_view linea, Libro& l,
+                                                            std::deque<std::string>& escapados) {
+        std::string espacio;
+        if (!parsearLibro(linea, l, espacio)) return false;
+        if (!espacio.empty() && l.titulo.data() == espacio.data()) {
+            escapados.push_back(std::move(espacio));
+            l.titulo = escapados.back();
+        }
+        return true;
+    });
+    // Se funden en el orden del archivo (el de los IDs al guardar) detectando IDs repetidos
+    std::size_t lineas = 0;
+    for (const auto& trozo : trozos) lineas += trozo.filas.size();
+    libros.reserve(lineas);
+    indiceLibros.reserve(lineas);
+    for (const auto& trozo : trozos) {
+        for (std::size_t i = 0; i < trozo.filas.size(); ++i) {
+            if (!trozo.validas[i]) {
+                mensajes() << "Error al procesar linea en libros.txt: " << trozo.lineas[i] << "\n";
+            } else if (!insertarConIndice(libros, indiceLibros, trozo.filas[i])) {
+                mensajes() << "ID duplicado ignorado en libros.txt: " << trozo.lineas[i] << "\n";
             }
         }
     }
-    file.close();
     return true;
 }
 
-// Guarda la lista de préstamos en prestamos.txt en formato CSV
-bool BibliotecaDB::guardarPrestamos() const {
-    std::ofstream file("prestamos.txt");
-    if (!file.is_open()) {
-        std::cout << "Error al abrir prestamos.txt para guardar.\n";
+// Guarda la lista de préstamos en formato CSV (prestamos.txt) en 'archivo'
+bool BibliotecaDB::guardarPrestamos(const std::string& archivo, bool* enRegistros) const {
+    // Un ID que no cabe en su campo obliga a escribir filas de largo variable
+    const auto& ids = prestamos.ids();
+    const auto& idsLibro = prestamos.idsLibro();
+    const auto& idsEstudiante = prestamos.idsEstudiante();
+    bool registros = prestamosAnchoFijo && std::all_of(ids.begin(), ids.end(), cabeEnRegistro) &&
+                     std::all_of(idsLibro.begin(), idsLibro.end(), cabeEnRegistro) &&
+                     std::all_of(idsEstudiante.begin(), idsEstudiante.end(), cabeEnRegistro);
+    if (enRegistros) *enRegistros = registros;
+    ArchivoSalida salida;
+    // Los registros llevan su propio sello en lugar de la línea de control
+    if (!salida.abrir(archivo, !registros)) {
+        mensajes() << "Error al abrir prestamos.txt para guardar.\n";
         return false;
     }
-    // Escribe cada préstamo como una línea CSV: id,id_libro,id_estudiante,fecha_prestamo,fecha_devolucion
-    for (const auto& p : prestamos) {
-        file << p.id << "," << p.id_libro << "," << p.id_estudiante << ","
-             << escapeField(p.fecha_prestamo) << "," << escapeField(p.fecha_devolucion) << "\n";
+    std::string bloque;
+    bloque.reserve(BYTES_BLOQUE + BYTES_BLOQUE / 8);
+    if (registros) {
+        char registro[LARGO_REGISTRO];
+        formatearCabeceraFija(registro, generacion, prestamos.size(), DESPLAZAMIENTO_DEVOLUCION);
+        bloque.append(registro, LARGO_REGISTRO);
+        for (std::size_t i = 0; i < prestamos.size(); ++i) {
+            registroPrestamo(prestamos[i], registro);
+            bloque.append(registro, LARGO_REGISTRO);
+            vaciarBloque(salida, bloque);
+        }
+        vaciarBloque(salida, bloque, true);
+        return salida.cerrar();
+    }
+    char fecha[Fecha::LARGO_TEXTO];
+    for (std::size_t i = 0; i < prestamos.size(); ++i) {
+        const auto& p = prestamos[i];
+        csv::anexarEntero(bloque, p.id);
+        bloque += ',';
+        csv::anexarEntero(bloque, p.id_libro);
+        bloque += ',';
+        csv::anexarEntero(bloque, p.id_estudiante);
+        bloque += ',';
+        bloque.append(fecha, p.fecha_prestamo.formatear(fecha));
+        bloque += ',';
+        bloque.append(fecha, p.fecha_devolucion.formatear(fecha)); // Vacía si sigue activo
+        bloque += '\n';
+        vaciarBloque(salida, bloque);
+    }
+    vaciarBloque(salida, bloque, true);
+    return salida.cerrar(generacion);
+}
+
+// Con prestamos.txt en registros fijos y al día con la memoria (misma fila en cada posición),
+// una devolución que se escribiría de inmediato solo cambia los bytes de su fecha y su sello.
+// Los demás modos ya evitan reescribir el archivo en cada devolución o prometen más de lo que
+// dan varias escrituras en el lugar, así que siguen su camino habitual:
+// - Con diario la devolución es un registro anexado a prestamos.log, y el fsync se hace por
+//   grupos; una escritura posicionada con su propio fsync costaría más. El servidor usa este.
+// - Lotes, transacciones y escritura diferida escriben sus tablas todas o ninguna al final;
+//   varios registros reescritos uno tras otro podrían quedar a medias tras un corte.
+// - Una réplica no escribe archivos.
+bool BibliotecaDB::devolverEnLugar(std::size_t pos) {
+    if (replica || modoDiario || enLote || enTransaccion || diferida || !prestamosEnRegistros ||
+        tablaModificada(TABLA_PRESTAMOS)) {
+        return false;
     }
-    file.close();
-    return true;
+    return reescribirDevolucion(pos);
+}
+
+// Solo desde la fecha de devolución: la parte fija y su checksum no se tocan
+bool BibliotecaDB::reescribirDevolucion(std::size_t pos) const {
+    char registro[LARGO_REGISTRO];
+    if (!registroPrestamo(prestamos[pos], registro)) return false;
+    std::uint64_t desplazamiento = (pos + 1) * LARGO_REGISTRO + DESPLAZAMIENTO_DEVOLUCION;
+    return escribirEnPosicion(ruta(ARCHIVOS_TABLA[TABLA_PRESTAMOS]), desplazamiento,
+                              registro + DESPLAZAMIENTO_DEVOLUCION, LARGO_REGISTRO - DESPLAZAMIENTO_DEVOLUCION);
 }
 
 // Carga los préstamos desde prestamos.txt al vector en memoria
 bool BibliotecaDB::cargarPrestamos() {
-    prestamos.clear(); // Limpia el vector antes de cargar
-    std::ifstream file("prestamos.txt");
-    if (!file.is_open()) return true;
-    std::string line;
-    // Lee cada línea y procesa los campos
-    while (std::getline(file, line)) {
-        auto tokens = splitLine(line, ',');
-        if (tokens.size() >= 5) {
-            try {
-                Prestamo p;
-                p.id = std::stoi(tokens[0]);
-                p.id_libro = std::stoi(tokens[1]);
-                p.id_estudiante = std::stoi(tokens[2]);
-                p.fecha_prestamo = tokens[3];
-                p.fecha_devolucion = tokens[4];
-                prestamos.push_back(p);
-            } catch (...) {
-                std::cout << "Error al procesar linea en prestamos.txt: " << line << "\n";
+    prestamos.clear(); // Limpia el vector y su índice antes de cargar
+    indicePrestamos.clear();
+    prestamosEnRegistros = false;
+    prestamosPorReescribir = false;
+    std::string buffer;
+    std::string_view resto;
+    std::vector<std::size_t> interrumpidos; // Devoluciones en el lugar que no terminaron
+    EstadoArchivo estado = leerTabla(TABLA_PRESTAMOS, buffer, resto, &interrumpidos);
+    if (estado == ARCHIVO_AUSENTE) return true; // No es error si el archivo no existe
+    if (estado == ARCHIVO_DANADO) return false;
+    for (std::size_t i : interrumpidos) sanearRegistro(&buffer[(i + 1) * LARGO_REGISTRO]);
+    // Como en cargarLibros: trozos en paralelo y fusión en el orden del archivo
+    auto trozos = interpretarEnTrozos<Prestamo>(resto, [this](std::string_view linea, Prestamo& p,
+                                                               std::deque<std::string>&) {
+        return parsearPrestamo(linea, p);
+    });
+    std::size_t lineas = 0;
+    for (const auto& trozo : trozos) lineas += trozo.filas.size();
+    prestamos.reserve(lineas);
+    indicePrestamos.reserve(lineas);
+    for (const auto& trozo : trozos) {
+        for (std::size_t i = 0; i < trozo.filas.size(); ++i) {
+            if (!trozo.validas[i]) {
+                mensajes() << "Error al procesar linea en prestamos.txt: " << trozo.lineas[i] << "\n";
+            } else if (!insertarConIndice(prestamos, indicePrestamos, trozo.filas[i])) {
+                mensajes() << "ID duplicado ignorado en prestamos.txt: " << trozo.lineas[i] << "\n";
             }
         }
     }
-    file.close();
+    // Las devoluciones pueden reescribir su registro si cada fila quedó en su posición
+    prestamosEnRegistros = estado == ARCHIVO_VALIDO && conRegistrosFijos(buffer) &&
+                           prestamos.size() == resto.size() / LARGO_REGISTRO;
+    if (!interrumpidos.empty()) {
+        mensajes() << "Advertencia: se interrumpio la devolucion del registro " << interrumpidos.front() + 1
+                   << " de prestamos.txt; el prestamo sigue activo.\n";
+        // Se repara en su lugar; si no se puede (o las filas no quedaron en su posición),
+        // cargarDatos reescribe prestamos.txt completo
+        for (std::size_t i : interrumpidos) {
+            if (replica) break;
+            prestamosPorReescribir = prestamosPorReescribir || !prestamosEnRegistros || !reescribirDevolucion(i);
+        }
+    }
     return true;
-}
\ No newline at end of file
+}
@@ -1,34 +1,56 @@
 #ifndef BIBLIOTECA_H
 #define BIBLIOTECA_H
 
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
+#include "Archivos.h"
+#include "ArenaTextos.h"
+#include "Columnas.h"
+#include "Diario.h"
+#include "Diccionario.h"
+#include "Fecha.h"
+#include "IndicePrefijos.h"
+#include "Isbn.h"
+#include "IndiceTexto.h"
+
+// Los textos de las entidades son vistas: dentro de BibliotecaDB apuntan a sus arenas
+// (o a la columna de titulos); al construir una entidad para agregarla basta con que el
+// texto viva hasta la llamada, que lo copia. Las vistas obtenidas de la base siguen
+// validas hasta la siguiente modificacion de esa tabla.
 
 // Representa un estudiante en el sistema de biblioteca
 struct Estudiante {
     int id;                    // Identificador unico del estudiante
-    std::string nombre;        // Nombre completo del estudiante
-    std::string grado;         // Grado academico (e.g., "1er ano", "Maestria")
+    std::string_view nombre;   // Nombre completo del estudiante
+    std::uint32_t grado;       // Codigo del grado academico (e.g., "1er ano"); ver BibliotecaDB::textoGrado
 };
 
 // Representa un autor de libros
 struct Autor {
     int id;                    // Identificador unico del autor
-    std::string nombre;        // Nombre completo del autor
-    std::string nacionalidad;  // Nacionalidad del autor (e.g., "Mexicana")
+    std::string_view nombre;   // Nombre completo del autor
+    std::uint32_t nacionalidad; // Codigo de la nacionalidad (e.g., "Mexicana"); ver textoNacionalidad
 };
 
 // Representa una editorial que publica libros
 struct Editorial {
     int id;                    // Identificador unico de la editorial
-    std::string nombre;        // Nombre de la editorial (e.g., "Planeta")
+    std::string_view nombre;   // Nombre de la editorial (e.g., "Planeta")
 };
 
 // Representa un libro en la biblioteca
 struct Libro {
     int id;                    // Identificador unico del libro
-    std::string titulo;        // Titulo del libro
-    std::string isbn;          // ISBN unico del libro
+    std::string_view titulo;   // Titulo del libro
+    Isbn isbn;                 // ISBN unico del libro (normalizado, ver Isbn.h)
     int anio;                  // Ano de publicacion
     int id_autor;              // ID del autor asociado
     int id_editorial;          // ID de la editorial asociada
@@ -39,87 +61,335 @@ struct Prestamo {
     int id;                    // Identificador unico del prestamo
     int id_libro;              // ID del libro prestado
     int id_estudiante;         // ID del estudiante que solicito el prestamo
-    std::string fecha_prestamo;   // Fecha de prestamo (formato YYYY-MM-DD)
-    std::string fecha_devolucion; // Fecha de devolucion (vacia si no devuelto)
+    Fecha fecha_prestamo;      // Fecha de prestamo
+    Fecha fecha_devolucion;    // Fecha de devolucion (vacia si no devuelto)
+};
+
+// Tablas de la base de datos; indexan los archivos y diarios de cada entidad
+enum Tabla {
+    TABLA_ESTUDIANTES,
+    TABLA_AUTORES,
+    TABLA_EDITORIALES,
+    TABLA_LIBROS,
+    TABLA_PRESTAMOS,
+    NUM_TABLAS
+};
+
+// Resultado de una busqueda de texto por tipo de entidad, ordenado por relevancia
+struct ResultadosTexto {
+    std::vector<Acierto> libros;        // Por titulo
+    std::vector<Acierto> autores;       // Por nombre
+    std::vector<Acierto> editoriales;   // Por nombre
 };
 
 // Clase que gestiona la base de datos en memoria y operaciones CRUD/persistencia
 class BibliotecaDB {
 public:
-    // Vectores para almacenar datos en memoria
+    // Vectores para almacenar datos en memoria.
+    // Deben modificarse solo mediante los metodos agregar*/eliminar*/cargar*,
+    // que mantienen sincronizados los indices por ID.
     std::vector<Estudiante> estudiantes;  // Lista de estudiantes registrados
     std::vector<Autor> autores;           // Lista de autores registrados
     std::vector<Editorial> editoriales;   // Lista de editoriales registradas
-    std::vector<Libro> libros;            // Lista de libros registrados
-    std::vector<Prestamo> prestamos;      // Lista de prestamos registrados
+    TablaLibros libros;                   // Libros registrados, por columnas (ver Columnas.h)
+    TablaPrestamos prestamos;             // Prestamos registrados, por columnas
 
     // --- Persistencia ---
-    bool cargarDatos();                   // Carga todos los datos desde archivos CSV
-    bool guardarDatos();                  // Guarda todos los datos en archivos CSV
+    // Las cinco tablas se cargan a la vez y los archivos grandes se interpretan por trozos
+    // en paralelo (ver Paralelo.h); al final se advierte de referencias a filas inexistentes
+    bool cargarDatos();                   // Carga todos los datos desde archivos CSV (false si alguno esta danado)
+    bool guardarDatos();                  // Guarda todos los datos en archivos CSV, todos o ninguno (compacta los diarios)
+    bool guardarCambios();                // Como guardarDatos, pero solo las tablas modificadas (ver tablaModificada)
+    void setDirectorio(const std::string& dir); // Directorio de los archivos de datos (marca todas las tablas modificadas)
+    // Cada tabla cuenta sus mutaciones en memoria y recuerda la cuenta que refleja su CSV;
+    // una tabla esta modificada mientras difieren (p. ej. con cambios solo en su diario)
+    bool tablaModificada(Tabla t) const { return cambiosTabla[t] != cambiosEscritos[t]; }
+    // Una replica es una copia en memoria de otra base (ver BibliotecaConcurrente): carga los
+    // mismos archivos pero no los modifica ni muestra mensajes de las operaciones
+    void setReplica(bool r) { replica = r; }
+    // Los prestamos pueden citar estudiantes de otra base (fragmentos de BibliotecaFragmentada):
+    // cargarDatos no los valida
+    void setEstudiantesExternos(bool e) { estudiantesExternos = e; }
+    // Con f = true, prestamos.txt se escribe con registros de ancho fijo (ver Archivos.h): cada
+    // prestamo ocupa LARGO_REGISTRO bytes con la fecha de devolucion reservada aunque este
+    // vacia, asi que devolverPrestamo reescribe solo su registro con una escritura posicionada
+    // en lugar del archivo completo. Solo con escritura inmediata: con diario la devolucion ya
+    // es un registro anexado, y lotes, transacciones y escritura diferida escriben todo o nada.
+    // Por omision se escriben filas CSV de largo variable; ambos formatos se leen siempre.
+    void setPrestamosAnchoFijo(bool f) { prestamosAnchoFijo = f; }
+
+    // --- Snapshot binario (BibliotecaBinario.cpp) ---
+    // Imagen completa de las cinco tablas con cabecera versionada y checksums;
+    // los CSV siguen disponibles como formato de importacion/exportacion.
+    bool guardarDatosBinario(const std::string& archivo = "biblioteca.bin") const;
+    bool cargarDatosBinario(const std::string& archivo = "biblioteca.bin");
+    bool snapshotBinarioVigente(const std::string& archivo = "biblioteca.bin") const; // No hay CSV/diarios mas nuevos
+
+    // --- Modo diario (write-ahead log) ---
+    // Con el diario activo cada mutacion anexa un registro a <tabla>.log en lugar de
+    // reescribir el CSV; cargarDatos() aplica snapshot + diario y guardarDatos() compacta.
+    bool activarDiario(std::size_t loteSync = 64, std::size_t umbralCompactacion = 100000);
+    void desactivarDiario();              // Sincroniza y vuelve a la reescritura completa
+    bool modoDiarioActivo() const { return modoDiario; }
+    bool sincronizarDiario();             // Fuerza fsync de los registros pendientes
+
+    // --- Lotes ---
+    // Entre iniciarLote() y terminarLote() las mutaciones solo marcan su tabla como
+    // pendiente; terminarLote() escribe una vez cada tabla modificada (o sincroniza el diario).
+    void iniciarLote();
+    bool terminarLote();
+    bool loteActivo() const { return enLote; }
+
+    // --- Escritura diferida ---
+    // Como un lote sin fin: las mutaciones solo marcan su tabla como pendiente y
+    // volcarCambios() escribe una vez cada tabla pendiente. Con un intervalo, la primera
+    // mutacion (o volcarSiVencido) tras ese tiempo desde el ultimo volcado vuelca sola.
+    // Los cambios sin volcar se pierden si el programa termina sin guardar.
+    void activarEscrituraDiferida(std::chrono::milliseconds intervalo = std::chrono::milliseconds(0));
+    bool desactivarEscrituraDiferida();   // Vuelca lo pendiente y vuelve a escribir en cada mutacion
+    bool escrituraDiferidaActiva() const { return diferida; }
+    bool volcarCambios();                 // Tablas pendientes, todas o ninguna (o fsync del diario)
+    bool volcarSiVencido();               // Fuera de lotes y transacciones, si vencio el intervalo
+
+    // --- Transacciones ---
+    // Agrupan mutaciones de varias tablas. confirmarTransaccion() escribe una vez cada tabla
+    // modificada y las reemplaza en disco todas o ninguna; si la escritura falla, o con
+    // revertirTransaccion(), la memoria vuelve al estado del inicio (las filas restauradas
+    // pueden cambiar de posicion). Dentro de un lote (o con la escritura diferida),
+    // confirmar deja las tablas para la escritura final del lote (o el proximo volcado).
+    bool iniciarTransaccion();            // false si ya hay una activa
+    bool confirmarTransaccion();
+    void revertirTransaccion();
+    bool transaccionActiva() const { return enTransaccion; }
+
+    // --- Busqueda de texto ---
+    // Indice invertido sobre titulos de libros y nombres de autores y editoriales;
+    // se construye al cargar y se mantiene en agregar/actualizar/eliminar.
+    ResultadosTexto buscarTexto(std::string_view consulta, std::size_t k = 10) const;
+    void mostrarBusquedaTexto(std::string_view consulta, std::size_t k = 10) const;
+
+    // --- Autocompletado ---
+    // IDs cuyo nombre/titulo empieza por el prefijo (sin distinguir mayusculas ni acentos),
+    // en orden alfabetico; 'saltar' pide la pagina siguiente de la misma consulta.
+    std::vector<int> completarEstudiantes(std::string_view prefijo, std::size_t k = 10, std::size_t saltar = 0) const;
+    std::vector<int> completarLibros(std::string_view prefijo, std::size_t k = 10, std::size_t saltar = 0) const;
+
+    // --- Valores repetidos codificados ---
+    // Grado y nacionalidad toman pocos valores distintos: cada fila guarda el codigo de
+    // un diccionario (tambien en estudiantes.txt/autores.txt) y el texto se obtiene al mostrarlo.
+    // Los valores no se eliminan: para no registrar valores de filas rechazadas, las altas
+    // desde texto usan agregarEstudiante/agregarAutor(id, nombre, texto), y revertir una
+    // transaccion descarta los valores nuevos que trajo.
+    std::uint32_t codificarGrado(std::string_view grado);          // Lo agrega si es nuevo
+    std::string_view textoGrado(std::uint32_t codigo) const;
+    std::uint32_t codificarNacionalidad(std::string_view nacionalidad);
+    std::string_view textoNacionalidad(std::uint32_t codigo) const;
+    std::vector<std::pair<std::string_view, std::size_t>> estudiantesPorGrado() const;     // De mayor a menor
+    std::vector<std::pair<std::string_view, std::size_t>> autoresPorNacionalidad() const;  // De mayor a menor
+    void listarEstudiantesPorGrado() const;
+    void listarAutoresPorNacionalidad() const;
 
     // --- CRUD para Estudiante ---
     int nextEstudianteId() const;                         // Genera el siguiente ID unico
     bool agregarEstudiante(const Estudiante& e);          // Agrega un estudiante, valida ID unico
+    bool agregarEstudiante(int id, std::string_view nombre, std::string_view grado); // Codifica el grado si se acepta
     void listarEstudiantes() const;                       // Muestra todos los estudiantes
-    Estudiante* buscarEstudiantePorId(int id);            // Version modificable
-    const Estudiante* buscarEstudiantePorId(int id) const; // Version solo lectura
+    const Estudiante* buscarEstudiantePorId(int id) const; // Solo lectura (ver estudianteEditable)
     bool actualizarEstudiante(int id);                    // Actualiza datos de un estudiante
     bool eliminarEstudiante(int id);                      // Elimina estudiante, valida prestamos activos
 
     // --- CRUD para Autor ---
     int nextAutorId() const;                              
     bool agregarAutor(const Autor& a);                    
+    bool agregarAutor(int id, std::string_view nombre, std::string_view nacionalidad);
     void listarAutores() const;                           
-    Autor* buscarAutorPorId(int id);                      
     const Autor* buscarAutorPorId(int id) const;          
     bool actualizarAutor(int id);                         
     bool eliminarAutor(int id);                           
+    const std::vector<int>& librosDeAutor(int id_autor) const; // IDs de sus libros (indice inverso)
+    void listarLibrosPorAutor(int id_autor) const;
 
     // --- CRUD para Editorial ---
     int nextEditorialId() const;                           
     bool agregarEditorial(const Editorial& ed);           
     void listarEditoriales() const;                        
-    Editorial* buscarEditorialPorId(int id);              
     const Editorial* buscarEditorialPorId(int id) const;  
     bool actualizarEditorial(int id);                      
     bool eliminarEditorial(int id);                        
+    const std::vector<int>& librosDeEditorial(int id_editorial) const;
+    void listarLibrosPorEditorial(int id_editorial) const;
 
     // --- CRUD para Libro ---
     int nextLibroId() const;                               
     bool agregarLibro(const Libro& l);                     
     void listarLibros() const;                              
-    Libro* buscarLibroPorId(int id);                       
-    const Libro* buscarLibroPorId(int id) const;           
+    std::optional<Libro> buscarLibroPorId(int id) const;   // Copia de la fila (la tabla es por columnas)
+    std::optional<Libro> buscarLibroPorIsbn(std::string_view isbn) const; // Acepta guiones, ISBN-10 o ISBN-13
     bool actualizarLibro(int id);                           
     bool eliminarLibro(int id);                             
+    std::vector<std::pair<int, std::size_t>> librosPorAnio() const; // (ano, cantidad) ordenado por ano
+    std::vector<int> librosEntreAnios(int desde, int hasta) const;   // IDs publicados en [desde, hasta]
+    void listarLibrosPorAnio() const;
 
     // --- Gestion de Prestamos ---
     int nextPrestamoId() const;                              
-    bool prestarLibro(int id_libro, int id_estudiante, const std::string& fecha_prestamo); 
-    bool devolverPrestamo(int id_prestamo);                 
+    bool prestarLibro(int id_libro, int id_estudiante, Fecha fecha_prestamo); 
+    bool agregarPrestamo(const Prestamo& p);                // Con ID y fechas dados; no valida al estudiante
+    bool devolverPrestamo(int id_prestamo, Fecha fecha_devolucion = Fecha::hoy());
     void listarPrestamos(bool soloActivos = false) const;   
     void listarPrestamosPorEstudiante(int id_estudiante) const; 
-    Prestamo* buscarPrestamoPorId(int id);                  
-    const Prestamo* buscarPrestamoPorId(int id) const;      
+    std::vector<Prestamo> prestamosEntre(Fecha desde, Fecha hasta) const; // Prestados en [desde, hasta]
+    const std::vector<int>& prestamosDeEstudiante(int id_estudiante) const; // IDs de sus prestamos
+    void listarPrestamosEntre(Fecha desde, Fecha hasta) const;
+    std::optional<Prestamo> buscarPrestamoPorId(int id) const;
+    int prestamoActivoDeLibro(int id_libro) const;          // ID del prestamo activo del libro, 0 si esta libre
     std::string fechaHoy() const;                            
 
+    // --- Memoria de textos ---
+    // Copia los nombres vivos a arenas nuevas y compacta los titulos; se hace solo
+    // cuando el espacio sin uso supera la mitad, o al llamarlo directamente.
+    void compactarTextos();
+    std::size_t bytesTextos() const;          // Bytes reservados por arenas y titulos (incluye sin uso)
+
 private:
+    // --- Indices por clave primaria (ID -> posicion en el vector) ---
+    std::unordered_map<int, std::size_t> indiceEstudiantes;
+    std::unordered_map<int, std::size_t> indiceAutores;
+    std::unordered_map<int, std::size_t> indiceEditoriales;
+    std::unordered_map<int, std::size_t> indiceLibros;
+    std::unordered_map<int, std::size_t> indicePrestamos;
+    void reconstruirIndices();                // Recalcula todos los indices desde los vectores
+    void reconstruirIndicesDerivados();       // Secundarios y de texto, en paralelo (no los de ID), y los mayores IDs
+    int maxEstudianteId = 0;                  // Mayores IDs registrados (como maxLibroId)
+    int maxAutorId = 0;
+    int maxEditorialId = 0;
+    std::unordered_map<std::uint64_t, int> indiceIsbn; // Isbn::valor -> ID de libro
+    std::unordered_map<int, std::vector<int>> librosPorAutor;     // ID autor -> IDs de sus libros
+    std::unordered_map<int, std::vector<int>> librosPorEditorial; // ID editorial -> IDs de sus libros
+    int maxLibroId = 0;                       // Mayor ID de libro registrado
+    void reconstruirIndicesLibros();          // Indices de libros por ISBN, autor y editorial, y maxLibroId
+    void listarLibrosDe(const std::vector<int>& ids) const;
+    std::string_view tituloLibro(int id) const;   // Titulo sin copiar la fila, "Desconocido" si no existe
+
+    // --- Indices secundarios de prestamos ---
+    std::unordered_map<int, int> prestamoActivoPorLibro;               // ID libro -> ID prestamo activo
+    std::unordered_map<int, std::vector<int>> prestamosPorEstudiante;  // ID estudiante -> IDs de sus prestamos
+    std::unordered_set<int> prestamosActivos;                          // IDs de prestamos sin devolver
+    int maxPrestamoId = 0;                                             // Mayor ID de prestamo registrado
+    void indexarPrestamo(const Prestamo& p);
+    void reconstruirIndicesPrestamos();
+
+    // --- Indices de texto ---
+    IndiceTexto textoLibros;                  // Libro::titulo
+    IndiceTexto textoAutores;                 // Autor::nombre
+    IndiceTexto textoEditoriales;             // Editorial::nombre
+    IndicePrefijos prefijosEstudiantes;       // Estudiante::nombre
+    IndicePrefijos prefijosLibros;            // Libro::titulo
+    void reconstruirIndicesTexto();           // Tambien los de autocompletado
+
+    // --- Arenas de textos (una por tabla con nombres; los titulos viven en TablaLibros) ---
+    ArenaTextos textosEstudiantes;            // Estudiante::nombre
+    ArenaTextos textosAutores;                // Autor::nombre
+    ArenaTextos textosEditoriales;            // Editorial::nombre
+    void compactarTextosSiConviene();         // Tras actualizar o eliminar
+    // Filas modificables, solo para los actualizar*: un nombre asignado por fuera de ellos
+    // no quedaria en su arena ni en los indices de texto
+    Estudiante* estudianteEditable(int id);
+    Autor* autorEditable(int id);
+    Editorial* editorialEditable(int id);
+
+    // --- Diccionarios de valores repetidos ---
+    Diccionario grados;                       // Estudiante::grado
+    Diccionario nacionalidades;               // Autor::nacionalidad
+
+    std::string directorio;                   // Prefijo de ruta de los archivos de datos
+    std::string ruta(const char* archivo) const; // directorio + nombre de archivo
+    bool replica = false;
+    bool estudiantesExternos = false;
+    std::ostream& mensajes() const;           // std::cout, o una salida nula en una replica
+
+    // --- Diario ---
+    bool modoDiario = false;                  // true si las mutaciones se anexan al diario
+    std::size_t umbralCompactacion = 100000;  // Registros tras los que se compacta una tabla
+    Diario diarios[NUM_TABLAS];               // Un diario por tabla
+    bool enLote = false;                      // true entre iniciarLote() y terminarLote()
+    bool diferida = false;                    // true con la escritura diferida activa
+    std::chrono::milliseconds intervaloVolcado{0};          // 0: solo se vuelca al pedirlo
+    std::chrono::steady_clock::time_point ultimoVolcado;
+    bool tablaPendiente[NUM_TABLAS] = {};     // Tablas sin escribir del lote o de la escritura diferida
+    std::uint64_t cambiosTabla[NUM_TABLAS] = {};     // Mutaciones aplicadas a cada tabla en memoria
+    std::uint64_t cambiosEscritos[NUM_TABLAS] = {};  // Valor de cambiosTabla que refleja su CSV
+    bool persistir(Tabla t, char operacion, const std::string& fila); // Diario o reescritura completa
+    bool guardarTabla(Tabla t);               // Escribe el CSV de la tabla y vacia su diario
+    bool reproducirDiarios();                 // Aplica los diarios sobre los datos cargados
+    void aplicarRegistros(Tabla t, const std::vector<RegistroDiario>& registros); // Altas y bajas por fila
+
+    // --- Escritura atomica de varias tablas ---
+    bool escribirTablas(const bool tablas[NUM_TABLAS]);      // Temporales + registro de confirmacion
+    bool completarEscritura(const bool tablas[NUM_TABLAS]);  // Renombra los temporales confirmados
+    void recuperarEscritura();                // Completa o descarta una escritura interrumpida
+    void descartarTemporales() const;
+    bool guardarTablaEn(Tabla t, const std::string& archivo, bool* enRegistros = nullptr) const;
+    std::uint64_t generacion = 0;             // Ultima generacion escrita o leida de los CSV
+    std::uint64_t generacionLeida[NUM_TABLAS] = {}; // Por tabla: las tablas se cargan en paralelo
+    // Lee el CSV verificado; ante un checksum invalido recurre a la generacion anterior.
+    // Con 'interrumpidos', una devolucion a medio escribir no invalida el archivo (ver leerVerificado)
+    EstadoArchivo leerTabla(Tabla t, std::string& buffer, std::string_view& contenido,
+                            std::vector<std::size_t>* interrumpidos = nullptr);
+    void validarReferencias() const;          // Advierte de autores, editoriales, libros o estudiantes inexistentes (y de ISBN incorrectos)
+
+    // --- Transacciones ---
+    struct ImagenFila {
+        Tabla tabla;
+        int id;
+        std::optional<std::string> fila;      // Fila CSV previa; sin valor si no existia
+    };
+    bool enTransaccion = false;
+    std::size_t gradosAlIniciar = 0;          // Valores de los diccionarios al iniciar la transaccion
+    std::size_t nacionalidadesAlIniciar = 0;
+    bool tablaTransaccion[NUM_TABLAS] = {};   // Tablas modificadas en la transaccion
+    std::vector<ImagenFila> deshacer;         // Imagen previa de cada fila modificada
+    std::unordered_set<int> filasRecordadas[NUM_TABLAS]; // IDs que ya tienen imagen
+    void recordarFila(Tabla t, int id);       // Llamar antes de modificar una fila
+    std::optional<std::string> filaActual(Tabla t, int id) const;
+    void terminarTransaccion();
+
     // --- Persistencia por entidad ---
-    bool guardarEstudiantes() const;      
+    bool guardarEstudiantes(const std::string& archivo) const;      
     bool cargarEstudiantes();             
-    bool guardarAutores() const;          
+    bool guardarAutores(const std::string& archivo) const;          
     bool cargarAutores();                 
-    bool guardarEditoriales() const;      
+    bool guardarEditoriales(const std::string& archivo) const;      
     bool cargarEditoriales();             
-    bool guardarLibros() const;           
+    bool guardarLibros(const std::string& archivo) const;           
     bool cargarLibros();                  
-    bool guardarPrestamos() const;        
+    // 'enRegistros' recibe el formato escrito: true si son registros de ancho fijo
+    bool guardarPrestamos(const std::string& archivo, bool* enRegistros = nullptr) const;
     bool cargarPrestamos();               
+    bool prestamosAnchoFijo = false;          // guardarPrestamos escribe registros de ancho fijo
+    bool prestamosEnRegistros = false;        // prestamos.txt tiene un registro fijo por fila, en el orden de la memoria
+    bool prestamosPorReescribir = false;      // cargarPrestamos no pudo reparar prestamos.txt en su lugar
+    bool devolverEnLugar(std::size_t pos);    // Reescribe la fecha de devolucion de un registro
+    bool reescribirDevolucion(std::size_t pos) const; // Fecha de devolucion y sello del registro, con fsync
+
+    // --- Conversion fila CSV <-> entidad ---
+    std::string filaEstudiante(const Estudiante& e) const;
+    std::string filaAutor(const Autor& a) const;
+    std::string filaEditorial(const Editorial& ed) const;
+    std::string filaLibro(const Libro& l) const;
+    std::string filaPrestamo(const Prestamo& p) const;
+    bool registroPrestamo(const Prestamo& p, char* registro) const; // LARGO_REGISTRO bytes; false si no cabe
+    // Con 'codigos' la tercera columna es un codigo del archivo (ver guardarEstudiantes); sin el, texto
+    // Los nombres se copian a la arena de su tabla
+    bool parsearEstudiante(std::string_view linea, Estudiante& e, const std::vector<std::uint32_t>* codigos = nullptr);
+    bool parsearAutor(std::string_view linea, Autor& a, const std::vector<std::uint32_t>* codigos = nullptr);
+    bool parsearEditorial(std::string_view linea, Editorial& ed);
+    // El titulo queda en 'espacio' o en la propia linea: debe copiarse antes de reutilizarlos
+    bool parsearLibro(std::string_view linea, Libro& l, std::string& espacio) const;
+    bool parsearPrestamo(std::string_view linea, Prestamo& p) const;
 
     // --- Manejo CSV ---
-    std::vector<std::string> splitLine(const std::string& s, char delimiter) const; 
-    std::string escapeField(const std::string& s) const; 
-    std::string unescapeField(const std::string& s) const; 
+    std::string escapeField(std::string_view s) const; 
 };
 
 #endif // BIBLIOTECA_H
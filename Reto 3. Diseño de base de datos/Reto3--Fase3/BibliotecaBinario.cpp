@@ -0,0 +1,469 @@
+#include "Biblioteca.h"
+#include "LectorCSV.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+// --- Snapshot binario ---
+//
+// Formato (enteros little-endian de ancho fijo, secciones alineadas a 8 bytes):
+//   Cabecera: magic "BIBLIODB", version (u32), marca de orden de bytes (u32),
+//             por tabla {filas, desplazamiento, bytes, checksum} (u64 x 4),
+//             checksum de la cabecera (u64).
+//   Tabla:    columnas enteras como arreglos int32[filas] (u64[filas] para el ISBN);
+//             columnas de texto como desplazamientos u64[filas + 1] seguidos del heap.
+// Las columnas se escriben en el orden de los campos de cada struct. Los campos codificados
+// (grado, nacionalidad) son columnas int32 de códigos seguidas, al final de la tabla, de su
+// diccionario: cantidad de valores (int32[1]) y columna de texto con los valores.
+
+namespace {
+
+const char MAGIC[8] = {'B', 'I', 'B', 'L', 'I', 'O', 'D', 'B'};
+// v2: fechas de préstamo como días (int32); v3: ISBN empaquetado (u64); v4: grado y nacionalidad codificados
+const std::uint32_t VERSION = 4;
+const std::uint32_t MARCA_ORDEN = 0x01020304; // Detecta archivos de otra arquitectura
+
+// Descriptor de una tabla dentro del archivo
+struct SeccionTabla {
+    std::uint64_t filas;
+    std::uint64_t desplazamiento;
+    std::uint64_t bytes;
+    std::uint64_t checksum;
+};
+
+struct Cabecera {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t marcaOrden;
+    SeccionTabla tablas[NUM_TABLAS];
+    std::uint64_t checksumCabecera; // Checksum de todos los campos anteriores
+};
+
+// Checksum de 64 bits que procesa 8 bytes por paso (variante de FNV-1a por palabras)
+std::uint64_t checksum64(const char* datos, std::size_t n) {
+    const std::uint64_t primo = 0x100000001b3ULL;
+    std::uint64_t h = 0xcbf29ce484222325ULL ^ n;
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        std::uint64_t w;
+        std::memcpy(&w, datos + i, 8);
+        h = (h ^ w) * primo;
+        h ^= h >> 29;
+    }
+    for (; i < n; ++i) {
+        h = (h ^ static_cast<unsigned char>(datos[i])) * primo;
+    }
+    return h;
+}
+
+// Acumula columnas en un buffer contiguo
+class EscritorBinario {
+public:
+    std::string buffer;
+
+    void alinear() {
+        buffer.resize((buffer.size() + 7) & ~static_cast<std::size_t>(7), '\0');
+    }
+
+    // Escribe una columna int32 extraída de cada fila
+    template <typename T, typename Campo>
+    void columnaEntera(const std::vector<T>& filas, Campo campo) {
+        alinear();
+        std::size_t inicio = buffer.size();
+        buffer.resize(inicio + filas.size() * sizeof(std::int32_t));
+        char* destino = &buffer[inicio];
+        for (const auto& f : filas) {
+            std::int32_t v = campo(f);
+            std::memcpy(destino, &v, sizeof(v));
+            destino += sizeof(v);
+        }
+    }
+
+    // Escribe una columna u64 extraída de cada fila
+    template <typename T, typename Campo>
+    void columnaEntera64(const std::vector<T>& filas, Campo campo) {
+        alinear();
+        std::size_t inicio = buffer.size();
+        buffer.resize(inicio + filas.size() * sizeof(std::uint64_t));
+        char* destino = &buffer[inicio];
+        for (const auto& f : filas) {
+            std::uint64_t v = campo(f);
+            std::memcpy(destino, &v, sizeof(v));
+            destino += sizeof(v);
+        }
+    }
+
+    // Escribe una columna de texto: desplazamientos y heap de caracteres
+    template <typename T, typename Campo>
+    void columnaTexto(const std::vector<T>& filas, Campo campo) {
+        alinear();
+        std::size_t inicioOffsets = buffer.size();
+        buffer.resize(inicioOffsets + (filas.size() + 1) * sizeof(std::uint64_t));
+        std::uint64_t total = 0;
+        std::size_t i = 0;
+        std::string heap;
+        for (const auto& f : filas) {
+            std::string_view s = campo(f);
+            std::memcpy(&buffer[inicioOffsets + i++ * sizeof(std::uint64_t)], &total, sizeof(total));
+            heap.append(s.data(), s.size());
+            total += s.size();
+        }
+        std::memcpy(&buffer[inicioOffsets + i * sizeof(std::uint64_t)], &total, sizeof(total));
+        buffer += heap;
+    }
+
+    // Escribe una ColumnaTexto de las tablas por columnas con el mismo formato
+    void columnaTexto(const ColumnaTexto& columna) {
+        // El bloque de la columna puede tener huecos: se copian los textos en orden de fila
+        textosPorPosicion(columna.size(), [&](std::size_t i) { return columna[i]; });
+    }
+
+    // Escribe un diccionario: su cantidad de valores y los valores en orden de código
+    void diccionario(const Diccionario& dic) {
+        alinear();
+        std::int32_t n = static_cast<std::int32_t>(dic.size());
+        buffer.append(reinterpret_cast<const char*>(&n), sizeof(n));
+        textosPorPosicion(dic.size(), [&](std::size_t i) { return dic.texto(static_cast<std::uint32_t>(i)); });
+    }
+
+private:
+    // Columna de texto a partir de una función posición -> std::string_view
+    template <typename TextoEn>
+    void textosPorPosicion(std::size_t filas, TextoEn texto) {
+        alinear();
+        std::size_t inicioOffsets = buffer.size();
+        buffer.resize(inicioOffsets + (filas + 1) * sizeof(std::uint64_t));
+        std::uint64_t total = 0;
+        for (std::size_t i = 0; i < filas; ++i) {
+            std::memcpy(&buffer[inicioOffsets + i * sizeof(std::uint64_t)], &total, sizeof(total));
+            total += texto(i).size();
+        }
+        std::memcpy(&buffer[inicioOffsets + filas * sizeof(std::uint64_t)], &total, sizeof(total));
+        buffer.reserve(buffer.size() + total);
+        for (std::size_t i = 0; i < filas; ++i) buffer += texto(i);
+    }
+};
+
+// Recorre las columnas de una sección validando que no se salgan de sus límites
+class LectorBinario {
+public:
+    LectorBinario(const char* datos, std::size_t bytes) : base(datos), fin(bytes) {}
+
+    bool alinear() {
+        pos = (pos + 7) & ~static_cast<std::size_t>(7);
+        return pos <= fin;
+    }
+
+    // Retorna puntero a 'filas' enteros int32 consecutivos, o nullptr si no caben
+    const char* columnaEntera(std::size_t filas) {
+        if (!alinear() || filas * sizeof(std::int32_t) > fin - pos) return nullptr;
+        const char* p = base + pos;
+        pos += filas * sizeof(std::int32_t);
+        return p;
+    }
+
+    // Retorna puntero a 'filas' enteros u64 consecutivos, o nullptr si no caben
+    const char* columnaEntera64(std::size_t filas) {
+        if (!alinear() || filas * sizeof(std::uint64_t) > fin - pos) return nullptr;
+        const char* p = base + pos;
+        pos += filas * sizeof(std::uint64_t);
+        return p;
+    }
+
+    // Ubica los desplazamientos y el heap de una columna de texto
+    bool columnaTexto(std::size_t filas, const char*& offsets, const char*& heap, std::uint64_t& heapBytes) {
+        if (!alinear() || (filas + 1) * sizeof(std::uint64_t) > fin - pos) return false;
+        offsets = base + pos;
+        pos += (filas + 1) * sizeof(std::uint64_t);
+        std::memcpy(&heapBytes, offsets + filas * sizeof(std::uint64_t), sizeof(heapBytes));
+        if (heapBytes > fin - pos) return false;
+        heap = base + pos;
+        pos += heapBytes;
+        return true;
+    }
+
+private:
+    const char* base;
+    std::size_t fin;
+    std::size_t pos = 0;
+};
+
+std::int32_t enteroEn(const char* columna, std::size_t i) {
+    std::int32_t v;
+    std::memcpy(&v, columna + i * sizeof(v), sizeof(v));
+    return v;
+}
+
+std::uint64_t entero64En(const char* columna, std::size_t i) {
+    std::uint64_t v;
+    std::memcpy(&v, columna + i * sizeof(v), sizeof(v));
+    return v;
+}
+
+// Vista de la cadena i de una columna de texto; falla si los desplazamientos son incoherentes
+bool textoEn(const char* offsets, const char* heap, std::uint64_t heapBytes, std::size_t i, std::string_view& destino) {
+    std::uint64_t a, b;
+    std::memcpy(&a, offsets + i * sizeof(a), sizeof(a));
+    std::memcpy(&b, offsets + (i + 1) * sizeof(b), sizeof(b));
+    if (a > b || b > heapBytes) return false;
+    destino = std::string_view(heap + a, static_cast<std::size_t>(b - a));
+    return true;
+}
+
+// Lee un diccionario escrito por EscritorBinario::diccionario, agregando sus valores a 'dic'
+// y dejando en 'codigos' el código en memoria de cada código del archivo
+bool diccionarioEn(LectorBinario& r, Diccionario& dic, std::vector<std::uint32_t>& codigos) {
+    const char* cantidad = r.columnaEntera(1);
+    if (!cantidad || enteroEn(cantidad, 0) < 0) return false;
+    std::size_t n = static_cast<std::size_t>(enteroEn(cantidad, 0));
+    const char* offsets = nullptr;
+    const char* heap = nullptr;
+    std::uint64_t heapBytes = 0;
+    if (!r.columnaTexto(n, offsets, heap, heapBytes)) return false;
+    std::string_view texto;
+    codigos.clear();
+    for (std::size_t i = 0; i < n; ++i) {
+        if (!textoEn(offsets, heap, heapBytes, i, texto)) return false;
+        codigos.push_back(dic.codificar(texto));
+    }
+    return true;
+}
+
+// Traduce la columna de códigos del archivo a códigos en memoria; falla ante un código inexistente
+bool codigoEn(const char* columna, std::size_t i, const std::vector<std::uint32_t>& codigos, std::uint32_t& codigo) {
+    std::int32_t c = enteroEn(columna, i);
+    if (c < 0 || static_cast<std::size_t>(c) >= codigos.size()) return false;
+    codigo = codigos[static_cast<std::size_t>(c)];
+    return true;
+}
+
+} // namespace
+
+// Escribe las cinco tablas en un único archivo binario
+bool BibliotecaDB::guardarDatosBinario(const std::string& archivo) const {
+    EscritorBinario tablas[NUM_TABLAS];
+    tablas[TABLA_ESTUDIANTES].columnaEntera(estudiantes, [](const Estudiante& e) { return e.id; });
+    tablas[TABLA_ESTUDIANTES].columnaTexto(estudiantes, [](const Estudiante& e) { return e.nombre; });
+    tablas[TABLA_ESTUDIANTES].columnaEntera(estudiantes, [](const Estudiante& e) { return e.grado; });
+    tablas[TABLA_ESTUDIANTES].diccionario(grados);
+    tablas[TABLA_AUTORES].columnaEntera(autores, [](const Autor& a) { return a.id; });
+    tablas[TABLA_AUTORES].columnaTexto(autores, [](const Autor& a) { return a.nombre; });
+    tablas[TABLA_AUTORES].columnaEntera(autores, [](const Autor& a) { return a.nacionalidad; });
+    tablas[TABLA_AUTORES].diccionario(nacionalidades);
+    tablas[TABLA_EDITORIALES].columnaEntera(editoriales, [](const Editorial& ed) { return ed.id; });
+    tablas[TABLA_EDITORIALES].columnaTexto(editoriales, [](const Editorial& ed) { return ed.nombre; });
+    // Libros y préstamos ya están en memoria por columnas: se copian columna a columna
+    auto entero = [](int v) { return v; };
+    auto dias = [](Fecha f) { return f.dias; };
+    tablas[TABLA_LIBROS].columnaEntera(libros.ids(), entero);
+    tablas[TABLA_LIBROS].columnaTexto(libros.titulos());
+    tablas[TABLA_LIBROS].columnaEntera64(libros.isbns(), [](Isbn i) { return i.valor; });
+    tablas[TABLA_LIBROS].columnaEntera(libros.anios(), entero);
+    tablas[TABLA_LIBROS].columnaEntera(libros.idsAutor(), entero);
+    tablas[TABLA_LIBROS].columnaEntera(libros.idsEditorial(), entero);
+    tablas[TABLA_PRESTAMOS].columnaEntera(prestamos.ids(), entero);
+    tablas[TABLA_PRESTAMOS].columnaEntera(prestamos.idsLibro(), entero);
+    tablas[TABLA_PRESTAMOS].columnaEntera(prestamos.idsEstudiante(), entero);
+    tablas[TABLA_PRESTAMOS].columnaEntera(prestamos.fechasPrestamo(), dias);
+    tablas[TABLA_PRESTAMOS].columnaEntera(prestamos.fechasDevolucion(), dias);
+
+    const std::size_t filas[NUM_TABLAS] = {estudiantes.size(), autores.size(), editoriales.size(), libros.size(),
+                                           prestamos.size()};
+    Cabecera cab{};
+    std::memcpy(cab.magic, MAGIC, sizeof(MAGIC));
+    cab.version = VERSION;
+    cab.marcaOrden = MARCA_ORDEN;
+    std::uint64_t desplazamiento = sizeof(Cabecera);
+    for (int t = 0; t < NUM_TABLAS; ++t) {
+        tablas[t].alinear();
+        const std::string& b = tablas[t].buffer;
+        cab.tablas[t] = {filas[t], desplazamiento, b.size(), checksum64(b.data(), b.size())};
+        desplazamiento += b.size();
+    }
+    cab.checksumCabecera = checksum64(reinterpret_cast<const char*>(&cab), offsetof(Cabecera, checksumCabecera));
+
+    // Se escribe a un temporal con fsync y se renombra: el snapshot anterior sigue completo
+    // hasta que el nuevo lo está
+    std::string destino = ruta(archivo.c_str());
+    std::string temporal = destino + ".tmp";
+    ArchivoSalida salida;
+    if (!salida.abrir(temporal)) {
+        std::cout << "Error al abrir " << archivo << " para guardar.\n";
+        return false;
+    }
+    std::ostream file(&salida);
+    file.write(reinterpret_cast<const char*>(&cab), sizeof(cab));
+    for (const auto& t : tablas) file.write(t.buffer.data(), static_cast<std::streamsize>(t.buffer.size()));
+    if (!salida.cerrar() || !reemplazarArchivo(temporal, destino)) {
+        std::remove(temporal.c_str());
+        return false;
+    }
+    return sincronizarDirectorio(destino);
+}
+
+// Carga las cinco tablas desde un archivo binario; no modifica nada si el archivo es inválido
+bool BibliotecaDB::cargarDatosBinario(const std::string& archivo) {
+    std::string datos;
+    if (!csv::leerArchivo(ruta(archivo.c_str()), datos)) {
+        std::cout << "Error al abrir " << archivo << ".\n";
+        return false;
+    }
+    Cabecera cab;
+    if (datos.size() < sizeof(cab)) {
+        std::cout << "Error: " << archivo << " incompleto.\n";
+        return false;
+    }
+    std::memcpy(&cab, datos.data(), sizeof(cab));
+    if (std::memcmp(cab.magic, MAGIC, sizeof(MAGIC)) != 0 || cab.version != VERSION || cab.marcaOrden != MARCA_ORDEN) {
+        std::cout << "Error: " << archivo << " no es un snapshot compatible.\n";
+        return false;
+    }
+    if (cab.checksumCabecera != checksum64(datos.data(), offsetof(Cabecera, checksumCabecera))) {
+        std::cout << "Error: cabecera de " << archivo << " corrupta.\n";
+        return false;
+    }
+    for (const auto& s : cab.tablas) {
+        if (s.desplazamiento > datos.size() || s.bytes > datos.size() - s.desplazamiento ||
+            checksum64(datos.data() + s.desplazamiento, s.bytes) != s.checksum) {
+            std::cout << "Error: checksum invalido en " << archivo << ".\n";
+            return false;
+        }
+    }
+
+    // Los nombres se copian del buffer del archivo a arenas nuevas, que reemplazan a las actuales
+    std::vector<Estudiante> nEstudiantes;
+    ArenaTextos nTextosEstudiantes, nTextosAutores, nTextosEditoriales;
+    std::string_view texto;
+    Diccionario nGrados, nNacionalidades;
+    std::vector<std::uint32_t> codigos;
+    std::vector<Autor> nAutores;
+    std::vector<Editorial> nEditoriales;
+    TablaLibros nLibros;
+    TablaPrestamos nPrestamos;
+    bool ok = true;
+    const char* o1 = nullptr;
+    const char* h1 = nullptr;
+    std::uint64_t b1 = 0;
+    {
+        const SeccionTabla& s = cab.tablas[TABLA_ESTUDIANTES];
+        LectorBinario r(datos.data() + s.desplazamiento, s.bytes);
+        const char* ids = r.columnaEntera(s.filas);
+        const char* gradosCol = ids && r.columnaTexto(s.filas, o1, h1, b1) ? r.columnaEntera(s.filas) : nullptr;
+        ok = gradosCol && diccionarioEn(r, nGrados, codigos);
+        nEstudiantes.resize(ok ? s.filas : 0);
+        nTextosEstudiantes.reservar(ok ? static_cast<std::size_t>(b1) : 0);
+        for (std::size_t i = 0; ok && i < s.filas; ++i) {
+            nEstudiantes[i].id = enteroEn(ids, i);
+            ok = textoEn(o1, h1, b1, i, texto) && codigoEn(gradosCol, i, codigos, nEstudiantes[i].grado);
+            nEstudiantes[i].nombre = nTextosEstudiantes.guardar(texto);
+        }
+    }
+    if (ok) {
+        const SeccionTabla& s = cab.tablas[TABLA_AUTORES];
+        LectorBinario r(datos.data() + s.desplazamiento, s.bytes);
+        const char* ids = r.columnaEntera(s.filas);
+        const char* nacionalidadesCol = ids && r.columnaTexto(s.filas, o1, h1, b1) ? r.columnaEntera(s.filas) : nullptr;
+        ok = nacionalidadesCol && diccionarioEn(r, nNacionalidades, codigos);
+        nAutores.resize(ok ? s.filas : 0);
+        nTextosAutores.reservar(ok ? static_cast<std::size_t>(b1) : 0);
+        for (std::size_t i = 0; ok && i < s.filas; ++i) {
+            nAutores[i].id = enteroEn(ids, i);
+            ok = textoEn(o1, h1, b1, i, texto) && codigoEn(nacionalidadesCol, i, codigos, nAutores[i].nacionalidad);
+            nAutores[i].nombre = nTextosAutores.guardar(texto);
+        }
+    }
+    if (ok) {
+        const SeccionTabla& s = cab.tablas[TABLA_EDITORIALES];
+        LectorBinario r(datos.data() + s.desplazamiento, s.bytes);
+        const char* ids = r.columnaEntera(s.filas);
+        ok = ids && r.columnaTexto(s.filas, o1, h1, b1);
+        nEditoriales.resize(ok ? s.filas : 0);
+        nTextosEditoriales.reservar(ok ? static_cast<std::size_t>(b1) : 0);
+        for (std::size_t i = 0; ok && i < s.filas; ++i) {
+            nEditoriales[i].id = enteroEn(ids, i);
+            ok = textoEn(o1, h1, b1, i, texto);
+            nEditoriales[i].nombre = nTextosEditoriales.guardar(texto);
+        }
+    }
+    if (ok) {
+        const SeccionTabla& s = cab.tablas[TABLA_LIBROS];
+        LectorBinario r(datos.data() + s.desplazamiento, s.bytes);
+        const char* ids = r.columnaEntera(s.filas);
+        ok = ids && r.columnaTexto(s.filas, o1, h1, b1);
+        const char* isbns = ok ? r.columnaEntera64(s.filas) : nullptr;
+        const char* anios = isbns ? r.columnaEntera(s.filas) : nullptr;
+        const char* autoresCol = anios ? r.columnaEntera(s.filas) : nullptr;
+        const char* editorialesCol = autoresCol ? r.columnaEntera(s.filas) : nullptr;
+        ok = editorialesCol != nullptr;
+        nLibros.reserve(ok ? s.filas : 0);
+        Libro l;
+        for (std::size_t i = 0; ok && i < s.filas; ++i) {
+            l.id = enteroEn(ids, i);
+            l.anio = enteroEn(anios, i);
+            l.id_autor = enteroEn(autoresCol, i);
+            l.id_editorial = enteroEn(editorialesCol, i);
+            l.isbn.valor = entero64En(isbns, i);
+            ok = textoEn(o1, h1, b1, i, l.titulo);
+            if (ok) nLibros.push_back(l);
+        }
+    }
+    if (ok) {
+        const SeccionTabla& s = cab.tablas[TABLA_PRESTAMOS];
+        LectorBinario r(datos.data() + s.desplazamiento, s.bytes);
+        const char* ids = r.columnaEntera(s.filas);
+        const char* librosCol = ids ? r.columnaEntera(s.filas) : nullptr;
+        const char* estudiantesCol = librosCol ? r.columnaEntera(s.filas) : nullptr;
+        const char* prestadoCol = estudiantesCol ? r.columnaEntera(s.filas) : nullptr;
+        const char* devueltoCol = prestadoCol ? r.columnaEntera(s.filas) : nullptr;
+        ok = devueltoCol != nullptr;
+        nPrestamos.reserve(ok ? s.filas : 0);
+        Prestamo p;
+        for (std::size_t i = 0; ok && i < s.filas; ++i) {
+            p.id = enteroEn(ids, i);
+            p.id_libro = enteroEn(librosCol, i);
+            p.id_estudiante = enteroEn(estudiantesCol, i);
+            p.fecha_prestamo.dias = enteroEn(prestadoCol, i);
+            p.fecha_devolucion.dias = enteroEn(devueltoCol, i);
+            nPrestamos.push_back(p);
+        }
+    }
+    if (!ok) {
+        std::cout << "Error: estructura invalida en " << archivo << ".\n";
+        return false;
+    }
+
+    estudiantes = std::move(nEstudiantes);
+    textosEstudiantes = std::move(nTextosEstudiantes);
+    textosAutores = std::move(nTextosAutores);
+    textosEditoriales = std::move(nTextosEditoriales);
+    autores = std::move(nAutores);
+    grados = std::move(nGrados);
+    nacionalidades = std::move(nNacionalidades);
+    editoriales = std::move(nEditoriales);
+    libros = std::move(nLibros);
+    prestamos = std::move(nPrestamos);
+    reconstruirIndices();
+    // Los CSV pueden ser de otra generación que el snapshot
+    for (auto& cambios : cambiosTabla) ++cambios;
+    return true;
+}
+
+// Indica si el snapshot binario existe y es al menos tan reciente como los CSV y diarios
+bool BibliotecaDB::snapshotBinarioVigente(const std::string& archivo) const {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    auto tBinario = fs::last_write_time(ruta(archivo.c_str()), ec);
+    if (ec) return false;
+    for (const char* nombre : {"estudiantes.txt", "autores.txt", "editoriales.txt", "libros.txt", "prestamos.txt",
+                               "estudiantes.log", "autores.log", "editoriales.log", "libros.log", "prestamos.log"}) {
+        std::string r = ruta(nombre);
+        if (!fs::exists(r, ec)) continue;
+        // Un diario vacío no aporta cambios aunque se haya truncado después
+        if (fs::path(r).extension() == ".log" && fs::file_size(r, ec) == 0) continue;
+        if (fs::last_write_time(r, ec) > tBinario) return false;
+    }
+    return true;
+}
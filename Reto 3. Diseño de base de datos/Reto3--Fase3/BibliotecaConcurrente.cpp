@@ -0,0 +1,68 @@
+#include "BibliotecaConcurrente.h"
+#include <thread>
+
+BibliotecaConcurrente::BibliotecaConcurrente() {
+    copias[1 - PRINCIPAL].setReplica(true);
+}
+
+void BibliotecaConcurrente::setDirectorio(const std::string& dir) {
+    for (auto& c : copias) c.setDirectorio(dir);
+}
+
+// La principal carga primero: completa escrituras interrumpidas y aparta archivos dañados,
+// así la réplica lee exactamente los mismos datos
+bool BibliotecaConcurrente::cargarDatos() {
+    std::lock_guard<std::mutex> lock(escritura);
+    bool ok = copias[PRINCIPAL].cargarDatos();
+    copias[1 - PRINCIPAL].cargarDatos();
+    return ok;
+}
+
+bool BibliotecaConcurrente::cargarDatosBinario(const std::string& archivo) {
+    std::lock_guard<std::mutex> lock(escritura);
+    return copias[PRINCIPAL].cargarDatosBinario(archivo) && copias[1 - PRINCIPAL].cargarDatosBinario(archivo);
+}
+
+// Guardar solo lee las tablas de la principal, así que los lectores pueden seguir usándola
+bool BibliotecaConcurrente::guardarDatos() {
+    std::lock_guard<std::mutex> lock(escritura);
+    return copias[PRINCIPAL].guardarDatos();
+}
+
+bool BibliotecaConcurrente::configurar(const std::function<bool(BibliotecaDB&)>& f) {
+    std::lock_guard<std::mutex> lock(escritura);
+    return f(copias[PRINCIPAL]);
+}
+
+// Cada hilo usa siempre la misma ranura (elegida por su ID) para repartir los contadores
+std::size_t BibliotecaConcurrente::ranuraDelHilo() {
+    thread_local const std::size_t ranura = std::hash<std::thread::id>{}(std::this_thread::get_id()) % RANURAS;
+    return ranura;
+}
+
+BibliotecaConcurrente::Lectura::Lectura(const BibliotecaConcurrente& b)
+    : contador(b.contadores[b.version.load()][ranuraDelHilo()].lectores) {
+    contador.fetch_add(1);
+}
+
+void BibliotecaConcurrente::esperarLectores(int v) const {
+    for (const Contador& c : contadores[v]) {
+        while (c.lectores.load() != 0) std::this_thread::yield();
+    }
+}
+
+// Left-Right: se modifica la copia que nadie lee, se publica, y se espera a que los lectores
+// de ambas versiones de contadores salgan antes de tocar la copia que usaban
+bool BibliotecaConcurrente::modificar(const std::function<bool(BibliotecaDB&)>& f) {
+    std::lock_guard<std::mutex> lock(escritura);
+    int leida = activa.load();
+    bool resultado[2];
+    resultado[1 - leida] = f(copias[1 - leida]);
+    activa.store(1 - leida); // Los lectores que entren desde aquí ya ven el cambio
+    int anterior = version.load();
+    esperarLectores(1 - anterior); // Lectores rezagados de un cambio de versión previo
+    version.store(1 - anterior);
+    esperarLectores(anterior);     // Nadie sigue leyendo la copia anterior
+    resultado[leida] = f(copias[leida]);
+    return resultado[PRINCIPAL];
+}
@@ -0,0 +1,79 @@
+#ifndef BIBLIOTECA_CONCURRENTE_H
+#define BIBLIOTECA_CONCURRENTE_H
+
+#include "Biblioteca.h"
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+
+// BibliotecaDB compartida entre hilos con lecturas que nunca esperan (esquema Left-Right).
+// Se mantienen dos copias identicas: los lectores usan la activa mientras el escritor
+// modifica la otra; despues se intercambian, se espera a que salgan los lectores que aun
+// usaban la anterior y se repite la modificacion en ella. Una lectura solo incrementa y
+// decrementa un contador atomico: no toma cerrojos ni espera a una escritura.
+// Las escrituras se serializan y se aplican dos veces, asi que deben ser deterministas
+// (fechas explicitas, sin leer std::cin); la copia 0 persiste y la 1 es una replica
+// en memoria (BibliotecaDB::setReplica). Los datos ocupan el doble de memoria.
+class BibliotecaConcurrente {
+public:
+    BibliotecaConcurrente();
+    BibliotecaConcurrente(const BibliotecaConcurrente&) = delete;
+    BibliotecaConcurrente& operator=(const BibliotecaConcurrente&) = delete;
+
+    // Configuracion y carga: antes de compartir la base entre hilos
+    void setDirectorio(const std::string& dir);
+    bool cargarDatos();
+    bool cargarDatosBinario(const std::string& archivo = "biblioteca.bin");
+    bool guardarDatos();                  // Escribe la copia principal (serializado con las escrituras)
+
+    // Ejecuta f(BibliotecaDB&) solo sobre la copia principal, serializado con las escrituras:
+    // para su persistencia (diario, escritura diferida, guardarCambios...), no para cambiar
+    // datos, que la replica no veria
+    bool configurar(const std::function<bool(BibliotecaDB&)>& f);
+
+    // Ejecuta f(const BibliotecaDB&) sobre la copia activa y retorna su resultado.
+    // Las referencias obtenidas de la base no deben usarse despues de retornar.
+    template <typename F>
+    auto leer(F&& f) const {
+        Lectura lectura(*this);
+        return f(static_cast<const BibliotecaDB&>(copias[activa.load()]));
+    }
+
+    // Ejecuta f(BibliotecaDB&) en las dos copias, una escritura a la vez; retorna el
+    // resultado de la copia principal
+    bool modificar(const std::function<bool(BibliotecaDB&)>& f);
+
+private:
+    static const int PRINCIPAL = 0;
+    static const std::size_t RANURAS = 64;    // Contadores por version, repartidos por hilo
+
+    // Contador de lectores en su propia linea de cache para que los hilos no compitan por ella
+    struct alignas(64) Contador {
+        std::atomic<long> lectores{0};
+    };
+
+    // Registra al lector en la version vigente mientras dura la lectura
+    class Lectura {
+    public:
+        explicit Lectura(const BibliotecaConcurrente& b);
+        ~Lectura() { contador.fetch_sub(1); }
+        Lectura(const Lectura&) = delete;
+        Lectura& operator=(const Lectura&) = delete;
+
+    private:
+        std::atomic<long>& contador;
+    };
+
+    BibliotecaDB copias[2];
+    std::atomic<int> activa{0};               // Copia que usan los lectores nuevos
+    std::atomic<int> version{0};              // Grupo de contadores en el que entran los lectores
+    mutable Contador contadores[2][RANURAS];
+    std::mutex escritura;                     // Serializa modificar() y guardarDatos()
+
+    static std::size_t ranuraDelHilo();
+    void esperarLectores(int v) const;        // Espera a que los contadores de 'v' lleguen a cero
+};
+
+#endif // BIBLIOTECA_CONCURRENTE_H
@@ -0,0 +1,314 @@
+#include "BibliotecaFragmentada.h"
+#include "Paralelo.h"
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+
+BibliotecaFragmentada::BibliotecaFragmentada(std::size_t n) {
+    for (std::size_t k = 0; k < std::max<std::size_t>(n, 1); ++k) {
+        fragmentos.push_back(std::make_unique<Fragmento>());
+        fragmentos.back()->db.setEstudiantesExternos(true); // Se validan en validarEstudiantes()
+    }
+    setDirectorio("");
+    numerar(); // Una base sin cargar también numera desde 1
+}
+
+std::size_t BibliotecaFragmentada::fragmentoDe(int id) const {
+    return static_cast<unsigned>(id) % fragmentos.size();
+}
+
+// --- Cerrojos ordenados ---
+
+// Siempre de menor a mayor índice: dos operaciones que comparten fragmentos los piden en el
+// mismo orden, así que ninguna puede quedar esperando a la otra en ciclo
+BibliotecaFragmentada::Cerrojos::Cerrojos(const BibliotecaFragmentada& b, std::vector<Acceso> a)
+    : base(b), accesos(std::move(a)) {
+    for (std::size_t k = 0; k < accesos.size(); ++k) {
+        if (accesos[k] == EXCLUSIVO) base.fragmentos[k]->cerrojo.lock();
+        else if (accesos[k] == COMPARTIDO) base.fragmentos[k]->cerrojo.lock_shared();
+    }
+}
+
+BibliotecaFragmentada::Cerrojos::~Cerrojos() {
+    for (std::size_t k = accesos.size(); k-- > 0;) {
+        if (accesos[k] == EXCLUSIVO) base.fragmentos[k]->cerrojo.unlock();
+        else if (accesos[k] == COMPARTIDO) base.fragmentos[k]->cerrojo.unlock_shared();
+    }
+}
+
+// --- Persistencia ---
+
+void BibliotecaFragmentada::setDirectorio(const std::string& dir) {
+    directorio = dir;
+    if (!directorio.empty() && directorio.back() != '/' && directorio.back() != '\\') directorio += '/';
+    for (std::size_t k = 0; k < fragmentos.size(); ++k) {
+        fragmentos[k]->db.setDirectorio(directorio + "fragmento_" + std::to_string(k));
+    }
+}
+
+bool BibliotecaFragmentada::crearDirectorios() const {
+    for (std::size_t k = 0; k < fragmentos.size(); ++k) {
+        std::error_code ec;
+        std::filesystem::create_directories(directorio + "fragmento_" + std::to_string(k), ec);
+        if (ec) {
+            std::cout << "Error: No se pudo crear el directorio del fragmento " << k << ".\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool BibliotecaFragmentada::cargarDatos() {
+    Cerrojos cerrojos(*this, std::vector<Acceso>(fragmentos.size(), EXCLUSIVO));
+    bool ok = enParalelo(fragmentos.size(), [this](std::size_t k) { return fragmentos[k]->db.cargarDatos(); });
+    numerar();
+    validarEstudiantes();
+    return ok;
+}
+
+// Un préstamo activo cita un estudiante de cualquier fragmento: se valida con todos cargados
+void BibliotecaFragmentada::validarEstudiantes() const {
+    std::vector<std::size_t> huerfanos(fragmentos.size(), 0);
+    enParalelo(fragmentos.size(), [&](std::size_t k) {
+        const TablaPrestamos& p = fragmentos[k]->db.prestamos;
+        for (std::size_t i = 0; i < p.size(); ++i) {
+            int e = p.idsEstudiante()[i];
+            if (p.fechasDevolucion()[i].vacia() && !fragmentos[fragmentoDe(e)]->db.buscarEstudiantePorId(e)) {
+                ++huerfanos[k];
+            }
+        }
+        return true;
+    });
+    std::size_t total = 0;
+    for (std::size_t n : huerfanos) total += n;
+    if (total > 0) std::cout << "Advertencia: " << total << " prestamos activos citan un estudiante inexistente.\n";
+}
+
+// Guardar actualiza el estado de persistencia de cada fragmento (generación, diarios)
+bool BibliotecaFragmentada::guardarDatos() {
+    Cerrojos cerrojos(*this, std::vector<Acceso>(fragmentos.size(), EXCLUSIVO));
+    if (!crearDirectorios()) return false;
+    return enParalelo(fragmentos.size(), [this](std::size_t k) { return fragmentos[k]->db.guardarDatos(); });
+}
+
+// Cada fragmento copia las referencias completas y sus filas; los códigos de grado y
+// nacionalidad se traducen a los diccionarios del fragmento
+bool BibliotecaFragmentada::dividir(const BibliotecaDB& origen) {
+    Cerrojos cerrojos(*this, std::vector<Acceso>(fragmentos.size(), EXCLUSIVO));
+    for (const auto& f : fragmentos) {
+        const BibliotecaDB& db = f->db;
+        if (!db.estudiantes.empty() || !db.autores.empty() || !db.editoriales.empty() ||
+            !db.libros.empty() || !db.prestamos.empty()) {
+            std::cout << "Error: Solo se puede dividir sobre fragmentos vacios.\n";
+            return false;
+        }
+    }
+    if (!crearDirectorios()) return false;
+    bool ok = enParalelo(fragmentos.size(), [&](std::size_t k) {
+        BibliotecaDB& db = fragmentos[k]->db;
+        db.iniciarLote(); // Una escritura por tabla al final
+        bool todas = true;
+        for (const Autor& a : origen.autores) {
+            todas = db.agregarAutor(a.id, a.nombre, origen.textoNacionalidad(a.nacionalidad)) && todas;
+        }
+        for (const Editorial& ed : origen.editoriales) todas = db.agregarEditorial(ed) && todas;
+        for (const Estudiante& e : origen.estudiantes) {
+            if (fragmentoDe(e.id) != k) continue;
+            todas = db.agregarEstudiante(e.id, e.nombre, origen.textoGrado(e.grado)) && todas;
+        }
+        for (std::size_t i = 0; i < origen.libros.size(); ++i) {
+            if (fragmentoDe(origen.libros.ids()[i]) == k) todas = db.agregarLibro(origen.libros[i]) && todas;
+        }
+        for (std::size_t i = 0; i < origen.prestamos.size(); ++i) {
+            if (fragmentoDe(origen.prestamos.idsLibro()[i]) == k) todas = db.agregarPrestamo(origen.prestamos[i]) && todas;
+        }
+        return db.terminarLote() && todas;
+    });
+    numerar();
+    return ok;
+}
+
+// Los préstamos parten del mayor ID de todos los fragmentos; a partir de ahí el fragmento k
+// usa los IDs congruentes con k, de modo que cada uno numera sin consultar a los demás.
+// Estudiantes y libros eligen fragmento por su ID, así que comparten un contador por tabla.
+void BibliotecaFragmentada::numerar() {
+    int base = 1;
+    int estudiante = 1;
+    int libro = 1;
+    for (const auto& f : fragmentos) {
+        base = std::max(base, f->db.nextPrestamoId());
+        estudiante = std::max(estudiante, f->db.nextEstudianteId());
+        libro = std::max(libro, f->db.nextLibroId());
+    }
+    int n = static_cast<int>(fragmentos.size());
+    for (int k = 0; k < n; ++k) {
+        fragmentos[k]->siguientePrestamo = base + ((k - base % n) % n + n) % n;
+    }
+    siguienteEstudiante.store(estudiante);
+    siguienteLibro.store(libro);
+}
+
+void BibliotecaFragmentada::adelantar(std::atomic<int>& siguiente, int id) {
+    int actual = siguiente.load();
+    while (actual <= id && !siguiente.compare_exchange_weak(actual, id + 1)) {}
+}
+
+bool BibliotecaFragmentada::modificarTodos(const std::function<bool(BibliotecaDB&)>& f) {
+    Cerrojos cerrojos(*this, std::vector<Acceso>(fragmentos.size(), EXCLUSIVO));
+    bool ok = true;
+    for (const auto& frag : fragmentos) ok = f(frag->db) && ok;
+    return ok;
+}
+
+// --- Estudiantes y libros ---
+
+int BibliotecaFragmentada::nextEstudianteId() const {
+    return siguienteEstudiante.load();
+}
+
+// El ID se reserva antes de saber su fragmento (depende de él): si otro hilo da de alta
+// ese mismo ID con un ID explícito, el fragmento rechaza al segundo
+int BibliotecaFragmentada::agregarEstudiante(std::string_view nombre, std::string_view grado) {
+    int id = siguienteEstudiante.fetch_add(1);
+    return agregarEstudiante(id, nombre, grado) ? id : 0;
+}
+
+bool BibliotecaFragmentada::agregarEstudiante(int id, std::string_view nombre, std::string_view grado) {
+    Fragmento& f = *fragmentos[fragmentoDe(id)];
+    std::unique_lock<std::shared_mutex> lock(f.cerrojo);
+    if (!f.db.agregarEstudiante(id, nombre, grado)) return false;
+    adelantar(siguienteEstudiante, id);
+    return true;
+}
+
+// Sus préstamos están en los fragmentos de los libros: se consultan todos, y el suyo se
+// bloquea en exclusiva para eliminarlo
+bool BibliotecaFragmentada::eliminarEstudiante(int id) {
+    std::size_t propio = fragmentoDe(id);
+    std::vector<Acceso> accesos(fragmentos.size(), COMPARTIDO);
+    accesos[propio] = EXCLUSIVO;
+    Cerrojos cerrojos(*this, accesos);
+    for (std::size_t k = 0; k < fragmentos.size(); ++k) {
+        const BibliotecaDB& db = fragmentos[k]->db;
+        for (int idp : db.prestamosDeEstudiante(id)) {
+            std::optional<Prestamo> p = db.buscarPrestamoPorId(idp);
+            if (p && p->fecha_devolucion.vacia()) {
+                std::cout << "Error: Estudiante tiene prestamo activo (ID Prestamo " << idp << ").\n";
+                return false;
+            }
+        }
+    }
+    return fragmentos[propio]->db.eliminarEstudiante(id);
+}
+
+int BibliotecaFragmentada::nextLibroId() const {
+    return siguienteLibro.load();
+}
+
+int BibliotecaFragmentada::agregarLibroNuevo(Libro l) {
+    l.id = siguienteLibro.fetch_add(1);
+    return agregarLibro(l) ? l.id : 0;
+}
+
+// El ISBN es único en toda la base: los demás fragmentos se consultan con el cerrojo compartido
+bool BibliotecaFragmentada::agregarLibro(const Libro& l) {
+    std::size_t propio = fragmentoDe(l.id);
+    std::vector<Acceso> accesos(fragmentos.size(), COMPARTIDO);
+    accesos[propio] = EXCLUSIVO;
+    Cerrojos cerrojos(*this, accesos);
+    for (std::size_t k = 0; k < fragmentos.size(); ++k) {
+        if (k == propio || l.isbn.vacio()) continue;
+        if (std::optional<Libro> otro = fragmentos[k]->db.buscarLibroPorIsbn(l.isbn.texto())) {
+            std::cout << "Error: ISBN " << l.isbn << " ya existe (Libro ID " << otro->id << ").\n";
+            return false;
+        }
+    }
+    if (!fragmentos[propio]->db.agregarLibro(l)) return false;
+    adelantar(siguienteLibro, l.id);
+    return true;
+}
+
+// Sus préstamos viven en su mismo fragmento, que ya valida los activos
+bool BibliotecaFragmentada::eliminarLibro(int id) {
+    Fragmento& f = *fragmentos[fragmentoDe(id)];
+    std::unique_lock<std::shared_mutex> lock(f.cerrojo);
+    return f.db.eliminarLibro(id);
+}
+
+// --- Autores y editoriales ---
+
+// Primero se valida en todos los fragmentos y después se aplica en todos, para que las
+// copias no diverjan; si el primero rechaza la operación, los demás también lo harían
+bool BibliotecaFragmentada::modificarReferencia(const std::function<bool(BibliotecaDB&)>& validar,
+                                                const std::function<bool(BibliotecaDB&)>& aplicar) {
+    Cerrojos cerrojos(*this, std::vector<Acceso>(fragmentos.size(), EXCLUSIVO));
+    for (const auto& f : fragmentos) {
+        if (!validar(f->db)) return false;
+    }
+    if (!aplicar(fragmentos[0]->db)) return false;
+    bool ok = true;
+    for (std::size_t k = 1; k < fragmentos.size(); ++k) ok = aplicar(fragmentos[k]->db) && ok;
+    return ok;
+}
+
+bool BibliotecaFragmentada::agregarAutor(int id, std::string_view nombre, std::string_view nacionalidad) {
+    return modificarReferencia([](BibliotecaDB&) { return true; }, [&](BibliotecaDB& db) {
+        return db.agregarAutor(id, nombre, nacionalidad);
+    });
+}
+
+bool BibliotecaFragmentada::eliminarAutor(int id) {
+    return modificarReferencia([id](BibliotecaDB& db) {
+        if (db.librosDeAutor(id).empty()) return true;
+        std::cout << "Error: Autor referenciado por libro ID " << db.librosDeAutor(id).front() << ".\n";
+        return false;
+    }, [id](BibliotecaDB& db) { return db.eliminarAutor(id); });
+}
+
+bool BibliotecaFragmentada::agregarEditorial(const Editorial& ed) {
+    return modificarReferencia([](BibliotecaDB&) { return true; },
+                               [&ed](BibliotecaDB& db) { return db.agregarEditorial(ed); });
+}
+
+bool BibliotecaFragmentada::eliminarEditorial(int id) {
+    return modificarReferencia([id](BibliotecaDB& db) {
+        if (db.librosDeEditorial(id).empty()) return true;
+        std::cout << "Error: Editorial referenciada por libro ID " << db.librosDeEditorial(id).front() << ".\n";
+        return false;
+    }, [id](BibliotecaDB& db) { return db.eliminarEditorial(id); });
+}
+
+// --- Préstamos ---
+
+// El préstamo se crea en el fragmento del libro (exclusivo); el del estudiante solo se
+// consulta (compartido), y mientras tanto nadie puede eliminarlo
+int BibliotecaFragmentada::prestarLibro(int id_libro, int id_estudiante, Fecha fecha_prestamo) {
+    std::size_t delLibro = fragmentoDe(id_libro);
+    std::size_t delEstudiante = fragmentoDe(id_estudiante);
+    std::vector<Acceso> accesos(fragmentos.size(), SIN_ACCESO);
+    accesos[delEstudiante] = COMPARTIDO;
+    accesos[delLibro] = EXCLUSIVO;
+    Cerrojos cerrojos(*this, accesos);
+    if (!fragmentos[delEstudiante]->db.buscarEstudiantePorId(id_estudiante)) {
+        std::cout << "Error: Estudiante ID " << id_estudiante << " no existe.\n";
+        return 0;
+    }
+    Fragmento& f = *fragmentos[delLibro];
+    Prestamo p{f.siguientePrestamo, id_libro, id_estudiante, fecha_prestamo, Fecha()};
+    f.siguientePrestamo += static_cast<int>(fragmentos.size()); // Un ID rechazado no se reutiliza
+    return f.db.agregarPrestamo(p) ? p.id : 0;
+}
+
+// Los préstamos nuevos están en el fragmento de su ID; los importados con dividir() pueden
+// estar en otro, así que se prueban después los demás (un préstamo nunca cambia de fragmento)
+bool BibliotecaFragmentada::devolverPrestamo(int id_prestamo, Fecha fecha_devolucion) {
+    std::size_t n = fragmentos.size();
+    std::size_t primero = fragmentoDe(id_prestamo);
+    for (std::size_t i = 0; i < n; ++i) {
+        Fragmento& f = *fragmentos[(primero + i) % n];
+        std::unique_lock<std::shared_mutex> lock(f.cerrojo);
+        if (f.db.buscarPrestamoPorId(id_prestamo)) return f.db.devolverPrestamo(id_prestamo, fecha_devolucion);
+    }
+    std::cout << "Error: Prestamo ID " << id_prestamo << " no existe.\n";
+    return false;
+}
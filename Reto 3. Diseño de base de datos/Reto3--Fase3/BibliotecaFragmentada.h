@@ -0,0 +1,121 @@
+#ifndef BIBLIOTECA_FRAGMENTADA_H
+#define BIBLIOTECA_FRAGMENTADA_H
+
+#include "Biblioteca.h"
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// BibliotecaDB repartida en N fragmentos por ID: el estudiante y el libro con ID i viven en
+// el fragmento i % N y cada prestamo en el de su libro. Cada fragmento tiene su cerrojo,
+// sus indices y sus archivos (<dir>/fragmento_<k>/), asi que las operaciones sobre
+// fragmentos distintos avanzan en paralelo y cada escritura reescribe solo su parte.
+// Autores y editoriales son tablas de referencia pequenas: se replican en todos.
+// Una operacion que toca varios fragmentos toma sus cerrojos en orden de indice (nunca
+// en otro), lo que evita interbloqueos; p. ej. prestarLibro con el libro y el estudiante
+// en fragmentos distintos bloquea el del libro y consulta el del estudiante.
+// Es un modo de biblioteca: biblioteca.exe y el servidor usan una BibliotecaDB completa,
+// porque sus listados, busquedas y transacciones recorren tablas enteras y aqui solo hay
+// operaciones por ID y lecturas de un fragmento.
+class BibliotecaFragmentada {
+public:
+    explicit BibliotecaFragmentada(std::size_t n);
+    BibliotecaFragmentada(const BibliotecaFragmentada&) = delete;
+    BibliotecaFragmentada& operator=(const BibliotecaFragmentada&) = delete;
+
+    std::size_t numFragmentos() const { return fragmentos.size(); }
+    std::size_t fragmentoDe(int id) const;
+
+    // --- Persistencia ---
+    void setDirectorio(const std::string& dir);  // Cada fragmento usa <dir>/fragmento_<k>/
+    bool cargarDatos();                   // Fragmentos en paralelo (ver Paralelo.h)
+    bool guardarDatos();                  // Tambien en paralelo; cada fragmento es todo o nada
+    // Reparte una base sin fragmentar (p. ej. recien cargada de los CSV) y escribe los
+    // archivos de cada fragmento; solo sobre fragmentos vacios
+    bool dividir(const BibliotecaDB& origen);
+
+    // --- Lecturas ---
+    // Ejecuta f(const BibliotecaDB&) con el cerrojo compartido del fragmento del ID (o del
+    // fragmento k); las vistas obtenidas no deben usarse despues de retornar.
+    template <typename F>
+    auto leer(int id, F&& f) const {
+        return leerFragmento(fragmentoDe(id), std::forward<F>(f));
+    }
+    template <typename F>
+    auto leerFragmento(std::size_t k, F&& f) const {
+        std::shared_lock<std::shared_mutex> lock(fragmentos[k]->cerrojo);
+        return f(static_cast<const BibliotecaDB&>(fragmentos[k]->db));
+    }
+
+    // Ejecuta f(BibliotecaDB&) en todos los fragmentos con todos los cerrojos tomados
+    // (configuracion: diario, lotes...); retorna true si lo logra en todos
+    bool modificarTodos(const std::function<bool(BibliotecaDB&)>& f);
+
+    // --- Estudiantes y libros (en un fragmento) ---
+    // Las altas sin ID reservan el siguiente de un contador atomico comun, asi que dos hilos
+    // nunca reciben el mismo; retornan el ID creado (0 si falla; el ID no se reutiliza).
+    // Las altas con ID explicito (importaciones) adelantan el contador si hace falta.
+    // nextEstudianteId/nextLibroId solo informan del proximo ID: no lo reservan.
+    int nextEstudianteId() const;
+    int agregarEstudiante(std::string_view nombre, std::string_view grado);
+    bool agregarEstudiante(int id, std::string_view nombre, std::string_view grado);
+    bool eliminarEstudiante(int id);      // Valida sus prestamos activos en todos los fragmentos
+    int nextLibroId() const;
+    int agregarLibroNuevo(Libro l);       // Ignora l.id y le asigna uno
+    bool agregarLibro(const Libro& l);    // Valida el ISBN unico en todos los fragmentos
+    bool eliminarLibro(int id);
+
+    // --- Autores y editoriales (replicados) ---
+    bool agregarAutor(int id, std::string_view nombre, std::string_view nacionalidad);
+    bool eliminarAutor(int id);           // Solo si ningun fragmento tiene libros suyos
+    bool agregarEditorial(const Editorial& ed);
+    bool eliminarEditorial(int id);
+
+    // --- Prestamos ---
+    int prestarLibro(int id_libro, int id_estudiante, Fecha fecha_prestamo); // ID creado, 0 si falla
+    bool devolverPrestamo(int id_prestamo, Fecha fecha_devolucion);
+
+private:
+    struct Fragmento {
+        BibliotecaDB db;
+        mutable std::shared_mutex cerrojo;
+        int siguientePrestamo = 0;        // Proximo ID de prestamo, congruente con k modulo N
+    };
+
+    // Como se toma el cerrojo de cada fragmento en una operacion
+    enum Acceso { SIN_ACCESO, COMPARTIDO, EXCLUSIVO };
+
+    // Cerrojos de varios fragmentos tomados en orden de indice y liberados al salir de alcance
+    class Cerrojos {
+    public:
+        Cerrojos(const BibliotecaFragmentada& b, std::vector<Acceso> accesos);
+        ~Cerrojos();
+        Cerrojos(const Cerrojos&) = delete;
+        Cerrojos& operator=(const Cerrojos&) = delete;
+
+    private:
+        const BibliotecaFragmentada& base;
+        std::vector<Acceso> accesos;
+    };
+
+    std::vector<std::unique_ptr<Fragmento>> fragmentos;
+    std::string directorio;
+    std::atomic<int> siguienteEstudiante{1}; // Proximos IDs de las altas sin ID
+    std::atomic<int> siguienteLibro{1};
+
+    bool crearDirectorios() const;
+    void numerar();                       // Ajusta los contadores de IDs tras cargar o dividir
+    static void adelantar(std::atomic<int>& siguiente, int id); // siguiente = max(siguiente, id + 1)
+    void validarEstudiantes() const;      // Advierte de prestamos activos sin su estudiante
+    bool modificarReferencia(const std::function<bool(BibliotecaDB&)>& validar,
+                             const std::function<bool(BibliotecaDB&)>& aplicar);
+};
+
+#endif // BIBLIOTECA_FRAGMENTADA_H
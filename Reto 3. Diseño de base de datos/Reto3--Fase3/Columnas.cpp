@@ -0,0 +1,167 @@
+#include "Columnas.h"
+#include "Biblioteca.h"
+#include <cstring>
+
+namespace {
+
+// Bytes sin uso a partir de los cuales se considera compactar un bloque de textos
+const std::size_t MINIMO_COMPACTAR = 64 * 1024;
+
+// Elimina la posición i de una columna
+template <typename T>
+void borrar(std::vector<T>& columna, std::size_t i) {
+    columna.erase(columna.begin() + static_cast<std::ptrdiff_t>(i));
+}
+
+} // namespace
+
+// --- ColumnaTexto ---
+
+void ColumnaTexto::reserve(std::size_t filas, std::size_t bytes) {
+    inicio.reserve(filas);
+    largo.reserve(filas);
+    bloque.reserve(bytes);
+}
+
+void ColumnaTexto::clear() {
+    bloque.clear();
+    inicio.clear();
+    largo.clear();
+    sinUso = 0;
+}
+
+void ColumnaTexto::push_back(std::string_view s) {
+    inicio.push_back(static_cast<std::uint32_t>(bloque.size()));
+    largo.push_back(static_cast<std::uint32_t>(s.size()));
+    bloque.append(s.data(), s.size());
+}
+
+// Un texto que cabe en el espacio anterior se reescribe en su lugar
+void ColumnaTexto::asignar(std::size_t i, std::string_view s) {
+    if (s.size() <= largo[i]) {
+        if (!s.empty()) std::memmove(&bloque[inicio[i]], s.data(), s.size());
+        sinUso += largo[i] - s.size();
+    } else {
+        sinUso += largo[i];
+        inicio[i] = static_cast<std::uint32_t>(bloque.size());
+        bloque.append(s.data(), s.size());
+    }
+    largo[i] = static_cast<std::uint32_t>(s.size());
+    if (sinUso > MINIMO_COMPACTAR && sinUso > bloque.size() / 2) compactar();
+}
+
+void ColumnaTexto::erase(std::size_t i) {
+    sinUso += largo[i];
+    borrar(inicio, i);
+    borrar(largo, i);
+    if (sinUso > MINIMO_COMPACTAR && sinUso > bloque.size() / 2) compactar();
+}
+
+void ColumnaTexto::compactar() {
+    std::string nuevo;
+    nuevo.reserve(bloque.size() - sinUso);
+    for (std::size_t i = 0; i < inicio.size(); ++i) {
+        std::uint32_t desde = inicio[i];
+        inicio[i] = static_cast<std::uint32_t>(nuevo.size());
+        nuevo.append(bloque, desde, largo[i]);
+    }
+    bloque.swap(nuevo);
+    sinUso = 0;
+}
+
+// --- TablaLibros ---
+
+void TablaLibros::reserve(std::size_t filas) {
+    id.reserve(filas);
+    titulo.reserve(filas, 0);
+    isbn.reserve(filas);
+    anio.reserve(filas);
+    id_autor.reserve(filas);
+    id_editorial.reserve(filas);
+}
+
+void TablaLibros::clear() {
+    id.clear();
+    titulo.clear();
+    isbn.clear();
+    anio.clear();
+    id_autor.clear();
+    id_editorial.clear();
+}
+
+Libro TablaLibros::operator[](std::size_t i) const {
+    return Libro{id[i], titulo[i], isbn[i], anio[i], id_autor[i], id_editorial[i]};
+}
+
+void TablaLibros::push_back(const Libro& l) {
+    id.push_back(l.id);
+    titulo.push_back(l.titulo);
+    isbn.push_back(l.isbn);
+    anio.push_back(l.anio);
+    id_autor.push_back(l.id_autor);
+    id_editorial.push_back(l.id_editorial);
+}
+
+void TablaLibros::asignar(std::size_t i, const Libro& l) {
+    id[i] = l.id;
+    titulo.asignar(i, l.titulo);
+    isbn[i] = l.isbn;
+    anio[i] = l.anio;
+    id_autor[i] = l.id_autor;
+    id_editorial[i] = l.id_editorial;
+}
+
+void TablaLibros::erase(std::size_t i) {
+    borrar(id, i);
+    titulo.erase(i);
+    borrar(isbn, i);
+    borrar(anio, i);
+    borrar(id_autor, i);
+    borrar(id_editorial, i);
+}
+
+// --- TablaPrestamos ---
+
+void TablaPrestamos::reserve(std::size_t filas) {
+    id.reserve(filas);
+    id_libro.reserve(filas);
+    id_estudiante.reserve(filas);
+    fecha_prestamo.reserve(filas);
+    fecha_devolucion.reserve(filas);
+}
+
+void TablaPrestamos::clear() {
+    id.clear();
+    id_libro.clear();
+    id_estudiante.clear();
+    fecha_prestamo.clear();
+    fecha_devolucion.clear();
+}
+
+Prestamo TablaPrestamos::operator[](std::size_t i) const {
+    return Prestamo{id[i], id_libro[i], id_estudiante[i], fecha_prestamo[i], fecha_devolucion[i]};
+}
+
+void TablaPrestamos::push_back(const Prestamo& p) {
+    id.push_back(p.id);
+    id_libro.push_back(p.id_libro);
+    id_estudiante.push_back(p.id_estudiante);
+    fecha_prestamo.push_back(p.fecha_prestamo);
+    fecha_devolucion.push_back(p.fecha_devolucion);
+}
+
+void TablaPrestamos::asignar(std::size_t i, const Prestamo& p) {
+    id[i] = p.id;
+    id_libro[i] = p.id_libro;
+    id_estudiante[i] = p.id_estudiante;
+    fecha_prestamo[i] = p.fecha_prestamo;
+    fecha_devolucion[i] = p.fecha_devolucion;
+}
+
+void TablaPrestamos::erase(std::size_t i) {
+    borrar(id, i);
+    borrar(id_libro, i);
+    borrar(id_estudiante, i);
+    borrar(fecha_prestamo, i);
+    borrar(fecha_devolucion, i);
+}
@@ -0,0 +1,135 @@
+#ifndef COLUMNAS_H
+#define COLUMNAS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Fecha.h"
+#include "Isbn.h"
+
+struct Libro;
+struct Prestamo;
+
+// Columna de textos guardados uno tras otro en un solo bloque de caracteres.
+// Reescribir un texto mas largo lo anexa al final; el espacio que queda sin uso
+// se recupera compactando cuando supera la mitad del bloque.
+class ColumnaTexto {
+public:
+    std::size_t size() const { return inicio.size(); }
+    void reserve(std::size_t filas, std::size_t bytes);
+    void clear();
+    void push_back(std::string_view s);
+    void asignar(std::size_t i, std::string_view s);
+    void erase(std::size_t i);
+    std::string_view operator[](std::size_t i) const {
+        return std::string_view(bloque.data() + inicio[i], largo[i]);
+    }
+    std::size_t bytes() const { return bloque.size(); }   // Incluye el espacio sin uso
+    void compactar();                                     // Reescribe el bloque sin huecos
+
+private:
+    std::string bloque;
+    std::vector<std::uint32_t> inicio;   // Posicion de cada texto en 'bloque'
+    std::vector<std::uint32_t> largo;
+    std::size_t sinUso = 0;              // Bytes de textos reemplazados o eliminados
+};
+
+// Iterador de solo lectura que entrega cada fila reconstruida como struct
+template <typename Tabla, typename Fila>
+class IteradorFilas {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Fila;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = Fila;
+
+    IteradorFilas(const Tabla* tabla, std::size_t pos) : tabla(tabla), pos(pos) {}
+    Fila operator*() const { return (*tabla)[pos]; }
+    IteradorFilas& operator++() {
+        ++pos;
+        return *this;
+    }
+    bool operator==(const IteradorFilas& o) const { return pos == o.pos; }
+    bool operator!=(const IteradorFilas& o) const { return pos != o.pos; }
+
+private:
+    const Tabla* tabla;
+    std::size_t pos;
+};
+
+// Tabla de libros por columnas: cada campo entero en su propio arreglo contiguo y los
+// titulos en una ColumnaTexto. Los escaneos leen solo las columnas que necesitan; las
+// operaciones por fila (operator[], push_back, asignar, erase) conservan la interfaz de
+// un vector de Libro para el CRUD.
+class TablaLibros {
+public:
+    using value_type = Libro;
+    using const_iterator = IteradorFilas<TablaLibros, Libro>;
+
+    std::size_t size() const { return id.size(); }
+    bool empty() const { return id.empty(); }
+    void reserve(std::size_t filas);
+    void clear();
+    Libro operator[](std::size_t i) const;            // Fila reconstruida; el titulo es una vista a la columna
+    void push_back(const Libro& l);
+    void asignar(std::size_t i, const Libro& l);      // Reemplaza la fila completa
+    void erase(std::size_t i);
+    void compactarTitulos() { titulo.compactar(); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size()); }
+
+    // Columnas de solo lectura
+    const std::vector<int>& ids() const { return id; }
+    const ColumnaTexto& titulos() const { return titulo; }
+    const std::vector<Isbn>& isbns() const { return isbn; }
+    const std::vector<int>& anios() const { return anio; }
+    const std::vector<int>& idsAutor() const { return id_autor; }
+    const std::vector<int>& idsEditorial() const { return id_editorial; }
+
+private:
+    std::vector<int> id;
+    ColumnaTexto titulo;
+    std::vector<Isbn> isbn;
+    std::vector<int> anio;
+    std::vector<int> id_autor;
+    std::vector<int> id_editorial;
+};
+
+// Tabla de prestamos por columnas (todos sus campos son enteros de 32 bits)
+class TablaPrestamos {
+public:
+    using value_type = Prestamo;
+    using const_iterator = IteradorFilas<TablaPrestamos, Prestamo>;
+
+    std::size_t size() const { return id.size(); }
+    bool empty() const { return id.empty(); }
+    void reserve(std::size_t filas);
+    void clear();
+    Prestamo operator[](std::size_t i) const;
+    void push_back(const Prestamo& p);
+    void asignar(std::size_t i, const Prestamo& p);
+    void asignarDevolucion(std::size_t i, Fecha f) { fecha_devolucion[i] = f; }
+    void erase(std::size_t i);
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size()); }
+
+    // Columnas de solo lectura
+    const std::vector<int>& ids() const { return id; }
+    const std::vector<int>& idsLibro() const { return id_libro; }
+    const std::vector<int>& idsEstudiante() const { return id_estudiante; }
+    const std::vector<Fecha>& fechasPrestamo() const { return fecha_prestamo; }
+    const std::vector<Fecha>& fechasDevolucion() const { return fecha_devolucion; }
+
+private:
+    std::vector<int> id;
+    std::vector<int> id_libro;
+    std::vector<int> id_estudiante;
+    std::vector<Fecha> fecha_prestamo;
+    std::vector<Fecha> fecha_devolucion;
+};
+
+#endif // COLUMNAS_H
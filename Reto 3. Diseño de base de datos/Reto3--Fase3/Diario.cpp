@@ -0,0 +1,99 @@
+#include "Diario.h"
+#include <fstream>
+#include <sstream>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+// Cierra el diario asegurando que los registros pendientes lleguen a disco
+Diario::~Diario() {
+    cerrar();
+}
+
+// Abre el diario en modo anexado y cuenta los registros ya existentes
+bool Diario::abrir(const std::string& r) {
+    cerrar();
+    ruta = r;
+    std::vector<RegistroDiario> existentes;
+    leer(ruta, existentes);
+    registros = existentes.size();
+    archivo = std::fopen(ruta.c_str(), "ab");
+    return archivo != nullptr;
+}
+
+// Sincroniza y libera el descriptor del archivo
+void Diario::cerrar() {
+    if (!archivo) return;
+    sincronizar();
+    std::fclose(archivo);
+    archivo = nullptr;
+}
+
+// Anexa una línea "<op>,<fila>" y la entrega al sistema operativo antes de retornar, así
+// sobrevive a la muerte del proceso; el fsync (que la protege de un fallo del equipo) se
+// agrupa y se fuerza cuando se completa un lote
+bool Diario::registrar(char operacion, const std::string& fila) {
+    if (!archivo) return false;
+    std::string linea;
+    linea.reserve(fila.size() + 3);
+    linea += operacion;
+    linea += ',';
+    linea += fila;
+    linea += '\n';
+    if (std::fwrite(linea.data(), 1, linea.size(), archivo) != linea.size()) return false;
+    if (std::fflush(archivo) != 0) return false;
+    ++registros;
+    if (++sinSincronizar >= loteSync) return sincronizar();
+    return true;
+}
+
+// Vuelca el buffer de stdio y pide al sistema operativo persistir el archivo
+bool Diario::sincronizar() {
+    if (!archivo) return false;
+    sinSincronizar = 0;
+    if (std::fflush(archivo) != 0) return false;
+#ifdef _WIN32
+    return _commit(_fileno(archivo)) == 0;
+#else
+    return fsync(fileno(archivo)) == 0;
+#endif
+}
+
+// Vacía el diario; se usa después de escribir un snapshot completo de la tabla
+bool Diario::truncar() {
+    if (ruta.empty()) return false;
+    bool estabaAbierto = archivo != nullptr;
+    if (estabaAbierto) {
+        std::fclose(archivo);
+        archivo = nullptr;
+    }
+    std::FILE* f = std::fopen(ruta.c_str(), "wb");
+    if (!f) return false;
+    std::fclose(f);
+    registros = 0;
+    sinSincronizar = 0;
+    if (estabaAbierto) archivo = std::fopen(ruta.c_str(), "ab");
+    return true;
+}
+
+// Lee todos los registros completos; una última línea sin '\n' (escritura interrumpida) se descarta
+bool Diario::leer(const std::string& ruta, std::vector<RegistroDiario>& salida) {
+    salida.clear();
+    std::ifstream file(ruta, std::ios::binary);
+    if (!file.is_open()) return true; // No es error si el diario no existe
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    const std::string contenido = buffer.str();
+    std::size_t inicio = 0;
+    while (inicio < contenido.size()) {
+        std::size_t fin = contenido.find('\n', inicio);
+        if (fin == std::string::npos) break; // Registro truncado por un fallo
+        if (fin - inicio >= 2 && contenido[inicio + 1] == ',') {
+            salida.push_back({contenido[inicio], contenido.substr(inicio + 2, fin - inicio - 2)});
+        }
+        inicio = fin + 1;
+    }
+    return true;
+}
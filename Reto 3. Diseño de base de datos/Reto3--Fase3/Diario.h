@@ -0,0 +1,48 @@
+#ifndef DIARIO_H
+#define DIARIO_H
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Registro leido de un diario: operacion y fila CSV asociada
+struct RegistroDiario {
+    char operacion;            // 'A' = alta/modificacion (fila completa), 'B' = baja (solo ID)
+    std::string fila;          // Fila CSV de la entidad, o el ID en el caso de una baja
+};
+
+// Diario de solo anexado (write-ahead log) para una tabla.
+// Cada mutacion se escribe como una linea "<op>,<fila>\n" al final del archivo y se vuelca
+// al sistema operativo antes de retornar (sobrevive a un kill -9 del proceso); el fsync,
+// que la protege de un fallo del equipo, se agrupa cada 'loteSync' registros o al llamar
+// a sincronizar().
+class Diario {
+public:
+    Diario() = default;
+    ~Diario();
+    Diario(const Diario&) = delete;
+    Diario& operator=(const Diario&) = delete;
+
+    bool abrir(const std::string& ruta);                  // Abre (o crea) el diario en modo anexado
+    void cerrar();                                         // Sincroniza y cierra el archivo
+    bool registrar(char operacion, const std::string& fila); // Anexa un registro (fflush, no fsync)
+    bool sincronizar();                                    // Vuelca buffers y fuerza fsync
+    bool truncar();                                        // Vacia el diario tras un checkpoint
+
+    // Lee los registros completos del diario en 'ruta' (vacio si no existe)
+    static bool leer(const std::string& ruta, std::vector<RegistroDiario>& registros);
+
+    void setLoteSync(std::size_t n) { loteSync = n == 0 ? 1 : n; }
+    std::size_t registrosPendientes() const { return registros; }  // Registros desde el ultimo checkpoint
+    bool abierto() const { return archivo != nullptr; }
+
+private:
+    std::string ruta;                  // Ruta del archivo de diario
+    std::FILE* archivo = nullptr;      // Descriptor abierto en modo "ab"
+    std::size_t loteSync = 64;         // Registros entre cada fsync
+    std::size_t sinSincronizar = 0;    // Registros escritos desde el ultimo fsync
+    std::size_t registros = 0;         // Registros acumulados en el archivo
+};
+
+#endif // DIARIO_H
@@ -0,0 +1,45 @@
+#include "Diccionario.h"
+
+// Las claves del mapa apuntan a los textos propios: al copiar se vuelven a indexar
+Diccionario::Diccionario(const Diccionario& otro) : valores(otro.valores) {
+    codigos.reserve(valores.size());
+    for (std::size_t i = 0; i < valores.size(); ++i) codigos.emplace(valores[i], static_cast<std::uint32_t>(i));
+}
+
+Diccionario& Diccionario::operator=(const Diccionario& otro) {
+    if (this != &otro) *this = Diccionario(otro);
+    return *this;
+}
+
+std::uint32_t Diccionario::codificar(std::string_view texto) {
+    auto it = codigos.find(texto);
+    if (it != codigos.end()) return it->second;
+    std::uint32_t codigo = static_cast<std::uint32_t>(valores.size());
+    valores.emplace_back(texto);
+    codigos.emplace(valores.back(), codigo);
+    return codigo;
+}
+
+bool Diccionario::buscar(std::string_view texto, std::uint32_t& codigo) const {
+    auto it = codigos.find(texto);
+    if (it == codigos.end()) return false;
+    codigo = it->second;
+    return true;
+}
+
+std::string_view Diccionario::texto(std::uint32_t codigo) const {
+    return codigo < valores.size() ? std::string_view(valores[codigo]) : std::string_view();
+}
+
+// Los códigos son el orden de alta: descartar los últimos no cambia los demás
+void Diccionario::recortar(std::size_t n) {
+    while (valores.size() > n) {
+        codigos.erase(valores.back());
+        valores.pop_back();
+    }
+}
+
+void Diccionario::limpiar() {
+    codigos.clear();
+    valores.clear();
+}
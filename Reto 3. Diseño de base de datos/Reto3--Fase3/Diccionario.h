@@ -0,0 +1,34 @@
+#ifndef DICCIONARIO_H
+#define DICCIONARIO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Diccionario de textos repetidos (grados, nacionalidades): cada valor distinto se
+// guarda una sola vez y las filas almacenan su codigo, que es el orden de alta.
+// Los codigos no cambian mientras el diccionario exista.
+class Diccionario {
+public:
+    Diccionario() = default;
+    Diccionario(const Diccionario& otro);
+    Diccionario& operator=(const Diccionario& otro);
+    Diccionario(Diccionario&&) = default;
+    Diccionario& operator=(Diccionario&&) = default;
+
+    std::uint32_t codificar(std::string_view texto);     // Codigo del valor; lo agrega si es nuevo
+    bool buscar(std::string_view texto, std::uint32_t& codigo) const; // Sin agregar
+    std::string_view texto(std::uint32_t codigo) const;  // "" si el codigo no existe
+    std::size_t size() const { return valores.size(); }
+    void limpiar();
+    void recortar(std::size_t n);                         // Descarta los valores con codigo >= n
+
+private:
+    std::deque<std::string> valores;   // deque: los textos no se mueven al crecer
+    std::unordered_map<std::string_view, std::uint32_t> codigos; // Vistas sobre 'valores'
+};
+
+#endif // DICCIONARIO_H
@@ -0,0 +1,81 @@
+#include "Fecha.h"
+#include "Validacion.h"
+#include <ctime>
+
+// Conversión civil -> días con aritmética entera (algoritmo days_from_civil de H. Hinnant)
+Fecha Fecha::desdeCivil(int anio, int mes, int dia) {
+    anio -= mes <= 2;
+    const int era = (anio >= 0 ? anio : anio - 399) / 400;
+    const int yoe = anio - era * 400;                                      // [0, 399]
+    const int doy = (153 * (mes + (mes > 2 ? -3 : 9)) + 2) / 5 + dia - 1;  // [0, 365]
+    const int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;                 // [0, 146096]
+    Fecha f;
+    f.dias = era * 146097 + doe - 719468;
+    return f;
+}
+
+// Conversión días -> civil (algoritmo civil_from_days)
+void Fecha::aCivil(int& anio, int& mes, int& dia) const {
+    const int z = dias + 719468;
+    const int era = (z >= 0 ? z : z - 146096) / 146097;
+    const int doe = z - era * 146097;
+    const int yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const int doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const int mp = (5 * doy + 2) / 153;
+    dia = doy - (153 * mp + 2) / 5 + 1;
+    mes = mp < 10 ? mp + 3 : mp - 9;
+    anio = yoe + era * 400 + (mes <= 2);
+}
+
+// Valida formato y calendario sin reservar memoria
+bool Fecha::parsear(std::string_view s, Fecha& f) {
+    if (s.empty()) {
+        f = Fecha();
+        return true;
+    }
+    int anio, mes, dia;
+    if (!descomponerFecha(s, anio, mes, dia) || dia < 1 || dia > diasEnMes(anio, mes)) return false;
+    f = desdeCivil(anio, mes, dia);
+    return true;
+}
+
+// Escribe los dígitos directamente en el buffer destino (al menos LARGO_TEXTO bytes)
+std::size_t Fecha::formatear(char* destino) const {
+    if (vacia()) return 0;
+    int anio, mes, dia;
+    aCivil(anio, mes, dia);
+    destino[0] = static_cast<char>('0' + anio / 1000 % 10);
+    destino[1] = static_cast<char>('0' + anio / 100 % 10);
+    destino[2] = static_cast<char>('0' + anio / 10 % 10);
+    destino[3] = static_cast<char>('0' + anio % 10);
+    destino[4] = '-';
+    destino[5] = static_cast<char>('0' + mes / 10);
+    destino[6] = static_cast<char>('0' + mes % 10);
+    destino[7] = '-';
+    destino[8] = static_cast<char>('0' + dia / 10);
+    destino[9] = static_cast<char>('0' + dia % 10);
+    return LARGO_TEXTO;
+}
+
+// Versión de formatear que retorna un std::string
+std::string Fecha::texto() const {
+    char buffer[LARGO_TEXTO];
+    return std::string(buffer, formatear(buffer));
+}
+
+// Obtiene la fecha local actual sin pasar por strftime
+Fecha Fecha::hoy() {
+    std::time_t now = std::time(nullptr);
+    std::tm tm_now;
+#ifdef _WIN32
+    localtime_s(&tm_now, &now); // Versión segura para Windows
+#else
+    localtime_r(&now, &tm_now); // Versión segura para sistemas POSIX
+#endif
+    return desdeCivil(tm_now.tm_year + 1900, tm_now.tm_mon + 1, tm_now.tm_mday);
+}
+
+std::ostream& operator<<(std::ostream& os, Fecha f) {
+    char buffer[Fecha::LARGO_TEXTO];
+    return os.write(buffer, static_cast<std::streamsize>(f.formatear(buffer)));
+}
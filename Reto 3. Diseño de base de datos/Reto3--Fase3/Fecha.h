@@ -0,0 +1,39 @@
+#ifndef FECHA_H
+#define FECHA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+// Fecha compacta: dias transcurridos desde 1970-01-01 en un entero de 32 bits.
+// Permite comparar y filtrar por rangos con operaciones enteras.
+struct Fecha {
+    static constexpr std::int32_t SIN_FECHA = std::numeric_limits<std::int32_t>::min(); // "No devuelto"
+    static constexpr std::size_t LARGO_TEXTO = 10; // Longitud de "YYYY-MM-DD"
+
+    std::int32_t dias = SIN_FECHA;  // Dias desde la epoca, o SIN_FECHA si esta vacia
+
+    bool vacia() const { return dias == SIN_FECHA; }
+
+    static Fecha desdeCivil(int anio, int mes, int dia);   // Construye a partir de anio/mes/dia
+    void aCivil(int& anio, int& mes, int& dia) const;      // Descompone en anio/mes/dia
+    static bool parsear(std::string_view s, Fecha& f);     // Lee "YYYY-MM-DD" valida; "" produce una fecha vacia
+    std::size_t formatear(char* destino) const;            // Escribe "YYYY-MM-DD" (0 caracteres si vacia)
+    std::string texto() const;                             // "YYYY-MM-DD", o "" si vacia
+    static Fecha hoy();                                    // Fecha local actual
+
+    bool operator==(Fecha o) const { return dias == o.dias; }
+    bool operator!=(Fecha o) const { return dias != o.dias; }
+    bool operator<(Fecha o) const { return dias < o.dias; }
+    bool operator<=(Fecha o) const { return dias <= o.dias; }
+    bool operator>(Fecha o) const { return dias > o.dias; }
+    bool operator>=(Fecha o) const { return dias >= o.dias; }
+};
+
+// Imprime la fecha en formato YYYY-MM-DD (nada si esta vacia)
+std::ostream& operator<<(std::ostream& os, Fecha f);
+
+#endif // FECHA_H
@@ -0,0 +1,137 @@
+#include "IndicePrefijos.h"
+#include "IndiceTexto.h"
+#include <algorithm>
+#include <climits>
+
+namespace {
+
+// Cambios pendientes (altas + bajas) permitidos antes de fundir: 1/16 del arreglo
+const std::size_t MINIMO_PENDIENTES = 1024;
+const std::size_t FRACCION_PENDIENTES = 16;
+
+bool empiezaCon(std::string_view texto, std::string_view prefijo) {
+    return texto.size() >= prefijo.size() && texto.compare(0, prefijo.size(), prefijo) == 0;
+}
+
+// Orden total de las entradas: clave y, a igual clave, ID
+bool menor(std::string_view a, int idA, std::string_view b, int idB) {
+    int c = a.compare(b);
+    return c != 0 ? c < 0 : idA < idB;
+}
+
+} // namespace
+
+std::string_view IndicePrefijos::clave(std::size_t i) const {
+    std::size_t fin = i + 1 < ordenadas.size() ? ordenadas[i + 1].inicio : claves.size();
+    return std::string_view(claves).substr(ordenadas[i].inicio, fin - ordenadas[i].inicio);
+}
+
+// Posición de la primera entrada del arreglo que no es menor que (clave, id)
+std::size_t IndicePrefijos::primeraNoMenor(std::string_view c, int id) const {
+    std::size_t desde = 0, hasta = ordenadas.size();
+    while (desde < hasta) {
+        std::size_t medio = desde + (hasta - desde) / 2;
+        if (menor(clave(medio), ordenadas[medio].id, c, id)) {
+            desde = medio + 1;
+        } else {
+            hasta = medio;
+        }
+    }
+    return desde;
+}
+
+// Ordena las entradas y las empaqueta como nuevo arreglo principal
+void IndicePrefijos::fundir(std::vector<std::pair<std::string, int>>& entradas) {
+    std::sort(entradas.begin(), entradas.end());
+    std::size_t total = 0;
+    for (const auto& e : entradas) total += e.first.size();
+    claves.clear();
+    claves.reserve(total);
+    ordenadas.clear();
+    ordenadas.reserve(entradas.size());
+    for (const auto& e : entradas) {
+        ordenadas.push_back({static_cast<std::uint32_t>(claves.size()), e.second});
+        claves += e.first;
+    }
+    recientes.clear();
+    borrados.clear();
+}
+
+void IndicePrefijos::construir(const std::vector<std::pair<int, std::string_view>>& documentos) {
+    std::vector<std::pair<std::string, int>> entradas;
+    entradas.reserve(documentos.size());
+    for (const auto& d : documentos) {
+        std::string normal = IndiceTexto::normalizar(d.second);
+        if (!normal.empty()) entradas.emplace_back(std::move(normal), d.first);
+    }
+    fundir(entradas);
+}
+
+// Funde las altas y bajas pendientes cuando ya pesan en cada consulta
+void IndicePrefijos::compactarSiHaceFalta() {
+    if (recientes.size() + borrados.size() <= std::max(MINIMO_PENDIENTES, ordenadas.size() / FRACCION_PENDIENTES)) {
+        return;
+    }
+    std::vector<std::pair<std::string, int>> entradas;
+    entradas.reserve(documentos());
+    for (std::size_t i = 0; i < ordenadas.size(); ++i) {
+        if (!borrados.count(ordenadas[i].id)) entradas.emplace_back(std::string(clave(i)), ordenadas[i].id);
+    }
+    entradas.insert(entradas.end(), recientes.begin(), recientes.end());
+    fundir(entradas);
+}
+
+void IndicePrefijos::agregar(int id, std::string_view texto) {
+    std::string normal = IndiceTexto::normalizar(texto);
+    if (normal.empty()) return;
+    recientes.emplace(std::move(normal), id);
+    compactarSiHaceFalta();
+}
+
+// Quita la alta reciente o marca como borrada la entrada del arreglo
+void IndicePrefijos::eliminar(int id, std::string_view texto) {
+    std::string normal = IndiceTexto::normalizar(texto);
+    if (normal.empty()) return;
+    if (recientes.erase({normal, id})) return;
+    std::size_t i = primeraNoMenor(normal, id);
+    if (i < ordenadas.size() && ordenadas[i].id == id && clave(i) == normal) {
+        borrados.insert(id);
+        compactarSiHaceFalta();
+    }
+}
+
+void IndicePrefijos::limpiar() {
+    claves.clear();
+    ordenadas.clear();
+    recientes.clear();
+    borrados.clear();
+}
+
+// Recorre en paralelo el arreglo y las altas recientes desde el prefijo, en orden
+std::vector<int> IndicePrefijos::completar(std::string_view prefijo, std::size_t k, std::size_t saltar) const {
+    std::string p = IndiceTexto::normalizar(prefijo);
+    // Un separador final pide que la palabra esté completa ("ana " no completa "anabel")
+    if (!p.empty() && !prefijo.empty() && prefijo.back() == ' ') p += ' ';
+
+    std::vector<int> ids;
+    std::size_t i = primeraNoMenor(p, INT_MIN);
+    auto r = recientes.lower_bound({p, INT_MIN});
+    while (ids.size() < k) {
+        while (i < ordenadas.size() && borrados.count(ordenadas[i].id)) ++i;
+        bool hayArreglo = i < ordenadas.size() && empiezaCon(clave(i), p);
+        bool hayReciente = r != recientes.end() && empiezaCon(r->first, p);
+        if (!hayArreglo && !hayReciente) break;
+        int id;
+        if (hayArreglo && (!hayReciente || menor(clave(i), ordenadas[i].id, r->first, r->second))) {
+            id = ordenadas[i++].id;
+        } else {
+            id = (r++)->second;
+        }
+        if (saltar > 0) {
+            --saltar;
+        } else {
+            ids.push_back(id);
+        }
+    }
+    return ids;
+}
@@ -0,0 +1,48 @@
+#ifndef INDICE_PREFIJOS_H
+#define INDICE_PREFIJOS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+// Indice de autocompletado: texto normalizado (ver IndiceTexto::normalizar) -> ID,
+// en orden alfabetico. La mayor parte vive en un arreglo ordenado y compacto (las claves
+// contiguas en un solo bloque de caracteres) donde el prefijo se ubica por busqueda binaria.
+// Las altas recientes van a un conjunto ordenado y las bajas marcan el ID como borrado;
+// ambos se funden con el arreglo cuando superan una fraccion de su tamano.
+class IndicePrefijos {
+public:
+    // Reemplaza el contenido por los documentos dados (ID, texto); para la carga inicial
+    void construir(const std::vector<std::pair<int, std::string_view>>& documentos);
+    void agregar(int id, std::string_view texto);
+    void eliminar(int id, std::string_view texto);   // Texto con el que se agrego
+    void limpiar();
+    std::size_t documentos() const { return ordenadas.size() - borrados.size() + recientes.size(); }
+
+    // IDs de hasta k documentos cuyo texto empieza por el prefijo, en orden alfabetico.
+    // 'saltar' omite los primeros resultados (pagina siguiente de la misma consulta).
+    std::vector<int> completar(std::string_view prefijo, std::size_t k, std::size_t saltar = 0) const;
+
+private:
+    // Entrada del arreglo principal; la clave termina donde empieza la siguiente
+    struct Ranura {
+        std::uint32_t inicio;   // Posicion de la clave en 'claves'
+        int id;
+    };
+    std::string claves;                                // Claves del arreglo principal, en orden
+    std::vector<Ranura> ordenadas;                     // Ordenadas por (clave, ID)
+    std::set<std::pair<std::string, int>> recientes;  // Altas aun no fundidas
+    std::unordered_set<int> borrados;                  // IDs del arreglo dados de baja
+
+    std::string_view clave(std::size_t i) const;
+    std::size_t primeraNoMenor(std::string_view clave, int id) const; // Busqueda binaria en 'ordenadas'
+    void fundir(std::vector<std::pair<std::string, int>>& entradas); // Reconstruye el arreglo
+    void compactarSiHaceFalta();
+};
+
+#endif // INDICE_PREFIJOS_H
@@ -0,0 +1,253 @@
+#include "IndiceTexto.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+namespace {
+
+// Letras base de los caracteres Latin-1 0xC0..0xFF (' ' = separador)
+const char PLEGADO_LATIN1[] = "aaaaaaaceeeeiiiidnooooo ouuuuy s"
+                              "aaaaaaaceeeeiiiidnooooo ouuuuy y";
+
+// Parámetros de BM25
+const double K1 = 1.2;
+const double B = 0.75;
+
+// Letra ASCII minúscula equivalente a un byte alfanumérico, o 0 si es separador
+char normalizarAscii(unsigned char c) {
+    if (c >= 'A' && c <= 'Z') return static_cast<char>(c - 'A' + 'a');
+    if ((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9')) return static_cast<char>(c);
+    return 0;
+}
+
+// Letra base de un código Latin-1 >= 0xC0, o 0 si no es una letra
+char plegarLatin1(unsigned char c) {
+    char base = PLEGADO_LATIN1[c - 0xC0];
+    return base == ' ' ? 0 : base;
+}
+
+bool esContinuacion(unsigned char c) {
+    return c >= 0x80 && c <= 0xBF;
+}
+
+} // namespace
+
+// Minúsculas sin acentos, con los términos separados por un espacio; acepta UTF-8 y Latin-1
+std::string IndiceTexto::normalizar(std::string_view texto) {
+    std::string normal;
+    normal.reserve(texto.size());
+    bool separar = false;
+    for (std::size_t i = 0; i < texto.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(texto[i]);
+        char letra = 0;
+        if (c < 0x80) {
+            letra = normalizarAscii(c);
+        } else if (c == 0xC3 && i + 1 < texto.size() && esContinuacion(static_cast<unsigned char>(texto[i + 1]))) {
+            // UTF-8 de U+00C0..U+00FF: mismo plegado que Latin-1
+            letra = plegarLatin1(static_cast<unsigned char>(texto[++i]) + 0x40);
+        } else if (c >= 0xC0 && (i + 1 >= texto.size() || !esContinuacion(static_cast<unsigned char>(texto[i + 1])))) {
+            letra = plegarLatin1(c); // Byte Latin-1 suelto
+        } else {
+            // Otro carácter multibyte: separador; se saltan sus bytes de continuación
+            while (i + 1 < texto.size() && esContinuacion(static_cast<unsigned char>(texto[i + 1]))) ++i;
+        }
+        if (!letra) {
+            separar = !normal.empty();
+            continue;
+        }
+        if (separar) normal += ' ';
+        separar = false;
+        normal += letra;
+    }
+    return normal;
+}
+
+// Términos normalizados del texto, ordenados y sin repetir
+void IndiceTexto::tokenizar(std::string_view texto, std::vector<std::string>& terminos) {
+    terminos.clear();
+    std::string normal = normalizar(texto);
+    std::size_t inicio = 0;
+    while (inicio < normal.size()) {
+        std::size_t fin = normal.find(' ', inicio);
+        if (fin == std::string::npos) fin = normal.size();
+        terminos.emplace_back(normal, inicio, fin - inicio);
+        inicio = fin + 1;
+    }
+    std::sort(terminos.begin(), terminos.end());
+    terminos.erase(std::unique(terminos.begin(), terminos.end()), terminos.end());
+}
+
+// Agrega el documento al grupo de su largo en la lista de cada término
+void IndiceTexto::agregar(int id, std::string_view texto) {
+    tokenizar(texto, temporal);
+    if (temporal.empty()) return;
+    std::uint16_t largo = static_cast<std::uint16_t>(std::min<std::size_t>(temporal.size(), 65535));
+    for (const auto& t : temporal) {
+        Lista& lista = apariciones[t];
+        auto grupo = std::lower_bound(lista.grupos.begin(), lista.grupos.end(), largo,
+                                      [](const Grupo& g, std::uint16_t v) { return g.largo < v; });
+        if (grupo == lista.grupos.end() || grupo->largo != largo) grupo = lista.grupos.insert(grupo, {largo, {}});
+        auto& ids = grupo->ids;
+        // Los IDs nuevos suelen ser los mayores: se anexan sin desplazar
+        if (ids.empty() || ids.back() < id) {
+            ids.push_back(id);
+            ++lista.documentos;
+            continue;
+        }
+        auto pos = std::lower_bound(ids.begin(), ids.end(), id);
+        if (pos == ids.end() || *pos != id) {
+            ids.insert(pos, id);
+            ++lista.documentos;
+        }
+    }
+    ++numDocumentos;
+    totalTerminos += largo;
+}
+
+// Quita el documento de las listas de los términos de su texto
+void IndiceTexto::eliminar(int id, std::string_view texto) {
+    tokenizar(texto, temporal);
+    if (temporal.empty()) return;
+    std::uint16_t largo = static_cast<std::uint16_t>(std::min<std::size_t>(temporal.size(), 65535));
+    bool encontrado = false;
+    for (const auto& t : temporal) {
+        auto it = apariciones.find(t);
+        if (it == apariciones.end()) continue;
+        Lista& lista = it->second;
+        auto grupo = std::lower_bound(lista.grupos.begin(), lista.grupos.end(), largo,
+                                      [](const Grupo& g, std::uint16_t v) { return g.largo < v; });
+        if (grupo == lista.grupos.end() || grupo->largo != largo) continue;
+        auto pos = std::lower_bound(grupo->ids.begin(), grupo->ids.end(), id);
+        if (pos == grupo->ids.end() || *pos != id) continue;
+        encontrado = true;
+        grupo->ids.erase(pos);
+        if (grupo->ids.empty()) lista.grupos.erase(grupo);
+        if (--lista.documentos == 0) apariciones.erase(it);
+    }
+    if (encontrado) {
+        --numDocumentos;
+        totalTerminos -= largo;
+    }
+}
+
+void IndiceTexto::limpiar() {
+    apariciones.clear();
+    numDocumentos = 0;
+    totalTerminos = 0;
+}
+
+// Recorre los grupos de largo en orden creciente. En cada uno, los términos se ordenan por
+// idf (su peso en el grupo es proporcional) y los primeros, cuyos pesos sumados no superan
+// al k-ésimo mejor, solo se consultan por búsqueda binaria para los candidatos de los demás
+std::vector<Acierto> IndiceTexto::buscar(const std::vector<std::string>& terminos, std::size_t k) const {
+    std::vector<Acierto> mejores; // Montículo: el peor de los k primero
+    if (numDocumentos == 0 || k == 0) return mejores;
+
+    double n = static_cast<double>(numDocumentos);
+    double media = static_cast<double>(totalTerminos) / n;
+    struct Cursor {
+        const Lista* lista;
+        double idf;
+        std::size_t grupo = 0;      // Siguiente grupo por recorrer
+        const std::vector<int>* ids = nullptr; // Del grupo actual, o nulo si no tiene
+        std::size_t pos = 0;
+        double peso = 0.0;          // Peso en el grupo actual (0 si no tiene)
+        bool coincide = false;      // Contiene al candidato actual
+    };
+    std::vector<Cursor> cursores;
+    for (const auto& t : terminos) {
+        auto it = apariciones.find(t);
+        if (it == apariciones.end()) continue;
+        double df = static_cast<double>(it->second.documentos);
+        cursores.push_back({&it->second, std::log(1.0 + (n - df + 0.5) / (df + 0.5))});
+    }
+    std::sort(cursores.begin(), cursores.end(), [](const Cursor& a, const Cursor& b) { return a.idf < b.idf; });
+    std::vector<double> acumulado(cursores.size()); // Pesos sumados de los cursores 0..i en el grupo
+
+    auto mejor = [](const Acierto& a, const Acierto& b) {
+        return a.puntaje != b.puntaje ? a.puntaje > b.puntaje : a.id < b.id;
+    };
+    // Un documento con puntaje a lo sumo 'cota' e ID mayor o igual que 'id' no entra en los k
+    auto descartable = [&](double cota, int id) {
+        if (mejores.size() < k) return false;
+        const Acierto& peor = mejores.front();
+        return cota < peor.puntaje || (cota == peor.puntaje && id >= peor.id);
+    };
+
+    while (true) {
+        // Grupo siguiente: el menor largo pendiente entre los términos
+        int largo = INT_MAX;
+        for (const Cursor& c : cursores) {
+            if (c.grupo < c.lista->grupos.size()) largo = std::min<int>(largo, c.lista->grupos[c.grupo].largo);
+        }
+        if (largo == INT_MAX) break;
+        double factor = (K1 + 1) / (1 + K1 * (1 - B + B * largo / media));
+        double restante = 0.0; // Los grupos siguientes pesan menos: cota de todo lo que falta
+        for (std::size_t i = 0; i < cursores.size(); ++i) {
+            Cursor& c = cursores[i];
+            bool pendiente = c.grupo < c.lista->grupos.size();
+            bool enGrupo = pendiente && c.lista->grupos[c.grupo].largo == largo;
+            c.ids = enGrupo ? &c.lista->grupos[c.grupo++].ids : nullptr;
+            c.pos = 0;
+            c.peso = enGrupo ? c.idf * factor : 0.0;
+            if (pendiente) restante += c.idf * factor;
+            acumulado[i] = (i ? acumulado[i - 1] : 0.0) + c.peso;
+        }
+        if (descartable(restante, INT_MIN)) break;
+
+        std::size_t esencial = 0; // Primer cursor que propone candidatos
+        int ultimo = INT_MIN;     // Los candidatos del grupo llegan por ID creciente
+        while (true) {
+            while (esencial < cursores.size() && descartable(acumulado[esencial], ultimo)) ++esencial;
+            int id = INT_MAX;
+            for (std::size_t i = esencial; i < cursores.size(); ++i) {
+                const Cursor& c = cursores[i];
+                if (c.ids && c.pos < c.ids->size()) id = std::min(id, (*c.ids)[c.pos]);
+            }
+            if (id == INT_MAX) break;
+            ultimo = id;
+
+            double parcial = 0.0;
+            for (std::size_t i = esencial; i < cursores.size(); ++i) {
+                Cursor& c = cursores[i];
+                c.coincide = c.ids && c.pos < c.ids->size() && (*c.ids)[c.pos] == id;
+                if (c.coincide) {
+                    ++c.pos;
+                    parcial += c.peso;
+                }
+            }
+            bool descartado = false;
+            for (std::size_t i = esencial; i-- > 0;) {
+                Cursor& c = cursores[i];
+                c.coincide = false;
+                if (descartado || !c.ids) continue;
+                if (descartable(parcial + acumulado[i], id)) {
+                    descartado = true;
+                    continue;
+                }
+                auto desde = std::lower_bound(c.ids->begin() + static_cast<std::ptrdiff_t>(c.pos), c.ids->end(), id);
+                c.pos = static_cast<std::size_t>(desde - c.ids->begin());
+                c.coincide = desde != c.ids->end() && *desde == id;
+                if (c.coincide) parcial += c.peso;
+            }
+            if (descartado) continue;
+
+            // Suma en el orden de los cursores: documentos con los mismos términos y largo
+            // obtienen exactamente el mismo puntaje (y la misma cota en 'acumulado')
+            Acierto acierto{id, 0.0};
+            for (const Cursor& c : cursores) {
+                if (c.coincide) acierto.puntaje += c.peso;
+            }
+            if (mejores.size() < k) {
+                mejores.push_back(acierto);
+                std::push_heap(mejores.begin(), mejores.end(), mejor);
+            } else if (mejor(acierto, mejores.front())) {
+                std::pop_heap(mejores.begin(), mejores.end(), mejor);
+                mejores.back() = acierto;
+                std::push_heap(mejores.begin(), mejores.end(), mejor);
+            }
+        }
+    }
+    std::sort(mejores.begin(), mejores.end(), mejor);
+    return mejores;
+}
@@ -0,0 +1,59 @@
+#ifndef INDICE_TEXTO_H
+#define INDICE_TEXTO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Documento encontrado por una busqueda de texto, con su puntaje de relevancia
+struct Acierto {
+    int id;            // ID de la entidad (libro, autor o editorial)
+    double puntaje;    // Mayor es mas relevante
+};
+
+// Indice invertido sobre un campo de texto: termino normalizado -> IDs que lo contienen.
+// Los terminos se separan por caracteres no alfanumericos, en minusculas y sin acentos
+// (UTF-8 o Latin-1), de modo que "Soledad" y "soledád" coinciden con "soledad".
+class IndiceTexto {
+public:
+    void agregar(int id, std::string_view texto);    // Indexa el texto de un documento
+    void eliminar(int id, std::string_view texto);   // Quita el documento (con el texto indexado)
+    void limpiar();
+    void reservar(std::size_t terminos) { apariciones.reserve(terminos); } // Evita rehashes al indexar en bloque
+    std::size_t documentos() const { return numDocumentos; }
+
+    // Los k documentos mas relevantes para los terminos dados (puntaje BM25 con tf = 1), con
+    // resultado exacto (a igual puntaje, el ID menor). Con tf = 1 el peso de un termino solo
+    // depende del largo del documento, asi que se recorren los grupos de largo de los mas
+    // cortos (que pesan mas) a los mas largos y se termina cuando ni el maximo de los
+    // restantes supera al k-esimo; dentro de un grupo, la poda MaxScore deja de proponer
+    // candidatos de los terminos que sumados no lo alcanzan.
+    std::vector<Acierto> buscar(const std::vector<std::string>& terminos, std::size_t k) const;
+
+    // Terminos normalizados y sin repetir de un texto
+    static void tokenizar(std::string_view texto, std::vector<std::string>& terminos);
+
+    // Texto en minusculas y sin acentos, con un espacio entre terminos ("Cien Años" -> "cien anos")
+    static std::string normalizar(std::string_view texto);
+
+private:
+    // Documentos de un termino con el mismo largo (terminos del documento, para la
+    // normalizacion por longitud): todos pesan lo mismo para el termino
+    struct Grupo {
+        std::uint16_t largo;
+        std::vector<int> ids;              // Ordenados
+    };
+    struct Lista {
+        std::vector<Grupo> grupos;         // Por largo creciente
+        std::size_t documentos = 0;
+    };
+    std::unordered_map<std::string, Lista> apariciones;
+    std::size_t numDocumentos = 0;
+    std::size_t totalTerminos = 0;           // Suma de largos, para la longitud media
+    std::vector<std::string> temporal;       // Reutilizado al tokenizar
+};
+
+#endif // INDICE_TEXTO_H
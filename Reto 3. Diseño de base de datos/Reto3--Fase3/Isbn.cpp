@@ -0,0 +1,89 @@
+#include "Isbn.h"
+
+namespace {
+
+const int DIGITO_X = 10;
+
+// Empaqueta los dígitos con la cantidad en el nibble alto
+std::uint64_t empaquetar(const int* d, std::size_t n) {
+    std::uint64_t v = static_cast<std::uint64_t>(n) << 60;
+    for (std::size_t i = 0; i < n; ++i) v |= static_cast<std::uint64_t>(d[i]) << (4 * (n - 1 - i));
+    return v;
+}
+
+// ISBN-10 con dígito de control correcto: suma ponderada 10..1 divisible entre 11
+bool esIsbn10(const int* d) {
+    int suma = 0;
+    for (int i = 0; i < 10; ++i) {
+        if (d[i] == DIGITO_X && i != 9) return false;
+        suma += d[i] * (10 - i);
+    }
+    return suma % 11 == 0;
+}
+
+} // namespace
+
+// Los separadores se ignoran; los ISBN-10 válidos pasan a su forma ISBN-13.
+// Se aceptan ISBN con control incorrecto para no perder datos heredados.
+bool Isbn::parsear(std::string_view s, Isbn& isbn) {
+    int d[MAX_DIGITOS];
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < s.size(); ++i) {
+        char c = s[i];
+        if (c == '-' || c == ' ') continue;
+        if (n == MAX_DIGITOS) return false;
+        if (c >= '0' && c <= '9') {
+            d[n++] = c - '0';
+        } else if ((c == 'X' || c == 'x') && s.find_first_not_of("- ", i + 1) == std::string_view::npos) {
+            d[n++] = DIGITO_X; // Solo como último dígito
+        } else {
+            return false;
+        }
+    }
+    if (n == 0) return false;
+    if (n == 10 && esIsbn10(d)) {
+        // 978 + los nueve primeros dígitos + nuevo control (pesos alternos 1 y 3)
+        int trece[13] = {9, 7, 8};
+        int suma = 9 + 7 * 3 + 8;
+        for (int i = 0; i < 9; ++i) {
+            trece[3 + i] = d[i];
+            suma += d[i] * ((3 + i) % 2 == 0 ? 1 : 3);
+        }
+        trece[12] = (10 - suma % 10) % 10;
+        isbn.valor = empaquetar(trece, 13);
+        return true;
+    }
+    isbn.valor = empaquetar(d, n);
+    return true;
+}
+
+// Un ISBN-10 válido ya se convirtió a ISBN-13 al leerlo: cualquier otro largo es incorrecto
+bool Isbn::controlValido() const {
+    if (digitos() != 13) return false;
+    int suma = 0;
+    for (std::size_t i = 0; i < 13; ++i) {
+        int d = static_cast<int>((valor >> (4 * (12 - i))) & 0xF);
+        if (d == DIGITO_X) return false;
+        suma += d * (i % 2 == 0 ? 1 : 3);
+    }
+    return suma % 10 == 0;
+}
+
+std::size_t Isbn::formatear(char* destino) const {
+    std::size_t n = digitos();
+    for (std::size_t i = 0; i < n; ++i) {
+        int d = static_cast<int>((valor >> (4 * (n - 1 - i))) & 0xF);
+        destino[i] = d == DIGITO_X ? 'X' : static_cast<char>('0' + d);
+    }
+    return n;
+}
+
+std::string Isbn::texto() const {
+    char buffer[MAX_DIGITOS];
+    return std::string(buffer, formatear(buffer));
+}
+
+std::ostream& operator<<(std::ostream& os, Isbn isbn) {
+    char buffer[Isbn::MAX_DIGITOS];
+    return os.write(buffer, static_cast<std::streamsize>(isbn.formatear(buffer)));
+}
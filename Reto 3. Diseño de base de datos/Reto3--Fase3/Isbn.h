@@ -0,0 +1,37 @@
+#ifndef ISBN_H
+#define ISBN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+// ISBN normalizado y empaquetado en 64 bits: un digito por nibble (X = 0xA) con la
+// cantidad de digitos en el nibble alto. Guiones y espacios se descartan al leer y
+// un ISBN-10 valido se convierte a su ISBN-13 (prefijo 978), de modo que
+// "0-306-40615-2", "978-0-306-40615-7" y "9780306406157" son la misma clave.
+// parsear acepta tambien ISBN con control incorrecto (datos heredados de los CSV); las
+// entradas del usuario y de los lotes deben exigir controlValido() (o esIsbnValido).
+struct Isbn {
+    static constexpr std::size_t MAX_DIGITOS = 15;
+
+    std::uint64_t valor = 0;   // 0 si no hay ISBN
+
+    bool vacio() const { return valor == 0; }
+    std::size_t digitos() const { return static_cast<std::size_t>(valor >> 60); }
+    bool controlValido() const;   // ISBN-13 con digito de control correcto (o ISBN-10 valido convertido)
+
+    static bool parsear(std::string_view s, Isbn& isbn);   // Digitos (y X final) con separadores opcionales
+    std::size_t formatear(char* destino) const;            // Escribe los digitos sin separadores
+    std::string texto() const;                             // Digitos sin separadores, o "" si vacio
+
+    bool operator==(Isbn o) const { return valor == o.valor; }
+    bool operator!=(Isbn o) const { return valor != o.valor; }
+    bool operator<(Isbn o) const { return valor < o.valor; }
+};
+
+// Imprime los digitos del ISBN (nada si esta vacio)
+std::ostream& operator<<(std::ostream& os, Isbn isbn);
+
+#endif // ISBN_H
@@ -0,0 +1,136 @@
+#include "LectorCSV.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+
+namespace csv {
+
+// Lee el archivo en un único bloque, evitando la lectura línea por línea
+bool leerArchivo(const std::string& ruta, std::string& buffer) {
+    buffer.clear();
+    std::FILE* f = std::fopen(ruta.c_str(), "rb");
+    if (!f) return false;
+    // Obtiene el tamaño para reservar el buffer de una vez
+    if (std::fseek(f, 0, SEEK_END) == 0) {
+        long tam = std::ftell(f);
+        if (tam > 0) buffer.resize(static_cast<std::size_t>(tam));
+        std::fseek(f, 0, SEEK_SET);
+    }
+    std::size_t leidos = buffer.empty() ? 0 : std::fread(&buffer[0], 1, buffer.size(), f);
+    buffer.resize(leidos);
+    // Si el tamaño no se pudo determinar, lee por bloques hasta el final
+    char bloque[1 << 16];
+    std::size_t n;
+    while ((n = std::fread(bloque, 1, sizeof(bloque), f)) > 0) {
+        buffer.append(bloque, n);
+    }
+    std::fclose(f);
+    return true;
+}
+
+// Cuenta los saltos de línea, más una línea final sin '\n'
+std::size_t contarLineas(std::string_view buffer) {
+    std::size_t n = static_cast<std::size_t>(std::count(buffer.begin(), buffer.end(), '\n'));
+    if (!buffer.empty() && buffer.back() != '\n') ++n;
+    return n;
+}
+
+// Cada trozo se extiende hasta el siguiente salto de línea, así que ninguna línea queda partida
+std::vector<std::string_view> dividirEnTrozos(std::string_view buffer, std::size_t bytes) {
+    std::vector<std::string_view> trozos;
+    while (!buffer.empty()) {
+        std::size_t fin = buffer.size();
+        if (bytes < buffer.size()) {
+            std::size_t salto = buffer.find('\n', bytes > 0 ? bytes - 1 : 0);
+            if (salto != std::string_view::npos) fin = salto + 1;
+        }
+        trozos.push_back(buffer.substr(0, fin));
+        buffer.remove_prefix(fin);
+    }
+    return trozos;
+}
+
+// Separa la primera línea de 'resto'; tolera finales de línea de Windows
+bool siguienteLinea(std::string_view& resto, std::string_view& linea) {
+    if (resto.empty()) return false;
+    const void* salto = std::memchr(resto.data(), '\n', resto.size());
+    std::size_t fin = salto ? static_cast<std::size_t>(static_cast<const char*>(salto) - resto.data()) : resto.size();
+    linea = resto.substr(0, fin);
+    resto.remove_prefix(salto ? fin + 1 : fin);
+    if (!linea.empty() && linea.back() == '\r') linea.remove_suffix(1);
+    return true;
+}
+
+// Recorre la línea una sola vez; los campos conservan sus comillas hasta asignarCampo
+std::size_t dividirCampos(std::string_view linea, char delimitador, std::string_view* campos, std::size_t maxCampos) {
+    std::size_t n = 0;
+    std::size_t inicio = 0;
+    bool enComillas = false;
+    for (std::size_t i = 0; i < linea.size() && n < maxCampos; ++i) {
+        char c = linea[i];
+        if (c == '"') {
+            enComillas = !enComillas;
+        } else if (c == delimitador && !enComillas) {
+            campos[n++] = linea.substr(inicio, i - inicio);
+            inicio = i + 1;
+        }
+    }
+    // El último campo se añade aunque esté vacío (p. ej. fecha de devolución pendiente)
+    if (n < maxCampos && inicio <= linea.size()) {
+        campos[n++] = linea.substr(inicio);
+    }
+    return n;
+}
+
+// Convierte con from_chars, ignorando espacios alrededor del número
+bool parsearEntero(std::string_view campo, int& valor) {
+    while (!campo.empty() && (campo.front() == ' ' || campo.front() == '\t')) campo.remove_prefix(1);
+    while (!campo.empty() && (campo.back() == ' ' || campo.back() == '\t')) campo.remove_suffix(1);
+    if (campo.empty()) return false;
+    const char* fin = campo.data() + campo.size();
+    auto res = std::from_chars(campo.data(), fin, valor);
+    return res.ec == std::errc() && res.ptr == fin;
+}
+
+// Copia el campo una sola vez; solo recorre carácter a carácter si hay comillas o ';'
+void asignarCampo(std::string_view campo, std::string& destino) {
+    if (campo.find_first_of("\";") == std::string_view::npos) {
+        destino.assign(campo.data(), campo.size());
+        return;
+    }
+    destino.clear();
+    destino.reserve(campo.size());
+    for (char c : campo) {
+        if (c == '"') continue;          // Las comillas solo agrupan, no forman parte del valor
+        destino += (c == ';') ? '|' : c; // Restaura las barras verticales escapadas
+    }
+}
+
+// Evita la copia cuando el campo ya está limpio (el caso común)
+std::string_view vistaCampo(std::string_view campo, std::string& espacio) {
+    if (campo.find_first_of("\";") == std::string_view::npos) return campo;
+    asignarCampo(campo, espacio);
+    return espacio;
+}
+
+void anexarEntero(std::string& destino, long long valor) {
+    char digitos[24];
+    auto r = std::to_chars(digitos, digitos + sizeof digitos, valor);
+    destino.append(digitos, static_cast<std::size_t>(r.ptr - digitos));
+}
+
+// Copia por tramos sin barras; el caso común (sin comas ni barras) es un solo append
+void anexarCampo(std::string& destino, std::string_view campo) {
+    bool comillas = campo.find(',') != std::string_view::npos;
+    if (comillas) destino += '"';
+    for (std::size_t barra; (barra = campo.find('|')) != std::string_view::npos;) {
+        destino.append(campo.data(), barra);
+        destino += ';';
+        campo.remove_prefix(barra + 1);
+    }
+    destino.append(campo.data(), campo.size());
+    if (comillas) destino += '"';
+}
+
+} // namespace csv
@@ -0,0 +1,50 @@
+#ifndef LECTOR_CSV_H
+#define LECTOR_CSV_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Utilidades para leer archivos CSV sin copias intermedias: el archivo se lee
+// completo a un buffer y las lineas/campos se recorren como std::string_view.
+// Para escribir, las filas se formatean al final de un bloque grande (anexar*).
+namespace csv {
+
+// Lee el archivo completo en 'buffer'; retorna false si no se puede abrir
+bool leerArchivo(const std::string& ruta, std::string& buffer);
+
+// Cuenta las lineas de un buffer (para reservar memoria antes de cargar)
+std::size_t contarLineas(std::string_view buffer);
+
+// Divide el buffer en trozos de unos 'bytes' que terminan en fin de linea, para
+// interpretarlos en paralelo; concatenados reproducen el buffer
+std::vector<std::string_view> dividirEnTrozos(std::string_view buffer, std::size_t bytes);
+
+// Extrae la siguiente linea de 'resto' (sin '\n' ni '\r' final) y avanza 'resto'
+bool siguienteLinea(std::string_view& resto, std::string_view& linea);
+
+// Divide una linea en campos separados por 'delimitador', respetando comillas.
+// Retorna el numero de campos encontrados (como maximo 'maxCampos').
+std::size_t dividirCampos(std::string_view linea, char delimitador, std::string_view* campos, std::size_t maxCampos);
+
+// Convierte un campo a entero con std::from_chars; retorna false si no es un numero
+bool parsearEntero(std::string_view campo, int& valor);
+
+// Materializa un campo en 'destino' quitando comillas y restaurando barras verticales
+void asignarCampo(std::string_view campo, std::string& destino);
+
+// Campo sin comillas ni barras escapadas: el mismo texto si no las tiene; si no, lo
+// materializa en 'espacio' y retorna una vista sobre el
+std::string_view vistaCampo(std::string_view campo, std::string& espacio);
+
+// Anexa el entero en decimal con std::to_chars
+void anexarEntero(std::string& destino, long long valor);
+
+// Anexa el campo escapado: barras verticales como ';' y entre comillas si tiene comas
+// (el inverso de asignarCampo), sin cadenas intermedias
+void anexarCampo(std::string& destino, std::string_view campo);
+
+} // namespace csv
+
+#endif // LECTOR_CSV_H
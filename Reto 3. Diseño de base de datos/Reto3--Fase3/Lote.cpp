@@ -0,0 +1,354 @@
+#include "Lote.h"
+#include "Biblioteca.h"
+#include "LectorCSV.h"
+#include "Validacion.h"
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace {
+
+const std::size_t MAX_PALABRAS = 5;
+const std::size_t MAX_CAMPOS = 5;
+
+bool esEspacio(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// Quita espacios al inicio y al final
+std::string_view recortar(std::string_view s) {
+    while (!s.empty() && esEspacio(s.front())) s.remove_prefix(1);
+    while (!s.empty() && esEspacio(s.back())) s.remove_suffix(1);
+    return s;
+}
+
+// Extrae la siguiente palabra de 'resto' y avanza; false si no quedan palabras
+bool siguientePalabra(std::string_view& resto, std::string_view& palabra) {
+    resto = recortar(resto);
+    if (resto.empty()) return false;
+    std::size_t fin = 0;
+    while (fin < resto.size() && !esEspacio(resto[fin])) ++fin;
+    palabra = resto.substr(0, fin);
+    resto.remove_prefix(fin);
+    return true;
+}
+
+// Divide una línea en palabras; retorna MAX_PALABRAS + 1 si sobran palabras
+std::size_t dividirPalabras(std::string_view linea, std::string_view* palabras) {
+    std::size_t n = 0;
+    std::string_view palabra;
+    while (siguientePalabra(linea, palabra)) {
+        if (n == MAX_PALABRAS) return MAX_PALABRAS + 1;
+        palabras[n++] = palabra;
+    }
+    return n;
+}
+
+// Lee una fecha opcional: sin palabra se usa 'hoy'
+bool leerFechaOpcional(const std::string_view* palabras, std::size_t n, std::size_t pos, Fecha hoy, Fecha& fecha) {
+    if (n <= pos) {
+        fecha = hoy;
+        return true;
+    }
+    return Fecha::parsear(palabras[pos], fecha) && !fecha.vacia();
+}
+
+// Divide los datos de "agregar" en campos de texto recortados; exige exactamente 'esperados'
+bool leerCampos(std::string_view datos, std::string* campos, std::size_t esperados) {
+    std::string_view vistas[MAX_CAMPOS];
+    if (csv::dividirCampos(datos, ',', vistas, MAX_CAMPOS) != esperados) return false;
+    for (std::size_t i = 0; i < esperados; ++i) {
+        csv::asignarCampo(recortar(vistas[i]), campos[i]);
+        if (campos[i].empty()) return false;
+    }
+    return true;
+}
+
+// Agrega una entidad con el siguiente ID libre; valida los textos igual que el menú
+bool agregar(BibliotecaDB& db, std::string_view tabla, std::string_view datos, int& id) {
+    std::string c[MAX_CAMPOS];
+    if (tabla == "estudiante") {
+        if (!leerCampos(datos, c, 2) || !esNombreValido(c[0]) || !esTextoValido(c[1])) return false;
+        id = db.nextEstudianteId();
+        return db.agregarEstudiante(id, c[0], c[1]);
+    }
+    if (tabla == "autor") {
+        if (!leerCampos(datos, c, 2) || !esNombreValido(c[0]) || !esTextoValido(c[1])) return false;
+        id = db.nextAutorId();
+        return db.agregarAutor(id, c[0], c[1]);
+    }
+    if (tabla == "editorial") {
+        if (!leerCampos(datos, c, 1) || !esTextoValido(c[0])) return false;
+        Editorial ed{db.nextEditorialId(), c[0]};
+        id = ed.id;
+        return db.agregarEditorial(ed);
+    }
+    if (tabla == "libro") {
+        Libro l;
+        if (!leerCampos(datos, c, 5) || !esTextoValido(c[0]) || !esIsbnValido(c[1]) || !Isbn::parsear(c[1], l.isbn) ||
+            !csv::parsearEntero(c[2], l.anio) || !csv::parsearEntero(c[3], l.id_autor) ||
+            !csv::parsearEntero(c[4], l.id_editorial)) {
+            return false;
+        }
+        l.id = db.nextLibroId();
+        l.titulo = c[0];
+        id = l.id;
+        return db.agregarLibro(l);
+    }
+    return false;
+}
+
+// Anexa un campo de texto, entre comillas si contiene comas
+void anexarTexto(std::string& destino, std::string_view campo) {
+    destino += ',';
+    if (campo.find(',') == std::string::npos) {
+        destino += campo;
+    } else {
+        destino += '"';
+        destino += campo;
+        destino += '"';
+    }
+}
+
+// Resuelve una consulta por ID y deja la fila encontrada en 'respuesta'
+bool consultar(const BibliotecaDB& db, std::string_view tabla, int id, std::string& respuesta) {
+    respuesta = std::to_string(id);
+    if (tabla == "estudiante") {
+        const Estudiante* e = db.buscarEstudiantePorId(id);
+        if (!e) return false;
+        anexarTexto(respuesta, e->nombre);
+        anexarTexto(respuesta, db.textoGrado(e->grado));
+        return true;
+    }
+    if (tabla == "autor") {
+        const Autor* a = db.buscarAutorPorId(id);
+        if (!a) return false;
+        anexarTexto(respuesta, a->nombre);
+        anexarTexto(respuesta, db.textoNacionalidad(a->nacionalidad));
+        return true;
+    }
+    if (tabla == "editorial") {
+        const Editorial* ed = db.buscarEditorialPorId(id);
+        if (!ed) return false;
+        anexarTexto(respuesta, ed->nombre);
+        return true;
+    }
+    if (tabla == "libro") {
+        std::optional<Libro> l = db.buscarLibroPorId(id);
+        if (!l) return false;
+        anexarTexto(respuesta, l->titulo);
+        anexarTexto(respuesta, l->isbn.texto());
+        respuesta += "," + std::to_string(l->anio) + "," + std::to_string(l->id_autor) + "," +
+                     std::to_string(l->id_editorial);
+        return true;
+    }
+    if (tabla == "prestamo") {
+        std::optional<Prestamo> p = db.buscarPrestamoPorId(id);
+        if (!p) return false;
+        respuesta += "," + std::to_string(p->id_libro) + "," + std::to_string(p->id_estudiante) + "," +
+                     p->fecha_prestamo.texto() + "," + p->fecha_devolucion.texto();
+        return true;
+    }
+    if (tabla == "prestamos") {
+        respuesta.clear();
+        for (int idp : db.prestamosDeEstudiante(id)) {
+            if (!respuesta.empty()) respuesta += ' ';
+            respuesta += std::to_string(idp);
+        }
+        return db.buscarEstudiantePorId(id) != nullptr;
+    }
+    if (tabla == "activo") {
+        respuesta = std::to_string(db.prestamoActivoDeLibro(id));
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+// Línea vacía o comentario
+bool esIgnorable(std::string_view linea) {
+    std::size_t i = linea.find_first_not_of(" \t\r");
+    return i == std::string_view::npos || linea[i] == '#';
+}
+
+// Las consultas se reconocen por su primera palabra
+bool esConsulta(std::string_view linea) {
+    std::string_view palabra;
+    if (!siguientePalabra(linea, palabra)) return false;
+    return palabra == "estudiante" || palabra == "autor" || palabra == "editorial" || palabra == "libro" ||
+           palabra == "prestamo" || palabra == "prestamos" || palabra == "activo" || palabra == "resumen" ||
+           palabra == "isbn" || palabra == "libros" || palabra == "buscar" || palabra == "completar";
+}
+
+// Resuelve una consulta; solo lee la base, así que admite lectores concurrentes
+bool ejecutarConsulta(const BibliotecaDB& db, std::string_view linea, std::string* respuesta) {
+    std::string descartada;
+    std::string& r = respuesta ? *respuesta : descartada;
+    r.clear();
+
+    // "buscar" y "completar" llevan texto libre: se separa antes de contar palabras
+    std::string_view resto = linea;
+    std::string_view orden, tabla;
+    if (!siguientePalabra(resto, orden)) return false;
+    if (orden == "buscar") {
+        for (const Acierto& a : db.buscarTexto(resto).libros) {
+            if (!r.empty()) r += ' ';
+            r += std::to_string(a.id);
+        }
+        return true;
+    }
+    if (orden == "completar") {
+        if (!siguientePalabra(resto, tabla) || (tabla != "estudiante" && tabla != "libro")) return false;
+        std::vector<int> ids = tabla == "libro" ? db.completarLibros(resto) : db.completarEstudiantes(resto);
+        for (int id : ids) {
+            if (!r.empty()) r += ' ';
+            r += std::to_string(id);
+        }
+        return true;
+    }
+
+    std::string_view p[MAX_PALABRAS];
+    std::size_t n = dividirPalabras(linea, p);
+    if (n == 0 || n > MAX_PALABRAS) return false;
+
+    int a = 0, b = 0;
+    if (n == 1 && p[0] == "resumen") {
+        r = std::to_string(db.estudiantes.size()) + " " + std::to_string(db.autores.size()) + " " +
+            std::to_string(db.editoriales.size()) + " " + std::to_string(db.libros.size()) + " " +
+            std::to_string(db.prestamos.size());
+        return true;
+    }
+    if (n == 3 && p[0] == "libros" && csv::parsearEntero(p[2], a)) {
+        bool autor = p[1] == "autor";
+        if (!autor && p[1] != "editorial") return false;
+        if (autor ? !db.buscarAutorPorId(a) : !db.buscarEditorialPorId(a)) return false;
+        for (int id : autor ? db.librosDeAutor(a) : db.librosDeEditorial(a)) {
+            if (!r.empty()) r += ' ';
+            r += std::to_string(id);
+        }
+        return true;
+    }
+    if (n == 4 && p[0] == "libros" && p[1] == "anios" && csv::parsearEntero(p[2], a) && csv::parsearEntero(p[3], b)) {
+        for (int id : db.librosEntreAnios(a, b)) {
+            if (!r.empty()) r += ' ';
+            r += std::to_string(id);
+        }
+        return true;
+    }
+    if (n == 2 && p[0] == "isbn") {
+        std::optional<Libro> l = db.buscarLibroPorIsbn(p[1]);
+        return l && consultar(db, "libro", l->id, r);
+    }
+    if (n == 2 && csv::parsearEntero(p[1], a)) {
+        return consultar(db, p[0], a, r);
+    }
+    return false;
+}
+
+// Interpreta y aplica un comando sobre la base de datos; las consultas pasan a ejecutarConsulta
+bool ejecutarComando(BibliotecaDB& db, std::string_view linea, std::string* respuesta, Fecha hoy) {
+    if (esConsulta(linea)) return ejecutarConsulta(db, linea, respuesta);
+    std::string descartada;
+    std::string& r = respuesta ? *respuesta : descartada;
+    r.clear();
+
+    // "agregar" lleva texto libre: se separa antes de contar palabras
+    std::string_view resto = linea;
+    std::string_view orden, tabla;
+    if (!siguientePalabra(resto, orden)) return false;
+    if (orden == "agregar") {
+        int id = 0;
+        if (!siguientePalabra(resto, tabla) || !agregar(db, tabla, recortar(resto), id)) return false;
+        r = std::to_string(id);
+        return true;
+    }
+
+    std::string_view p[MAX_PALABRAS];
+    std::size_t n = dividirPalabras(linea, p);
+    if (n == 0 || n > MAX_PALABRAS) return false;
+
+    int a = 0, b = 0;
+    Fecha fecha;
+    if (p[0] == "prestar") {
+        if (!(n == 3 || n == 4) || !csv::parsearEntero(p[1], a) || !csv::parsearEntero(p[2], b) ||
+            !leerFechaOpcional(p, n, 3, hoy, fecha)) {
+            return false;
+        }
+        int id = db.nextPrestamoId();
+        if (!db.prestarLibro(a, b, fecha)) return false;
+        r = std::to_string(id);
+        return true;
+    }
+    if (p[0] == "devolver") {
+        return (n == 2 || n == 3) && csv::parsearEntero(p[1], a) &&
+               leerFechaOpcional(p, n, 2, hoy, fecha) && db.devolverPrestamo(a, fecha);
+    }
+    if (p[0] == "eliminar") {
+        if (n != 3 || !csv::parsearEntero(p[2], a)) return false;
+        if (p[1] == "estudiante") return db.eliminarEstudiante(a);
+        if (p[1] == "autor") return db.eliminarAutor(a);
+        if (p[1] == "editorial") return db.eliminarEditorial(a);
+        if (p[1] == "libro") return db.eliminarLibro(a);
+        return false;
+    }
+    return false;
+}
+
+namespace {
+
+// Comandos de transacción (solo en lotes) o, si no lo son, un comando común
+bool ejecutarEnLote(BibliotecaDB& db, std::string_view linea, std::string& respuesta) {
+    std::string_view orden = recortar(linea);
+    if (orden == "transaccion") return db.iniciarTransaccion();
+    if (orden == "confirmar") return db.confirmarTransaccion();
+    if (orden == "revertir") {
+        if (!db.transaccionActiva()) return false;
+        db.revertirTransaccion();
+        return true;
+    }
+    return ejecutarComando(db, linea, &respuesta);
+}
+
+} // namespace
+
+// Ejecuta el lote completo y escribe los cambios una sola vez al final
+ResultadoLote ejecutarLote(BibliotecaDB& db, std::istream& entrada, std::ostream& salida) {
+    ResultadoLote r;
+    auto inicio = std::chrono::steady_clock::now();
+    db.iniciarLote();
+
+    std::string linea;
+    std::string respuesta;
+    std::size_t numero = 0;
+    while (std::getline(entrada, linea)) {
+        ++numero;
+        if (esIgnorable(linea)) continue;
+        ++r.comandos;
+        respuesta.clear();
+        bool ok = ejecutarEnLote(db, linea, respuesta);
+        if (ok) {
+            ++r.exitosos;
+        } else {
+            ++r.fallidos;
+        }
+        salida << (ok ? "OK    " : "ERROR ") << "linea " << numero << ": " << linea;
+        if (ok && !respuesta.empty()) salida << " -> " << respuesta;
+        salida << "\n";
+    }
+
+    if (db.transaccionActiva()) {
+        salida << "Transaccion sin confirmar: se revierten sus cambios.\n";
+        db.revertirTransaccion();
+    }
+    r.persistido = db.terminarLote();
+    std::chrono::duration<double> d = std::chrono::steady_clock::now() - inicio;
+    r.segundos = d.count();
+
+    salida << "Lote: " << r.comandos << " comandos, " << r.exitosos << " exitosos, "
+           << r.fallidos << " fallidos en " << r.segundos << " s";
+    if (r.segundos > 0) salida << " (" << static_cast<long long>(r.comandos / r.segundos) << " comandos/s)";
+    salida << "\n";
+    if (!r.persistido) salida << "Error: no se pudieron guardar los cambios del lote.\n";
+    return r;
+}
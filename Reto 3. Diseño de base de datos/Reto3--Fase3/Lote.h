@@ -0,0 +1,66 @@
+#ifndef LOTE_H
+#define LOTE_H
+
+#include "Fecha.h"
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+class BibliotecaDB;
+
+// Resumen de la ejecucion de un lote de comandos
+struct ResultadoLote {
+    std::size_t comandos = 0;   // Comandos ejecutados (sin lineas vacias ni comentarios)
+    std::size_t exitosos = 0;   // Comandos aplicados correctamente
+    std::size_t fallidos = 0;   // Comandos rechazados o no reconocidos
+    double segundos = 0.0;      // Tiempo total, incluida la escritura final
+    bool persistido = false;    // true si la escritura final tuvo exito
+};
+
+// Comandos de texto (uno por linea) compartidos por el modo por lotes y el servidor.
+// Modificaciones:
+//   prestar <id_libro> <id_estudiante> [YYYY-MM-DD]     -> ID del prestamo creado
+//   devolver <id_prestamo> [YYYY-MM-DD]
+//   eliminar <estudiante|autor|editorial|libro> <id>
+//   agregar estudiante <nombre>,<grado>                -> ID creado (igual para el resto)
+//   agregar autor <nombre>,<nacionalidad>
+//   agregar editorial <nombre>
+//   agregar libro <titulo>,<isbn>,<anio>,<id_autor>,<id_editorial>
+// Consultas (la respuesta es la fila en formato CSV):
+//   estudiante|autor|editorial|libro|prestamo <id>
+//   prestamos <id_estudiante>                          -> IDs de sus prestamos
+//   activo <id_libro>                                  -> ID del prestamo activo o 0
+//   isbn <isbn>                                        -> fila del libro con ese ISBN
+//   libros <autor|editorial> <id>                      -> IDs de sus libros
+//   libros anios <desde> <hasta>                       -> IDs de los libros publicados en el rango
+//   buscar <texto>                                     -> IDs de los libros mas relevantes
+//   completar <estudiante|libro> <prefijo>             -> IDs en orden alfabetico (hasta 10)
+//   resumen                                            -> filas de cada tabla
+// Solo en ejecutarLote (no en el servidor, que atiende a varios clientes):
+//   transaccion | confirmar | revertir                 -> agrupa los comandos intermedios
+// Las lineas vacias y las que empiezan con '#' se ignoran. Sin fecha se usa la de hoy.
+
+// Ejecuta un comando; retorna false si no se reconoce o la base de datos lo rechaza.
+// Si 'respuesta' no es nulo recibe el resultado (ID creado o datos consultados).
+// 'hoy' es la fecha de los comandos sin fecha: con la misma fecha, el mismo comando
+// produce el mismo cambio (BibliotecaConcurrente lo aplica en sus dos copias).
+bool ejecutarComando(BibliotecaDB& db, std::string_view linea, std::string* respuesta = nullptr,
+                     Fecha hoy = Fecha::hoy());
+
+// Ejecuta una consulta (ver esConsulta) sin modificar la base; false si no se reconoce
+bool ejecutarConsulta(const BibliotecaDB& db, std::string_view linea, std::string* respuesta = nullptr);
+
+// true si el comando solo lee datos (puede ejecutarse en paralelo con otras consultas)
+bool esConsulta(std::string_view linea);
+
+// Linea vacia o comentario
+bool esIgnorable(std::string_view linea);
+
+// Ejecuta todos los comandos de 'entrada' con una sola escritura de datos al final,
+// informando en 'salida' el estado de cada comando y el rendimiento total.
+// Una transaccion sin confirmar al terminar la entrada se revierte.
+ResultadoLote ejecutarLote(BibliotecaDB& db, std::istream& entrada, std::ostream& salida);
+
+#endif // LOTE_H
@@ -0,0 +1,118 @@
+#include "Paralelo.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::atomic<std::size_t> auxiliaresEnUso{0}; // Suma de todas las llamadas en curso
+
+// Reserva hasta 'pedidos' auxiliares sin pasar del presupuesto; retorna los obtenidos
+std::size_t reservarAuxiliares(std::size_t pedidos) {
+    std::size_t maximo = hilosDisponibles() - 1;
+    std::size_t enUso = auxiliaresEnUso.load();
+    std::size_t obtenidos;
+    do {
+        obtenidos = std::min(pedidos, maximo > enUso ? maximo - enUso : 0);
+    } while (obtenidos > 0 && !auxiliaresEnUso.compare_exchange_weak(enUso, enUso + obtenidos));
+    return obtenidos;
+}
+
+// Hilos auxiliares creados una sola vez (uno por cada auxiliar del presupuesto) que esperan
+// tareas en una cola. Como nunca hay más tareas en curso que auxiliares reservados, cada
+// tarea encolada encuentra un hilo libre sin esperar a otra.
+class Grupo {
+public:
+    explicit Grupo(std::size_t n) {
+        for (std::size_t h = 0; h < n; ++h) hilos.emplace_back([this] { atender(); });
+    }
+
+    ~Grupo() {
+        {
+            std::lock_guard<std::mutex> lock(cerrojo);
+            parar = true;
+        }
+        hayTareas.notify_all();
+        for (auto& t : hilos) t.join();
+    }
+
+    Grupo(const Grupo&) = delete;
+    Grupo& operator=(const Grupo&) = delete;
+
+    void encolar(std::function<void()> tarea) {
+        {
+            std::lock_guard<std::mutex> lock(cerrojo);
+            tareas.push_back(std::move(tarea));
+        }
+        hayTareas.notify_one();
+    }
+
+private:
+    std::mutex cerrojo;
+    std::condition_variable hayTareas;
+    std::deque<std::function<void()>> tareas;
+    std::vector<std::thread> hilos;
+    bool parar = false;
+
+    void atender() {
+        for (;;) {
+            std::function<void()> tarea;
+            {
+                std::unique_lock<std::mutex> lock(cerrojo);
+                hayTareas.wait(lock, [this] { return parar || !tareas.empty(); });
+                if (tareas.empty()) return;
+                tarea = std::move(tareas.front());
+                tareas.pop_front();
+            }
+            tarea();
+        }
+    }
+};
+
+// Se crea en la primera llamada con auxiliares; sus hilos terminan al salir del programa
+Grupo& grupo() {
+    static Grupo g(hilosDisponibles() - 1);
+    return g;
+}
+
+} // namespace
+
+std::size_t hilosDisponibles() {
+    static const std::size_t nucleos = std::max(1u, std::thread::hardware_concurrency());
+    return nucleos;
+}
+
+// Las tareas de los auxiliares comparten 'siguiente' con el hilo que llama: una que empiece
+// tarde no encuentra índices pendientes y termina enseguida
+bool enParalelo(std::size_t n, const std::function<bool(std::size_t)>& f) {
+    std::vector<char> ok(n, 0);
+    std::atomic<std::size_t> siguiente{0};
+    auto trabajar = [&] {
+        for (std::size_t i; (i = siguiente.fetch_add(1)) < n;) ok[i] = f(i);
+    };
+    std::size_t auxiliares = n > 1 ? reservarAuxiliares(n - 1) : 0;
+    std::mutex cerrojo;
+    std::condition_variable terminaron;
+    std::size_t pendientes = auxiliares;
+    for (std::size_t h = 0; h < auxiliares; ++h) {
+        grupo().encolar([&] {
+            trabajar();
+            // Se notifica con el cerrojo tomado: quien llama no puede retornar (y destruir
+            // estas variables) antes de que la tarea deje de usarlas
+            std::lock_guard<std::mutex> lock(cerrojo);
+            --pendientes;
+            terminaron.notify_one();
+        });
+    }
+    trabajar();
+    if (auxiliares > 0) {
+        std::unique_lock<std::mutex> lock(cerrojo);
+        terminaron.wait(lock, [&] { return pendientes == 0; });
+    }
+    auxiliaresEnUso.fetch_sub(auxiliares);
+    return std::all_of(ok.begin(), ok.end(), [](char c) { return c != 0; });
+}
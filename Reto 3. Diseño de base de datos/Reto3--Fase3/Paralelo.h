@@ -0,0 +1,20 @@
+#ifndef PARALELO_H
+#define PARALELO_H
+
+#include <cstddef>
+#include <functional>
+
+// Reparto de trabajo entre hilos para la carga de datos. Todas las llamadas comparten un
+// presupuesto de hilos auxiliares (uno menos que los nucleos): una llamada anidada dentro
+// de otra solo usa los que queden libres y el hilo que llama siempre trabaja, asi que no
+// hay mas hilos activos que nucleos y ninguna llamada espera un hilo que no llega.
+// Los auxiliares se crean una vez y se reutilizan: una llamada no crea hilos.
+
+// Nucleos disponibles (al menos 1)
+std::size_t hilosDisponibles();
+
+// Ejecuta f(0) ... f(n - 1) repartidas entre el hilo actual y los auxiliares libres, cada
+// uno tomando el siguiente indice pendiente; retorna true si todas retornan true
+bool enParalelo(std::size_t n, const std::function<bool(std::size_t)>& f);
+
+#endif // PARALELO_H
@@ -0,0 +1,200 @@
+#include "Red.h"
+#include <algorithm>
+#include <cstring>
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace red {
+
+#ifdef _WIN32
+const Socket SOCKET_INVALIDO = INVALID_SOCKET;
+#else
+const Socket SOCKET_INVALIDO = -1;
+#endif
+
+namespace {
+
+// Desactiva Nagle: las respuestas son líneas cortas y se esperan de inmediato
+void sinRetardo(Socket s) {
+    int uno = 1;
+    setsockopt(s, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&uno), sizeof(uno));
+}
+
+} // namespace
+
+// Inicializa Winsock una vez; en sistemas POSIX no hace falta
+bool iniciar() {
+#ifdef _WIN32
+    WSADATA datos;
+    return WSAStartup(MAKEWORD(2, 2), &datos) == 0;
+#else
+    return true;
+#endif
+}
+
+// Crea un socket en escucha solo en la interfaz local
+Socket escuchar(int puerto) {
+    Socket s = socket(AF_INET, SOCK_STREAM, 0);
+    if (s == SOCKET_INVALIDO) return SOCKET_INVALIDO;
+    int uno = 1;
+    setsockopt(s, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&uno), sizeof(uno));
+    sockaddr_in dir;
+    std::memset(&dir, 0, sizeof(dir));
+    dir.sin_family = AF_INET;
+    dir.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    dir.sin_port = htons(static_cast<unsigned short>(puerto));
+    if (bind(s, reinterpret_cast<sockaddr*>(&dir), sizeof(dir)) != 0 || listen(s, 128) != 0) {
+        cerrar(s);
+        return SOCKET_INVALIDO;
+    }
+    return s;
+}
+
+// Acepta una conexión entrante (bloqueante)
+Socket aceptar(Socket servidor) {
+    Socket s = accept(servidor, nullptr, nullptr);
+    if (s != SOCKET_INVALIDO) sinRetardo(s);
+    return s;
+}
+
+// Resuelve 'host' y se conecta al primer destino disponible
+Socket conectar(const std::string& host, int puerto) {
+    addrinfo pista;
+    std::memset(&pista, 0, sizeof(pista));
+    pista.ai_family = AF_INET;
+    pista.ai_socktype = SOCK_STREAM;
+    addrinfo* destinos = nullptr;
+    if (getaddrinfo(host.c_str(), std::to_string(puerto).c_str(), &pista, &destinos) != 0) return SOCKET_INVALIDO;
+    Socket s = SOCKET_INVALIDO;
+    for (addrinfo* d = destinos; d; d = d->ai_next) {
+        s = socket(d->ai_family, d->ai_socktype, d->ai_protocol);
+        if (s == SOCKET_INVALIDO) continue;
+        if (connect(s, d->ai_addr, static_cast<int>(d->ai_addrlen)) == 0) break;
+        cerrar(s);
+        s = SOCKET_INVALIDO;
+    }
+    freeaddrinfo(destinos);
+    if (s != SOCKET_INVALIDO) sinRetardo(s);
+    return s;
+}
+
+void cerrar(Socket s) {
+#ifdef _WIN32
+    closesocket(s);
+#else
+    close(s);
+#endif
+}
+
+// Cierra ambos sentidos sin liberar el descriptor: accept/recv bloqueados retornan
+void interrumpir(Socket s) {
+#ifdef _WIN32
+    shutdown(s, SD_BOTH);
+#else
+    shutdown(s, SHUT_RDWR);
+#endif
+}
+
+// Envía el bloque completo, repitiendo ante envíos parciales
+bool enviar(Socket s, const char* datos, std::size_t bytes) {
+    while (bytes > 0) {
+#ifdef _WIN32
+        int n = send(s, datos, static_cast<int>(bytes), 0);
+#else
+        ssize_t n = send(s, datos, bytes, MSG_NOSIGNAL);
+#endif
+        if (n <= 0) return false;
+        datos += n;
+        bytes -= static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+// Lee lo que haya disponible (bloquea solo si no hay nada)
+int recibir(Socket s, char* destino, std::size_t bytes) {
+    return static_cast<int>(recv(s, destino, static_cast<int>(bytes), 0));
+}
+
+// Conecta dos sockets por la interfaz local usando un puerto temporal
+bool parLocal(Socket& lectura, Socket& escritura) {
+    Socket temporal = escuchar(0);
+    if (temporal == SOCKET_INVALIDO) return false;
+    sockaddr_in dir;
+    socklen_t largo = sizeof(dir);
+    bool ok = getsockname(temporal, reinterpret_cast<sockaddr*>(&dir), &largo) == 0;
+    escritura = ok ? conectar("127.0.0.1", ntohs(dir.sin_port)) : SOCKET_INVALIDO;
+    lectura = escritura != SOCKET_INVALIDO ? aceptar(temporal) : SOCKET_INVALIDO;
+    cerrar(temporal);
+    if (lectura == SOCKET_INVALIDO && escritura != SOCKET_INVALIDO) cerrar(escritura);
+    return lectura != SOCKET_INVALIDO;
+}
+
+// En POSIX un fd_set solo admite descriptores menores que FD_SETSIZE
+bool ConjuntoEspera::admite(Socket s) {
+#ifdef _WIN32
+    (void)s;
+    return true;
+#else
+    return s >= 0 && s < FD_SETSIZE;
+#endif
+}
+
+bool ConjuntoEspera::agregar(Socket s) {
+    if (!admite(s) || sockets.size() >= FD_SETSIZE) return false;
+    sockets.push_back(s);
+    return true;
+}
+
+bool ConjuntoEspera::esperar() {
+    fd_set conjunto;
+    FD_ZERO(&conjunto);
+    Socket maximo = 0;
+    for (Socket s : sockets) {
+        FD_SET(s, &conjunto);
+        maximo = std::max(maximo, s);
+    }
+    listos.clear();
+    // En Windows el primer argumento se ignora
+    if (select(static_cast<int>(maximo) + 1, &conjunto, nullptr, nullptr, nullptr) < 0) return false;
+    for (Socket s : sockets) {
+        if (FD_ISSET(s, &conjunto)) listos.push_back(s);
+    }
+    return true;
+}
+
+bool ConjuntoEspera::listo(Socket s) const {
+    return std::find(listos.begin(), listos.end(), s) != listos.end();
+}
+
+// Retorna la siguiente línea completa (sin '\n' ni '\r'), leyendo del socket cuando hace falta
+bool LectorLineas::siguiente(std::string& linea) {
+    while (true) {
+        std::size_t fin = buffer.find('\n', inicio);
+        if (fin != std::string::npos) {
+            std::size_t largo = fin - inicio;
+            if (largo > 0 && buffer[fin - 1] == '\r') --largo;
+            linea.assign(buffer, inicio, largo);
+            inicio = fin + 1;
+            return true;
+        }
+        // Compacta lo ya consumido antes de leer más
+        buffer.erase(0, inicio);
+        inicio = 0;
+        char bloque[4096];
+        int n = recibir(socket, bloque, sizeof(bloque));
+        if (n <= 0) return false;
+        buffer.append(bloque, static_cast<std::size_t>(n));
+    }
+}
+
+} // namespace red
@@ -0,0 +1,57 @@
+#ifndef RED_H
+#define RED_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Envoltorio minimo de sockets TCP (Winsock en Windows, sockets POSIX en el resto)
+// usado por el servidor y por el cliente generador de carga.
+namespace red {
+
+#ifdef _WIN32
+using Socket = unsigned long long;     // SOCKET de Winsock
+#else
+using Socket = int;                    // Descriptor de archivo POSIX
+#endif
+extern const Socket SOCKET_INVALIDO;
+
+bool iniciar();                                             // Inicializa la pila de red (WSAStartup en Windows)
+Socket escuchar(int puerto);                                // Socket en escucha en 127.0.0.1:puerto
+Socket aceptar(Socket servidor);                            // Espera una conexion entrante
+Socket conectar(const std::string& host, int puerto);       // Conecta con host:puerto
+void cerrar(Socket s);                                      // Cierra el socket
+void interrumpir(Socket s);                                 // Desbloquea accept/recv pendientes (shutdown)
+bool enviar(Socket s, const char* datos, std::size_t bytes); // Envia todos los bytes
+int recibir(Socket s, char* destino, std::size_t bytes);    // Una lectura; <= 0 si se cerro
+bool parLocal(Socket& lectura, Socket& escritura);          // Par de sockets conectados (para despertar select)
+
+// Espera a que alguno de un conjunto de sockets tenga datos (select)
+class ConjuntoEspera {
+public:
+    static bool admite(Socket s);          // false si el descriptor no cabe en un fd_set
+    bool agregar(Socket s);                // false si el socket no cabe en el conjunto
+    bool esperar();                        // Bloquea hasta que haya datos; false ante error
+    bool listo(Socket s) const;            // true si 's' tiene datos tras esperar()
+    void limpiar() { sockets.clear(); listos.clear(); }
+
+private:
+    std::vector<Socket> sockets;
+    std::vector<Socket> listos;
+};
+
+// Lee lineas terminadas en '\n' de un socket, con buffer propio
+class LectorLineas {
+public:
+    explicit LectorLineas(Socket s) : socket(s) {}
+    bool siguiente(std::string& linea);   // false si la conexion se cerro
+
+private:
+    Socket socket;
+    std::string buffer;
+    std::size_t inicio = 0;               // Primer byte sin consumir de 'buffer'
+};
+
+} // namespace red
+
+#endif // RED_H
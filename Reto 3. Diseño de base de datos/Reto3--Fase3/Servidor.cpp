@@ -0,0 +1,167 @@
+#include "Servidor.h"
+#include "BibliotecaConcurrente.h"
+#include "Lote.h"
+#include <algorithm>
+
+Servidor::Servidor(BibliotecaConcurrente& base, std::size_t hilos)
+    : base(base), numHilos(hilos == 0 ? 1 : hilos), escucha(red::SOCKET_INVALIDO),
+      despertarLectura(red::SOCKET_INVALIDO), despertarEscritura(red::SOCKET_INVALIDO) {}
+
+// Libera los sockets que ejecutar() no llegó a cerrar
+Servidor::~Servidor() {
+    for (red::Socket s : {escucha, despertarLectura, despertarEscritura}) {
+        if (s != red::SOCKET_INVALIDO) red::cerrar(s);
+    }
+}
+
+// Abre el socket de escucha (solo conexiones locales) y el par para despertar al despachador
+bool Servidor::iniciar(int puerto) {
+    if (!red::iniciar()) return false;
+    escucha = red::escuchar(puerto);
+    return escucha != red::SOCKET_INVALIDO && red::parLocal(despertarLectura, despertarEscritura);
+}
+
+// Despachador: vigila la escucha y las conexiones ociosas y reparte las que tienen datos
+void Servidor::ejecutar() {
+    for (std::size_t i = 0; i < numHilos; ++i) hilos.emplace_back(&Servidor::trabajar, this);
+    std::vector<Conexion*> ociosas;  // Conexiones sin petición en curso
+    red::ConjuntoEspera espera;
+    while (!detenido) {
+        // Recupera las conexiones que el pool terminó de atender
+        {
+            std::lock_guard<std::mutex> lock(cerrojoCola);
+            for (Conexion* c : devueltas) {
+                if (!c->cerrar) {
+                    ociosas.push_back(c);
+                    continue;
+                }
+                red::cerrar(c->socket);
+                conexiones.erase(std::find_if(conexiones.begin(), conexiones.end(),
+                                              [c](const std::unique_ptr<Conexion>& p) { return p.get() == c; }));
+            }
+            devueltas.clear();
+        }
+
+        espera.limpiar();
+        espera.agregar(escucha);
+        espera.agregar(despertarLectura);
+        for (Conexion* c : ociosas) espera.agregar(c->socket);
+        if (!espera.esperar()) break;
+
+        if (espera.listo(despertarLectura)) {
+            char descarte[64];
+            red::recibir(despertarLectura, descarte, sizeof(descarte));
+        }
+        if (espera.listo(escucha)) {
+            red::Socket s = red::aceptar(escucha);
+            // Si el descriptor no cabe en select() la conexión se rechaza
+            if (s != red::SOCKET_INVALIDO && !red::ConjuntoEspera::admite(s)) {
+                red::cerrar(s);
+            } else if (s != red::SOCKET_INVALIDO) {
+                conexiones.push_back(std::unique_ptr<Conexion>(new Conexion{s, std::string(), false}));
+                ociosas.push_back(conexiones.back().get());
+            }
+        }
+        // Las conexiones con datos pasan al pool
+        std::lock_guard<std::mutex> lock(cerrojoCola);
+        auto conDatos = std::stable_partition(ociosas.begin(), ociosas.end(),
+                                              [&espera](Conexion* c) { return !espera.listo(c->socket); });
+        for (auto it = conDatos; it != ociosas.end(); ++it) pendientes.push_back(*it);
+        if (conDatos != ociosas.end()) hayTrabajo.notify_all();
+        ociosas.erase(conDatos, ociosas.end());
+    }
+
+    detenido = true;
+    hayTrabajo.notify_all();
+    for (auto& h : hilos) h.join();
+    hilos.clear();
+    for (auto& c : conexiones) red::cerrar(c->socket);
+    conexiones.clear();
+    red::cerrar(escucha);
+    escucha = red::SOCKET_INVALIDO;
+}
+
+// Marca el servidor como detenido; el despachador cierra todo al despertar
+void Servidor::detener() {
+    detenido = true;
+    despertar();
+}
+
+void Servidor::despertar() {
+    char uno = 1;
+    red::enviar(despertarEscritura, &uno, 1);
+}
+
+// Cada hilo toma una conexión con datos, responde sus líneas y la devuelve al despachador
+void Servidor::trabajar() {
+    while (true) {
+        Conexion* c;
+        {
+            std::unique_lock<std::mutex> lock(cerrojoCola);
+            hayTrabajo.wait(lock, [this] { return detenido || !pendientes.empty(); });
+            if (detenido) break;
+            c = pendientes.front();
+            pendientes.pop_front();
+        }
+        atender(*c);
+        {
+            std::lock_guard<std::mutex> lock(cerrojoCola);
+            devueltas.push_back(c);
+        }
+        despertar();
+    }
+}
+
+// Una sola lectura (el despachador ya vio datos); las respuestas se envían juntas
+void Servidor::atender(Conexion& c) {
+    char bloque[4096];
+    int n = red::recibir(c.socket, bloque, sizeof(bloque));
+    if (n <= 0) {
+        c.cerrar = true;
+        return;
+    }
+    c.entrada.append(bloque, static_cast<std::size_t>(n));
+
+    std::string salida, linea, respuesta;
+    std::size_t inicio = 0, fin;
+    while (!c.cerrar && (fin = c.entrada.find('\n', inicio)) != std::string::npos) {
+        linea.assign(c.entrada, inicio, fin - inicio);
+        inicio = fin + 1;
+        if (!linea.empty() && linea.back() == '\r') linea.pop_back();
+        if (esIgnorable(linea)) continue;
+        c.cerrar = !procesar(linea, respuesta);
+        salida += respuesta;
+        salida += '\n';
+    }
+    c.entrada.erase(0, inicio);
+    if (!salida.empty() && !red::enviar(c.socket, salida.data(), salida.size())) c.cerrar = true;
+}
+
+// Ejecuta un comando y arma la respuesta. Una modificación se aplica en las dos copias de la
+// base: se fija la fecha de hoy para que ambas hagan el mismo cambio
+bool Servidor::procesar(const std::string& linea, std::string& respuesta) {
+    if (linea == "ping") {
+        respuesta = "OK";
+        return true;
+    }
+    if (linea == "salir") {
+        respuesta = "OK";
+        return false;
+    }
+    if (linea == "apagar") {
+        respuesta = "OK";
+        detener();
+        return false;
+    }
+    std::string resultado;
+    bool ok;
+    if (esConsulta(linea)) {
+        ok = base.leer([&](const BibliotecaDB& db) { return ejecutarConsulta(db, linea, &resultado); });
+    } else {
+        Fecha hoy = Fecha::hoy();
+        ok = base.modificar([&](BibliotecaDB& db) { return ejecutarComando(db, linea, &resultado, hoy); });
+    }
+    respuesta = ok ? "OK" : "ERROR";
+    if (ok && !resultado.empty()) respuesta += " " + resultado;
+    return true;
+}
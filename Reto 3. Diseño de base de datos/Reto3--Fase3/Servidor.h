@@ -0,0 +1,63 @@
+#ifndef SERVIDOR_H
+#define SERVIDOR_H
+
+#include "Red.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class BibliotecaConcurrente;
+
+// Servidor TCP local para una BibliotecaConcurrente.
+// Protocolo de lineas: cada linea es un comando de Lote.h y la respuesta es
+// "OK[ <resultado>]" o "ERROR". Ademas: "ping", "salir" (cierra la conexion) y
+// "apagar" (detiene el servidor). Un hilo despachador espera datos en todas las
+// conexiones con select() y entrega las que tienen peticiones a un pool de hilos;
+// las consultas leen sin cerrojos ni esperas a las modificaciones, que se serializan
+// (ver BibliotecaConcurrente).
+class Servidor {
+public:
+    Servidor(BibliotecaConcurrente& base, std::size_t hilos);
+    ~Servidor();
+    Servidor(const Servidor&) = delete;
+    Servidor& operator=(const Servidor&) = delete;
+
+    bool iniciar(int puerto);   // Abre el socket en escucha en 127.0.0.1:puerto
+    void ejecutar();            // Atiende conexiones hasta que se llame a detener()
+    void detener();             // Pide al despachador y al pool que terminen
+
+private:
+    // Conexion de un cliente y las lineas parciales recibidas
+    struct Conexion {
+        red::Socket socket;
+        std::string entrada;    // Bytes recibidos que aun no forman una linea completa
+        bool cerrar = false;    // El cliente se desconecto o pidio salir
+    };
+
+    BibliotecaConcurrente& base;
+    std::size_t numHilos;
+    red::Socket escucha;
+    red::Socket despertarLectura;             // El despachador lo vigila junto a los clientes
+    red::Socket despertarEscritura;           // Un byte aqui interrumpe el select()
+
+    std::mutex cerrojoCola;                   // Protege 'pendientes' y 'devueltas'
+    std::condition_variable hayTrabajo;
+    std::deque<Conexion*> pendientes;         // Conexiones con datos, esperando un hilo
+    std::vector<Conexion*> devueltas;         // Conexiones atendidas que vuelven al despachador
+    std::vector<std::unique_ptr<Conexion>> conexiones; // Todas las conexiones abiertas (solo despachador)
+    std::atomic<bool> detenido{false};
+    std::vector<std::thread> hilos;
+
+    void despertar();                         // Interrumpe la espera del despachador
+    void trabajar();                          // Bucle de un hilo del pool
+    void atender(Conexion& c);                // Lee y responde las lineas disponibles
+    bool procesar(const std::string& linea, std::string& respuesta); // false si hay que cerrar
+};
+
+#endif // SERVIDOR_H
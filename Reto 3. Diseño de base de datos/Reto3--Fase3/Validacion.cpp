@@ -0,0 +1,97 @@
+#include "Validacion.h"
+
+namespace {
+
+bool esDigito(char c) { return c >= '0' && c <= '9'; }
+bool esLetra(char c) { return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z'); }
+
+// Convierte 'n' dígitos consecutivos a entero; falla si alguno no es dígito
+bool leerDigitos(std::string_view s, std::size_t desde, std::size_t n, int& valor) {
+    valor = 0;
+    for (std::size_t i = desde; i < desde + n; ++i) {
+        if (!esDigito(s[i])) return false;
+        valor = valor * 10 + (s[i] - '0');
+    }
+    return true;
+}
+
+} // namespace
+
+// Equivale al patrón \d{4}-\d{2}-\d{2}
+bool descomponerFecha(std::string_view s, int& anio, int& mes, int& dia) {
+    return s.size() == 10 && s[4] == '-' && s[7] == '-' && leerDigitos(s, 0, 4, anio) &&
+           leerDigitos(s, 5, 2, mes) && leerDigitos(s, 8, 2, dia);
+}
+
+// Febrero tiene 29 días en años bisiestos
+int diasEnMes(int anio, int mes) {
+    static const int DIAS[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    if (mes < 1 || mes > 12) return 0;
+    bool bisiesto = (anio % 4 == 0 && anio % 100 != 0) || (anio % 400 == 0);
+    return (mes == 2 && bisiesto) ? 29 : DIAS[mes - 1];
+}
+
+// Valida formato y existencia del día en el calendario
+bool esFechaValida(std::string_view s) {
+    int anio, mes, dia;
+    return descomponerFecha(s, anio, mes, dia) && dia >= 1 && dia <= diasEnMes(anio, mes);
+}
+
+// Recorre los dígitos ignorando guiones internos y verifica el dígito de control
+bool esIsbnValido(std::string_view s) {
+    int digitos[13];
+    int n = 0;
+    bool guionPrevio = true; // No se permite guion al inicio ni dos guiones seguidos
+    for (std::size_t i = 0; i < s.size(); ++i) {
+        char c = s[i];
+        if (c == '-') {
+            if (guionPrevio) return false;
+            guionPrevio = true;
+            continue;
+        }
+        if (n == 13) return false;
+        if (esDigito(c)) {
+            digitos[n++] = c - '0';
+        } else if ((c == 'X' || c == 'x') && n == 9 && i + 1 == s.size()) {
+            digitos[n++] = 10; // 'X' solo es válido como control de un ISBN-10
+        } else {
+            return false;
+        }
+        guionPrevio = false;
+    }
+    if (guionPrevio) return false; // Vacío o terminado en guion
+    if (n == 10) {
+        // ISBN-10: suma ponderada 10..1 divisible entre 11
+        int suma = 0;
+        for (int i = 0; i < 10; ++i) suma += digitos[i] * (10 - i);
+        return suma % 11 == 0;
+    }
+    if (n == 13) {
+        // ISBN-13: pesos alternos 1 y 3, suma divisible entre 10
+        int suma = 0;
+        for (int i = 0; i < 13; ++i) {
+            if (digitos[i] == 10) return false;
+            suma += digitos[i] * (i % 2 == 0 ? 1 : 3);
+        }
+        return suma % 10 == 0;
+    }
+    return false;
+}
+
+// Equivale al patrón ^[A-Za-z ]+$
+bool esNombreValido(std::string_view s) {
+    if (s.empty()) return false;
+    for (char c : s) {
+        if (!esLetra(c) && c != ' ') return false;
+    }
+    return true;
+}
+
+// Equivale al patrón ^[A-Za-z0-9 ]+$
+bool esTextoValido(std::string_view s) {
+    if (s.empty()) return false;
+    for (char c : s) {
+        if (!esLetra(c) && !esDigito(c) && c != ' ') return false;
+    }
+    return true;
+}
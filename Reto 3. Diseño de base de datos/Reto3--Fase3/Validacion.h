@@ -0,0 +1,27 @@
+#ifndef VALIDACION_H
+#define VALIDACION_H
+
+#include <string_view>
+
+// Validadores escritos a mano (sin std::regex) compartidos por BibliotecaDB y el
+// menu de consola; no reservan memoria ni compilan patrones en cada llamada.
+
+// Descompone una fecha "YYYY-MM-DD"; solo valida el formato (digitos y guiones)
+bool descomponerFecha(std::string_view s, int& anio, int& mes, int& dia);
+
+// Dias del mes indicado, considerando anios bisiestos
+int diasEnMes(int anio, int mes);
+
+// Fecha "YYYY-MM-DD" con formato correcto y que existe en el calendario
+bool esFechaValida(std::string_view s);
+
+// ISBN-10 o ISBN-13 con guiones opcionales entre digitos y digito de control correcto
+bool esIsbnValido(std::string_view s);
+
+// Nombre no vacio formado solo por letras ASCII y espacios
+bool esNombreValido(std::string_view s);
+
+// Texto libre no vacio formado por letras ASCII, digitos y espacios
+bool esTextoValido(std::string_view s);
+
+#endif // VALIDACION_H
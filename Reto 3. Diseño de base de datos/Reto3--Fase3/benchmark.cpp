@@ -0,0 +1,1063 @@
+#include "Biblioteca.h"
+#include "BibliotecaConcurrente.h"
+#include "BibliotecaFragmentada.h"
+#include "Validacion.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <regex>
+#include <shared_mutex>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Suite de benchmarks de BibliotecaDB sobre datos sintéticos deterministas.
+// Cada escenario reporta una fila CSV con operaciones/s y percentiles de latencia,
+// de modo que los resultados puedan compararse entre versiones.
+
+namespace {
+
+const std::string DIRECTORIO = "bench_datos";   // Datos generados (no se modifican)
+const std::string TRABAJO = "bench_trabajo";    // Copia de trabajo de los escenarios que escriben
+const char* const VERSION_GENERADOR = "2";      // Cambiarla obliga a regenerar los datos
+
+// --- Generador de datos ---
+
+// Dígito de control de un ISBN-13 a partir de sus 12 primeros dígitos
+int digitoControlIsbn13(const std::string& doce) {
+    int suma = 0;
+    for (std::size_t i = 0; i < doce.size(); ++i) suma += (doce[i] - '0') * (i % 2 == 0 ? 1 : 3);
+    return (10 - suma % 10) % 10;
+}
+
+// ISBN-13 válido y único del libro i (prefijo 979 para los libros agregados en los escenarios)
+std::string isbnDeLibro(int i, const char* prefijo = "978") {
+    std::string doce = prefijo + std::to_string(100000000 + i % 900000000);
+    return doce + static_cast<char>('0' + digitoControlIsbn13(doce));
+}
+
+// Tamaño de cada tabla auxiliar en función del número de libros/préstamos
+int numEstudiantes(int filas) { return std::max(1, filas / 10); }
+int numAutores(int filas) { return std::max(1, filas / 100); }
+int numEditoriales(int filas) { return std::max(1, filas / 1000); }
+
+// Genera archivos CSV con 'filas' libros y préstamos (y tablas auxiliares proporcionales).
+// Los datos dependen solo de 'filas'; si ya existen para ese tamaño no se regeneran.
+void generarDatos(int filas) {
+    std::string marca = std::to_string(filas) + " v" + VERSION_GENERADOR;
+    std::ifstream previa(DIRECTORIO + "/generado.dat");
+    std::string linea;
+    if (previa && std::getline(previa, linea) && linea == marca) return;
+    previa.close();
+
+    std::cerr << "Generando datos (" << filas << " filas)...\n";
+    std::filesystem::create_directories(DIRECTORIO);
+    std::mt19937 rng(20251001); // Semilla fija: mismos datos en cada ejecución
+    std::ofstream est(DIRECTORIO + "/estudiantes.txt");
+    for (int i = 1; i <= numEstudiantes(filas); ++i) {
+        est << i << ",Estudiante " << i << "," << (i % 5 + 1) << "to Bachillerato\n";
+    }
+    std::ofstream aut(DIRECTORIO + "/autores.txt");
+    for (int i = 1; i <= numAutores(filas); ++i) {
+        aut << i << ",Autor " << i << ",Nacionalidad " << (i % 20) << "\n";
+    }
+    std::ofstream edi(DIRECTORIO + "/editoriales.txt");
+    for (int i = 1; i <= numEditoriales(filas); ++i) {
+        edi << i << ",Editorial " << i << "\n";
+    }
+    std::ofstream lib(DIRECTORIO + "/libros.txt");
+    for (int i = 1; i <= filas; ++i) {
+        std::string isbn = isbnDeLibro(i);
+        // Uno de cada diez títulos lleva coma para ejercitar el manejo de comillas
+        lib << i << (i % 10 == 0 ? ",\"Titulo " : ",Titulo ") << i << (i % 10 == 0 ? ", tomo 2\"," : ",")
+            << isbn << "," << (1900 + static_cast<int>(rng() % 125)) << ","
+            << (rng() % numAutores(filas) + 1) << "," << (rng() % numEditoriales(filas) + 1) << "\n";
+    }
+    // Un préstamo por libro; uno de cada siete sigue activo
+    std::ofstream pre(DIRECTORIO + "/prestamos.txt");
+    for (int i = 1; i <= filas; ++i) {
+        int mes = static_cast<int>(rng() % 9) + 1;
+        int dia = static_cast<int>(rng() % 28) + 1;
+        pre << i << "," << i << "," << (rng() % numEstudiantes(filas) + 1) << ",2025-0" << mes << "-"
+            << (dia < 10 ? "0" : "") << dia << "," << (i % 7 == 0 ? "" : "2025-10-01") << "\n";
+    }
+    std::ofstream(DIRECTORIO + "/generado.dat") << marca << "\n";
+}
+
+// Tamaño total en bytes de los cinco archivos generados
+double bytesDatos() {
+    double total = 0;
+    for (const char* f : {"estudiantes.txt", "autores.txt", "editoriales.txt", "libros.txt", "prestamos.txt"}) {
+        total += static_cast<double>(std::filesystem::file_size(DIRECTORIO + "/" + f));
+    }
+    return total;
+}
+
+// --- Ruta de carga anterior, reproducida como referencia ---
+
+std::vector<std::string> dividirAnterior(const std::string& s) {
+    std::vector<std::string> tokens;
+    std::string token;
+    bool enComillas = false;
+    for (char c : s) {
+        if (c == '"') {
+            enComillas = !enComillas;
+        } else if (c == ',' && !enComillas) {
+            tokens.push_back(token);
+            token.clear();
+        } else {
+            token += c;
+        }
+    }
+    if (!token.empty()) tokens.push_back(token);
+    for (auto& t : tokens) std::replace(t.begin(), t.end(), ';', '|');
+    return tokens;
+}
+
+// Representación previa de las filas (todas las fechas como std::string)
+struct DatosAnteriores {
+    struct Estudiante { int id; std::string nombre, grado; };
+    struct Autor { int id; std::string nombre, nacionalidad; };
+    struct Editorial { int id; std::string nombre; };
+    struct Libro { int id; std::string titulo, isbn; int anio, id_autor, id_editorial; };
+    struct Prestamo { int id, id_libro, id_estudiante; std::string fecha_prestamo, fecha_devolucion; };
+    std::vector<Estudiante> estudiantes;
+    std::vector<Autor> autores;
+    std::vector<Editorial> editoriales;
+    std::vector<Libro> libros;
+    std::vector<Prestamo> prestamos;
+};
+
+void cargaAnterior(DatosAnteriores& db) {
+    std::string line;
+    std::ifstream fe(DIRECTORIO + "/estudiantes.txt");
+    while (std::getline(fe, line)) {
+        auto t = dividirAnterior(line);
+        try {
+            db.estudiantes.push_back({std::stoi(t.at(0)), t.at(1), t.at(2)});
+        } catch (...) {
+        }
+    }
+    std::ifstream fa(DIRECTORIO + "/autores.txt");
+    while (std::getline(fa, line)) {
+        auto t = dividirAnterior(line);
+        try {
+            db.autores.push_back({std::stoi(t.at(0)), t.at(1), t.at(2)});
+        } catch (...) {
+        }
+    }
+    std::ifstream fd(DIRECTORIO + "/editoriales.txt");
+    while (std::getline(fd, line)) {
+        auto t = dividirAnterior(line);
+        try {
+            db.editoriales.push_back({std::stoi(t.at(0)), t.at(1)});
+        } catch (...) {
+        }
+    }
+    std::ifstream fl(DIRECTORIO + "/libros.txt");
+    while (std::getline(fl, line)) {
+        auto t = dividirAnterior(line);
+        try {
+            db.libros.push_back({std::stoi(t.at(0)), t.at(1), t.at(2), std::stoi(t.at(3)), std::stoi(t.at(4)),
+                                 std::stoi(t.at(5))});
+        } catch (...) {
+        }
+    }
+    std::ifstream fp(DIRECTORIO + "/prestamos.txt");
+    while (std::getline(fp, line)) {
+        auto t = dividirAnterior(line);
+        try {
+            db.prestamos.push_back({std::stoi(t.at(0)), std::stoi(t.at(1)), std::stoi(t.at(2)), t.at(3),
+                                    t.size() > 4 ? t[4] : ""});
+        } catch (...) {
+        }
+    }
+}
+
+// --- Ruta de guardado anterior, reproducida como referencia ---
+
+// Escapado anterior: una copia del campo por fila
+std::string escaparAnterior(std::string_view s) {
+    std::string result(s);
+    std::replace(result.begin(), result.end(), '|', ';');
+    if (result.find(',') != std::string::npos) result = "\"" + result + "\"";
+    return result;
+}
+
+// Escribe un CSV como lo hacían los guardar* anteriores: cada fila se arma concatenando
+// std::string y pasa por un std::ostream sobre ArchivoSalida (con control y fsync)
+template <typename Filas>
+std::size_t guardarTablaAnterior(const std::string& archivo, Filas filas) {
+    ArchivoSalida salida;
+    if (!salida.abrir(archivo, true)) return 0;
+    std::ostream file(&salida);
+    filas(file);
+    salida.cerrar(1);
+    return static_cast<std::size_t>(std::filesystem::file_size(archivo));
+}
+
+// Guarda las cinco tablas una tras otra con la ruta anterior; retorna los bytes escritos
+std::size_t guardadoAnterior(const BibliotecaDB& db, const std::string& dir) {
+    std::size_t bytes = 0;
+    // Los diccionarios no se exponen: sus códigos son consecutivos desde 0
+    bytes += guardarTablaAnterior(dir + "/estudiantes.txt", [&](std::ostream& file) {
+        std::uint32_t n = 0;
+        while (!db.textoGrado(n).empty()) ++n;
+        file << "#diccionario," << n << "\n";
+        for (std::uint32_t g = 0; g < n; ++g) file << escaparAnterior(db.textoGrado(g)) << "\n";
+        for (const auto& e : db.estudiantes) file << e.id << ',' << escaparAnterior(e.nombre) << ',' << e.grado << "\n";
+    });
+    bytes += guardarTablaAnterior(dir + "/autores.txt", [&](std::ostream& file) {
+        std::uint32_t n = 0;
+        while (!db.textoNacionalidad(n).empty()) ++n;
+        file << "#diccionario," << n << "\n";
+        for (std::uint32_t c = 0; c < n; ++c) file << escaparAnterior(db.textoNacionalidad(c)) << "\n";
+        for (const auto& a : db.autores) file << a.id << ',' << escaparAnterior(a.nombre) << ',' << a.nacionalidad << "\n";
+    });
+    bytes += guardarTablaAnterior(dir + "/editoriales.txt", [&](std::ostream& file) {
+        for (const auto& ed : db.editoriales) file << std::to_string(ed.id) + "," + escaparAnterior(ed.nombre) << "\n";
+    });
+    bytes += guardarTablaAnterior(dir + "/libros.txt", [&](std::ostream& file) {
+        for (std::size_t i = 0; i < db.libros.size(); ++i) {
+            const auto& l = db.libros[i];
+            file << std::to_string(l.id) + "," + escaparAnterior(l.titulo) + "," + l.isbn.texto() + "," +
+                        std::to_string(l.anio) + "," + std::to_string(l.id_autor) + "," +
+                        std::to_string(l.id_editorial)
+                 << "\n";
+        }
+    });
+    bytes += guardarTablaAnterior(dir + "/prestamos.txt", [&](std::ostream& file) {
+        for (std::size_t i = 0; i < db.prestamos.size(); ++i) {
+            const auto& p = db.prestamos[i];
+            file << std::to_string(p.id) + "," + std::to_string(p.id_libro) + "," + std::to_string(p.id_estudiante) +
+                        "," + p.fecha_prestamo.texto() + "," + p.fecha_devolucion.texto()
+                 << "\n";
+        }
+    });
+    return bytes;
+}
+
+// --- Medición ---
+
+using Reloj = std::chrono::steady_clock;
+
+// Nanosegundos transcurridos desde 'inicio'
+double nsDesde(Reloj::time_point inicio) {
+    return std::chrono::duration<double, std::nano>(Reloj::now() - inicio).count();
+}
+
+// Resultado de un escenario: operaciones totales, tiempo y latencias observadas
+struct Resultado {
+    std::string escenario;
+    std::size_t operaciones = 0;
+    double segundos = 0.0;
+    std::vector<double> latencias; // ns por operación (por ejecución en escenarios de tabla completa)
+};
+
+// Percentil 'q' (0..1) de un vector ya ordenado
+double percentil(const std::vector<double>& ordenadas, double q) {
+    if (ordenadas.empty()) return 0.0;
+    std::size_t i = static_cast<std::size_t>(q * static_cast<double>(ordenadas.size()));
+    return ordenadas[std::min(i, ordenadas.size() - 1)];
+}
+
+const char* const CABECERA = "escenario,filas,operaciones,segundos,ops_por_s,p50_ns,p90_ns,p99_ns,max_ns";
+
+// Escribe el resultado como una fila CSV
+void reportar(std::ostream& os, int filas, Resultado r) {
+    std::sort(r.latencias.begin(), r.latencias.end());
+    double opsPorSegundo = r.segundos > 0 ? static_cast<double>(r.operaciones) / r.segundos : 0.0;
+    // Notación fija para que cualquier herramienta pueda leer los números
+    os << std::fixed << std::setprecision(6) << r.escenario << "," << filas << "," << r.operaciones << ","
+       << r.segundos << "," << std::setprecision(1) << opsPorSegundo << "," << percentil(r.latencias, 0.50) << ","
+       << percentil(r.latencias, 0.90) << "," << percentil(r.latencias, 0.99) << ","
+       << (r.latencias.empty() ? 0.0 : r.latencias.back()) << "\n";
+}
+
+// Mide 'repeticiones' ejecuciones completas de f(), cada una sobre 'filas' filas
+template <typename F>
+Resultado medirRepeticiones(const std::string& nombre, int repeticiones, std::size_t filas, F f) {
+    Resultado r;
+    r.escenario = nombre;
+    for (int i = 0; i < repeticiones; ++i) {
+        auto inicio = Reloj::now();
+        f();
+        double ns = nsDesde(inicio);
+        r.latencias.push_back(ns);
+        r.segundos += ns / 1e9;
+        r.operaciones += filas;
+    }
+    return r;
+}
+
+// Mide 'n' operaciones f(i) en grupos de 'grupo'; la latencia de cada grupo se divide
+// entre sus operaciones para no medir solo el costo del reloj en operaciones muy cortas
+template <typename F>
+Resultado medirOperaciones(const std::string& nombre, std::size_t n, std::size_t grupo, F f) {
+    Resultado r;
+    r.escenario = nombre;
+    for (std::size_t i = 0; i < n; i += grupo) {
+        std::size_t fin = std::min(n, i + grupo);
+        auto inicio = Reloj::now();
+        for (std::size_t j = i; j < fin; ++j) f(j);
+        double ns = nsDesde(inicio);
+        r.latencias.push_back(ns / static_cast<double>(fin - i));
+        r.segundos += ns / 1e9;
+    }
+    r.operaciones = n;
+    return r;
+}
+
+volatile std::size_t sumidero = 0; // Evita que el compilador descarte las llamadas medidas
+std::atomic<std::size_t> verificacionesFallidas{0}; // Lecturas inconsistentes: el benchmark termina con error
+
+// Descarta lo que los listados escriben en std::cout mientras se miden
+class SalidaNula : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+
+class SilenciarCout {
+public:
+    SilenciarCout() : anterior(std::cout.rdbuf(&nula)) {}
+    ~SilenciarCout() { std::cout.rdbuf(anterior); }
+
+private:
+    SalidaNula nula;
+    std::streambuf* anterior;
+};
+
+// --- Escenarios ---
+
+// Estado compartido: tamaño de los datos y una instancia cargada de solo lectura
+struct Contexto {
+    int filas = 0;
+    BibliotecaDB base;
+};
+
+// Carga los datos generados y redirige las escrituras a una carpeta de trabajo vacía
+void prepararTrabajo(BibliotecaDB& db) {
+    std::filesystem::remove_all(TRABAJO);
+    std::filesystem::create_directories(TRABAJO);
+    db.setDirectorio(DIRECTORIO);
+    db.cargarDatos();
+    db.setDirectorio(TRABAJO);
+}
+
+// Modo de persistencia de los flujos de préstamos/devoluciones
+enum ModoEscritura { ESCRITURA_INMEDIATA, ESCRITURA_LOTE, ESCRITURA_DIARIO, ESCRITURA_TRANSACCION, ESCRITURA_DIFERIDA };
+
+const std::size_t PARES_POR_TRANSACCION = 100;
+
+// Alterna préstamos y devoluciones de libros al azar; cuenta cada llamada como una operación.
+// El tiempo total incluye la escritura final del lote, la sincronización del diario o la
+// confirmación de cada transacción.
+Resultado prestarDevolver(const std::string& nombre, std::size_t pares, ModoEscritura modo) {
+    BibliotecaDB db;
+    prepararTrabajo(db);
+    if (modo == ESCRITURA_DIARIO) db.activarDiario();
+    if (modo == ESCRITURA_LOTE) db.iniciarLote();
+    if (modo == ESCRITURA_DIFERIDA) db.activarEscrituraDiferida(std::chrono::seconds(1));
+
+    Resultado r;
+    r.escenario = nombre;
+    std::mt19937 rng(7);
+    int numLibros = static_cast<int>(db.libros.size());
+    int numEst = static_cast<int>(db.estudiantes.size());
+    Fecha fecha = Fecha::desdeCivil(2026, 1, 15);
+    for (std::size_t i = 0; i < pares; ++i) {
+        int libro = static_cast<int>(rng() % numLibros) + 1;
+        while (db.prestamoActivoDeLibro(libro)) libro = libro % numLibros + 1;
+        int estudiante = static_cast<int>(rng() % numEst) + 1;
+        int id = db.nextPrestamoId();
+        if (modo == ESCRITURA_TRANSACCION && i % PARES_POR_TRANSACCION == 0) db.iniciarTransaccion();
+
+        auto inicio = Reloj::now();
+        bool ok = db.prestarLibro(libro, estudiante, fecha);
+        double ns = nsDesde(inicio);
+        r.latencias.push_back(ns);
+        r.segundos += ns / 1e9;
+
+        inicio = Reloj::now();
+        ok = db.devolverPrestamo(id, fecha) && ok;
+        ns = nsDesde(inicio);
+        r.latencias.push_back(ns);
+        r.segundos += ns / 1e9;
+        sumidero = sumidero + (ok ? 1 : 0);
+        if (modo == ESCRITURA_TRANSACCION && ((i + 1) % PARES_POR_TRANSACCION == 0 || i + 1 == pares)) {
+            inicio = Reloj::now();
+            db.confirmarTransaccion();
+            r.segundos += nsDesde(inicio) / 1e9;
+        }
+    }
+    auto inicio = Reloj::now();
+    if (modo == ESCRITURA_LOTE) db.terminarLote();
+    if (modo == ESCRITURA_DIARIO) db.sincronizarDiario();
+    if (modo == ESCRITURA_DIFERIDA) db.volcarCambios();
+    r.segundos += nsDesde(inicio) / 1e9;
+    r.operaciones = 2 * pares;
+    return r;
+}
+
+// Base compartida con un cerrojo de lectura/escritura (como el servidor), como referencia
+// para BibliotecaConcurrente: aquí las lecturas sí esperan a que termine cada escritura
+class BaseConCerrojo {
+public:
+    BibliotecaDB db;
+
+    template <typename F>
+    auto leer(F&& f) const {
+        std::shared_lock<std::shared_mutex> lock(cerrojo);
+        return f(static_cast<const BibliotecaDB&>(db));
+    }
+    bool modificar(const std::function<bool(BibliotecaDB&)>& f) {
+        std::unique_lock<std::shared_mutex> lock(cerrojo);
+        return f(db);
+    }
+
+private:
+    mutable std::shared_mutex cerrojo;
+};
+
+const double SEGUNDOS_CONCURRENCIA = 0.5;
+
+// 'hilos' lectores buscan libros al azar mientras un escritor presta y devuelve sin pausa.
+// Cada lectura verifica además que el préstamo activo del libro (si lo tiene) sea suyo y
+// siga abierto: una lectura que viera una escritura a medias se informa por std::cerr y
+// hace que el benchmark termine con código de salida 1.
+// Retorna las lecturas y las escrituras como dos resultados.
+template <typename Base>
+std::vector<Resultado> lecturasConcurrentes(const std::string& nombre, Base& base, unsigned hilos) {
+    int numLibros = base.leer([](const BibliotecaDB& db) { return static_cast<int>(db.libros.size()); });
+    int numEst = base.leer([](const BibliotecaDB& db) { return static_cast<int>(db.estudiantes.size()); });
+    std::atomic<bool> fin{false};
+    std::atomic<std::size_t> inconsistentes{0};
+    std::size_t escrituras = 0;
+    std::thread escritor([&] {
+        std::mt19937 rng(11);
+        Fecha fecha = Fecha::desdeCivil(2026, 1, 15);
+        while (!fin.load()) {
+            int libro = static_cast<int>(rng() % numLibros) + 1;
+            int estudiante = static_cast<int>(rng() % numEst) + 1;
+            int id = 0;
+            base.modificar([&](BibliotecaDB& db) {
+                id = db.nextPrestamoId();
+                return db.prestarLibro(libro, estudiante, fecha);
+            });
+            base.modificar([&](BibliotecaDB& db) { return db.devolverPrestamo(id, fecha); });
+            escrituras += 2;
+        }
+    });
+
+    std::vector<std::vector<double>> latencias(hilos);
+    std::vector<std::size_t> lecturas(hilos);
+    std::vector<std::thread> lectores;
+    auto inicio = Reloj::now();
+    for (unsigned h = 0; h < hilos; ++h) {
+        lectores.emplace_back([&, h] {
+            std::mt19937 rng(100 + h);
+            while (!fin.load()) {
+                auto inicioGrupo = Reloj::now();
+                for (int i = 0; i < 64; ++i) {
+                    int libro = static_cast<int>(rng() % numLibros) + 1;
+                    bool ok = base.leer([libro](const BibliotecaDB& db) {
+                        std::optional<Libro> l = db.buscarLibroPorId(libro);
+                        int activo = db.prestamoActivoDeLibro(libro);
+                        if (!l || !activo) return l.has_value();
+                        std::optional<Prestamo> p = db.buscarPrestamoPorId(activo);
+                        return p && p->id_libro == libro && p->fecha_devolucion.vacia();
+                    });
+                    if (!ok) inconsistentes.fetch_add(1);
+                }
+                latencias[h].push_back(nsDesde(inicioGrupo) / 64);
+                lecturas[h] += 64;
+            }
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::duration<double>(SEGUNDOS_CONCURRENCIA));
+    fin.store(true);
+    for (auto& t : lectores) t.join();
+    escritor.join();
+    double segundos = nsDesde(inicio) / 1e9;
+    if (inconsistentes.load() > 0) {
+        std::cerr << "ERROR: " << inconsistentes.load() << " lecturas inconsistentes en " << nombre << "\n";
+        verificacionesFallidas.fetch_add(inconsistentes.load());
+    }
+
+    Resultado r;
+    r.escenario = nombre;
+    r.segundos = segundos;
+    for (unsigned h = 0; h < hilos; ++h) {
+        r.operaciones += lecturas[h];
+        r.latencias.insert(r.latencias.end(), latencias[h].begin(), latencias[h].end());
+    }
+    Resultado w;
+    w.escenario = nombre + "_escrituras";
+    w.segundos = segundos;
+    w.operaciones = escrituras;
+    return {r, w};
+}
+
+// 'hilos' clientes prestan y devuelven libros al azar sobre una base fragmentada durante
+// SEGUNDOS_CONCURRENCIA; cada préstamo o devolución (aceptado o no) es una operación
+Resultado prestamosFragmentados(const std::string& nombre, BibliotecaFragmentada& base, int numLibros,
+                                int numEst, unsigned hilos) {
+    std::atomic<bool> fin{false};
+    std::vector<std::vector<double>> latencias(hilos);
+    std::vector<std::size_t> operaciones(hilos);
+    std::vector<std::thread> clientes;
+    auto inicio = Reloj::now();
+    for (unsigned h = 0; h < hilos; ++h) {
+        clientes.emplace_back([&, h] {
+            std::mt19937 rng(200 + h);
+            Fecha fecha = Fecha::desdeCivil(2026, 1, 15);
+            while (!fin.load()) {
+                int libro = static_cast<int>(rng() % numLibros) + 1;
+                int estudiante = static_cast<int>(rng() % numEst) + 1;
+                auto inicioOp = Reloj::now();
+                int id = base.prestarLibro(libro, estudiante, fecha);
+                if (id) base.devolverPrestamo(id, fecha);
+                latencias[h].push_back(nsDesde(inicioOp) / (id ? 2 : 1));
+                operaciones[h] += id ? 2 : 1;
+            }
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::duration<double>(SEGUNDOS_CONCURRENCIA));
+    fin.store(true);
+    for (auto& t : clientes) t.join();
+
+    Resultado r;
+    r.escenario = nombre;
+    r.segundos = nsDesde(inicio) / 1e9;
+    for (unsigned h = 0; h < hilos; ++h) {
+        r.operaciones += operaciones[h];
+        r.latencias.insert(r.latencias.end(), latencias[h].begin(), latencias[h].end());
+    }
+    return r;
+}
+
+// Escenario registrado: nombre y función que produce sus resultados
+struct Escenario {
+    std::string nombre;
+    std::function<std::vector<Resultado>(Contexto&)> ejecutar;
+};
+
+// Compara expresión regular construida en cada llamada, precompilada y validador manual
+std::vector<Resultado> compararValidador(const std::string& nombre, const char* patron,
+                                         const std::vector<std::string>& entradas,
+                                         bool (*validador)(std::string_view)) {
+    const std::size_t vueltas = 2000;
+    std::size_t n = vueltas * entradas.size();
+    std::regex precompilada(patron);
+    return {
+        medirOperaciones(nombre + "_regex_por_llamada", n / 20, 1, [&](std::size_t i) {
+            std::regex r(patron);
+            sumidero = sumidero + std::regex_match(entradas[i % entradas.size()], r);
+        }),
+        medirOperaciones(nombre + "_regex", n, 64, [&](std::size_t i) {
+            sumidero = sumidero + std::regex_match(entradas[i % entradas.size()], precompilada);
+        }),
+        medirOperaciones(nombre, n, 64, [&](std::size_t i) {
+            sumidero = sumidero + validador(entradas[i % entradas.size()]);
+        }),
+    };
+}
+
+std::vector<Escenario> escenarios() {
+    std::vector<Escenario> lista;
+    auto agregar = [&](const std::string& nombre, std::function<Resultado(Contexto&)> f) {
+        lista.push_back({nombre, [f](Contexto& c) { return std::vector<Resultado>{f(c)}; }});
+    };
+
+    // Persistencia completa
+    agregar("carga_anterior", [](Contexto& c) {
+        return medirRepeticiones("carga_anterior", 3, 2 * c.filas, [] {
+            DatosAnteriores db;
+            cargaAnterior(db);
+        });
+    });
+    agregar("cargar_csv", [](Contexto& c) {
+        return medirRepeticiones("cargar_csv", 3, 2 * c.filas, [] {
+            BibliotecaDB db;
+            db.setDirectorio(DIRECTORIO);
+            db.cargarDatos();
+        });
+    });
+    // Solo la destrucción de una base cargada (la carga no se mide)
+    agregar("destruir_base", [](Contexto& c) {
+        Resultado r;
+        r.escenario = "destruir_base";
+        for (int i = 0; i < 3; ++i) {
+            auto db = std::make_unique<BibliotecaDB>();
+            db->setDirectorio(DIRECTORIO);
+            db->cargarDatos();
+            auto inicio = Reloj::now();
+            db.reset();
+            double ns = nsDesde(inicio);
+            r.latencias.push_back(ns);
+            r.segundos += ns / 1e9;
+            r.operaciones += 2 * static_cast<std::size_t>(c.filas);
+        }
+        return r;
+    });
+    agregar("guardar_csv", [](Contexto& c) {
+        std::filesystem::create_directories(TRABAJO);
+        c.base.setDirectorio(TRABAJO);
+        Resultado r = medirRepeticiones("guardar_csv", 3, 2 * c.filas, [&] { c.base.guardarDatos(); });
+        c.base.setDirectorio(DIRECTORIO);
+        return r;
+    });
+    // Bytes/s de la ruta de guardado anterior frente a la actual (bloques formateados con
+    // std::to_chars y una tabla por hilo); 'operaciones' son bytes escritos
+    lista.push_back({"guardado_bytes", [](Contexto& c) {
+        std::string anterior = TRABAJO + "/guardado_anterior";
+        std::filesystem::create_directories(anterior);
+        std::size_t bytes = guardadoAnterior(c.base, anterior);
+        std::vector<Resultado> resultados;
+        resultados.push_back(medirRepeticiones("guardado_bytes_anterior", 3, bytes,
+                                               [&] { guardadoAnterior(c.base, anterior); }));
+        std::filesystem::create_directories(TRABAJO);
+        c.base.setDirectorio(TRABAJO);
+        resultados.push_back(medirRepeticiones("guardado_bytes_bloques", 3, bytes, [&] { c.base.guardarDatos(); }));
+        c.base.setDirectorio(DIRECTORIO);
+        for (const auto& r : resultados) {
+            std::cerr << r.escenario << ": " << static_cast<double>(r.operaciones) / r.segundos / (1024.0 * 1024.0)
+                      << " MB/s\n";
+        }
+        return resultados;
+    }});
+    // guardarCambios tras modificar solo editoriales: reescribe esa tabla en lugar de las
+    // cinco; 'operaciones' cuenta las filas de la base, como en guardar_csv
+    agregar("guardar_cambios", [](Contexto& c) {
+        SilenciarCout silencio;
+        BibliotecaDB db;
+        prepararTrabajo(db);
+        db.guardarDatos();
+        db.activarEscrituraDiferida();
+        int id = 0;
+        for (const auto& ed : db.editoriales) id = std::max(id, ed.id);
+        return medirRepeticiones("guardar_cambios", 3, 2 * c.filas, [&] {
+            db.agregarEditorial({++id, "Editorial de prueba"});
+            db.guardarCambios();
+        });
+    });
+    agregar("guardar_binario", [](Contexto& c) {
+        std::filesystem::create_directories(TRABAJO);
+        c.base.setDirectorio(TRABAJO);
+        Resultado r = medirRepeticiones("guardar_binario", 3, 2 * c.filas, [&] { c.base.guardarDatosBinario(); });
+        c.base.setDirectorio(DIRECTORIO);
+        return r;
+    });
+    agregar("cargar_binario", [](Contexto& c) {
+        std::filesystem::create_directories(TRABAJO);
+        c.base.setDirectorio(TRABAJO);
+        c.base.guardarDatosBinario();
+        c.base.setDirectorio(DIRECTORIO);
+        return medirRepeticiones("cargar_binario", 3, 2 * c.filas, [] {
+            BibliotecaDB db;
+            db.setDirectorio(TRABAJO);
+            db.cargarDatosBinario();
+        });
+    });
+
+    // Búsquedas por ID con claves al azar
+    agregar("buscar_libro_id", [](Contexto& c) {
+        std::mt19937 rng(1);
+        return medirOperaciones("buscar_libro_id", 1000000, 64, [&](std::size_t) {
+            sumidero = sumidero + c.base.buscarLibroPorId(static_cast<int>(rng() % c.base.libros.size()) + 1).has_value();
+        });
+    });
+    agregar("buscar_libro_isbn", [](Contexto& c) {
+        // Con guiones, como lo escribiría un usuario
+        std::mt19937 rng(8);
+        return medirOperaciones("buscar_libro_isbn", 1000000, 64, [&](std::size_t) {
+            std::string isbn = isbnDeLibro(static_cast<int>(rng() % c.base.libros.size()) + 1);
+            isbn.insert(3, 1, '-');
+            sumidero = sumidero + c.base.buscarLibroPorIsbn(isbn).has_value();
+        });
+    });
+    agregar("buscar_estudiante_id", [](Contexto& c) {
+        std::mt19937 rng(2);
+        return medirOperaciones("buscar_estudiante_id", 1000000, 64, [&](std::size_t) {
+            sumidero = sumidero +
+                       (c.base.buscarEstudiantePorId(static_cast<int>(rng() % c.base.estudiantes.size()) + 1) != nullptr);
+        });
+    });
+    agregar("buscar_prestamo_id", [](Contexto& c) {
+        std::mt19937 rng(3);
+        return medirOperaciones("buscar_prestamo_id", 1000000, 64, [&](std::size_t) {
+            sumidero = sumidero +
+                       c.base.buscarPrestamoPorId(static_cast<int>(rng() % c.base.prestamos.size()) + 1).has_value();
+        });
+    });
+
+    // Búsqueda de texto: términos raros, frecuentes ("titulo" está en todos) y combinados
+    agregar("buscar_texto", [](Contexto& c) {
+        std::mt19937 rng(5);
+        const char* plantillas[] = {"%d", "titulo %d", "tomo %d", "Título %d, tomo 2"};
+        char consulta[64];
+        return medirOperaciones("buscar_texto", 20000, 1, [&](std::size_t i) {
+            int id = static_cast<int>(rng() % c.base.libros.size()) + 1;
+            std::snprintf(consulta, sizeof(consulta), plantillas[i % 4], id);
+            sumidero = sumidero + c.base.buscarTexto(consulta).libros.size();
+        });
+    });
+
+    // Autocompletado: prefijos cortos (muchas coincidencias) y casi completos
+    agregar("completar_titulo", [](Contexto& c) {
+        std::mt19937 rng(6);
+        return medirOperaciones("completar_titulo", 100000, 1, [&](std::size_t i) {
+            std::string id = std::to_string(rng() % c.base.libros.size() + 1);
+            std::string prefijo = "Titulo " + id.substr(0, 1 + i % id.size());
+            sumidero = sumidero + c.base.completarLibros(prefijo).size();
+        });
+    });
+    agregar("completar_estudiante", [](Contexto& c) {
+        std::mt19937 rng(7);
+        return medirOperaciones("completar_estudiante", 100000, 1, [&](std::size_t i) {
+            std::string id = std::to_string(rng() % c.base.estudiantes.size() + 1);
+            std::string prefijo = "estudiante " + id.substr(0, 1 + i % id.size());
+            sumidero = sumidero + c.base.completarEstudiantes(prefijo).size();
+        });
+    });
+
+    // Escaneos y agregados: la tabla por columnas frente a una copia como vector de structs
+    agregar("libros_por_anio", [](Contexto& c) {
+        return medirRepeticiones("libros_por_anio", 10, c.base.libros.size(),
+                                 [&] { sumidero = sumidero + c.base.librosPorAnio().size(); });
+    });
+    agregar("libros_por_anio_filas", [](Contexto& c) {
+        std::vector<Libro> filas(c.base.libros.begin(), c.base.libros.end());
+        return medirRepeticiones("libros_por_anio_filas", 10, filas.size(), [&] {
+            std::unordered_map<int, std::size_t> conteo;
+            for (const auto& l : filas) ++conteo[l.anio];
+            sumidero = sumidero + conteo.size();
+        });
+    });
+    agregar("prestamos_entre", [](Contexto& c) {
+        Fecha desde = Fecha::desdeCivil(2025, 3, 1), hasta = Fecha::desdeCivil(2025, 3, 31);
+        return medirRepeticiones("prestamos_entre", 10, c.base.prestamos.size(),
+                                 [&] { sumidero = sumidero + c.base.prestamosEntre(desde, hasta).size(); });
+    });
+    agregar("prestamos_entre_filas", [](Contexto& c) {
+        Fecha desde = Fecha::desdeCivil(2025, 3, 1), hasta = Fecha::desdeCivil(2025, 3, 31);
+        std::vector<Prestamo> filas(c.base.prestamos.begin(), c.base.prestamos.end());
+        return medirRepeticiones("prestamos_entre_filas", 10, filas.size(), [&] {
+            std::vector<const Prestamo*> encontrados;
+            for (const auto& p : filas) {
+                if (p.fecha_prestamo >= desde && p.fecha_prestamo <= hasta) encontrados.push_back(&p);
+            }
+            sumidero = sumidero + encontrados.size();
+        });
+    });
+
+    // Agrupar por un campo codificado frente a agrupar por texto
+    agregar("estudiantes_por_grado", [](Contexto& c) {
+        return medirRepeticiones("estudiantes_por_grado", 10, c.base.estudiantes.size(),
+                                 [&] { sumidero = sumidero + c.base.estudiantesPorGrado().size(); });
+    });
+    agregar("estudiantes_por_grado_texto", [](Contexto& c) {
+        std::vector<DatosAnteriores::Estudiante> filas;
+        filas.reserve(c.base.estudiantes.size());
+        for (const auto& e : c.base.estudiantes) filas.push_back({e.id, std::string(e.nombre), std::string(c.base.textoGrado(e.grado))});
+        return medirRepeticiones("estudiantes_por_grado_texto", 10, filas.size(), [&] {
+            std::unordered_map<std::string, std::size_t> conteo;
+            for (const auto& e : filas) ++conteo[e.grado];
+            sumidero = sumidero + conteo.size();
+        });
+    });
+
+    // Listados con joins (la salida se descarta)
+    agregar("listar_libros", [](Contexto& c) {
+        SilenciarCout silencio;
+        return medirRepeticiones("listar_libros", 3, c.base.libros.size(), [&] { c.base.listarLibros(); });
+    });
+    agregar("listar_prestamos", [](Contexto& c) {
+        SilenciarCout silencio;
+        return medirRepeticiones("listar_prestamos", 3, c.base.prestamos.size(), [&] { c.base.listarPrestamos(); });
+    });
+    agregar("listar_prestamos_estudiante", [](Contexto& c) {
+        SilenciarCout silencio;
+        std::mt19937 rng(4);
+        return medirOperaciones("listar_prestamos_estudiante", 10000, 1, [&](std::size_t) {
+            c.base.listarPrestamosPorEstudiante(static_cast<int>(rng() % c.base.estudiantes.size()) + 1);
+        });
+    });
+
+    // Eliminación de editoriales: la verificación de referencias usa el índice inverso
+    agregar("eliminar_editoriales_lote", [](Contexto& c) {
+        SilenciarCout silencio;
+        BibliotecaDB db;
+        prepararTrabajo(db);
+        db.iniciarLote();
+        // La mitad son rechazadas (con libros); las que se agregan sin libros se eliminan
+        Editorial ed;
+        ed.nombre = "Editorial sin libros";
+        int n = std::min(c.filas, 20000);
+        for (int i = 0; i < n / 2; ++i) {
+            ed.id = db.nextEditorialId();
+            db.agregarEditorial(ed);
+        }
+        int total = static_cast<int>(db.editoriales.size());
+        Resultado r = medirOperaciones("eliminar_editoriales_lote", static_cast<std::size_t>(n), 1, [&](std::size_t i) {
+            int id = i % 2 == 0 ? total - static_cast<int>(i / 2) : static_cast<int>(i / 2) % numEditoriales(c.filas) + 1;
+            sumidero = sumidero + db.eliminarEditorial(id);
+        });
+        db.terminarLote();
+        return r;
+    });
+
+    // Altas de libros sobre la base completa (la unicidad del ISBN se verifica en cada una)
+    agregar("agregar_libros_lote", [](Contexto& c) {
+        SilenciarCout silencio;
+        BibliotecaDB db;
+        prepararTrabajo(db);
+        db.iniciarLote();
+        Libro l;
+        l.anio = 2000;
+        l.id_autor = 1;
+        l.id_editorial = 1;
+        l.titulo = "Libro nuevo";
+        Resultado r = medirOperaciones("agregar_libros_lote", std::min(c.filas, 100000), 1, [&](std::size_t i) {
+            l.id = db.nextLibroId();
+            Isbn::parsear(isbnDeLibro(static_cast<int>(i) + 1, "979"), l.isbn);
+            sumidero = sumidero + db.agregarLibro(l);
+        });
+        db.terminarLote();
+        return r;
+    });
+
+    // Flujos de préstamos y devoluciones
+    agregar("prestar_devolver_lote", [](Contexto& c) {
+        SilenciarCout silencio;
+        return prestarDevolver("prestar_devolver_lote", std::min<std::size_t>(c.filas, 100000), ESCRITURA_LOTE);
+    });
+    agregar("prestar_devolver_diario", [](Contexto& c) {
+        SilenciarCout silencio;
+        return prestarDevolver("prestar_devolver_diario", std::min<std::size_t>(c.filas, 100000), ESCRITURA_DIARIO);
+    });
+    agregar("prestar_devolver_transaccion", [](Contexto& c) {
+        // Una escritura atómica de prestamos.txt por cada PARES_POR_TRANSACCION pares
+        return prestarDevolver("prestar_devolver_transaccion", std::min<std::size_t>(c.filas, 2000),
+                               ESCRITURA_TRANSACCION);
+    });
+    // Devoluciones/s con escritura inmediata sobre todo el historial de préstamos (en orden
+    // aleatorio): con registros de ancho fijo cada una reescribe solo su registro; con filas
+    // de largo variable, prestamos.txt completo (por eso se miden pocas). Usa la base
+    // compartida, que no cabría dos veces en memoria con 10^7 préstamos, y después la recarga
+    lista.push_back({"devolver", [](Contexto& c) {
+        SilenciarCout silencio;
+        std::filesystem::remove_all(TRABAJO);
+        std::filesystem::create_directories(TRABAJO);
+        std::vector<int> activos;
+        for (std::size_t i = 0; i < c.base.prestamos.size(); ++i) {
+            if (c.base.prestamos.fechasDevolucion()[i].vacia()) activos.push_back(c.base.prestamos.ids()[i]);
+        }
+        std::shuffle(activos.begin(), activos.end(), std::mt19937(11));
+        Fecha fecha = Fecha::desdeCivil(2026, 1, 15);
+        std::vector<Resultado> resultados;
+        std::size_t siguiente = 0;
+        c.base.setDirectorio(TRABAJO);
+        for (bool fijos : {true, false}) {
+            c.base.setPrestamosAnchoFijo(fijos);
+            c.base.guardarDatos(); // prestamos.txt en el formato que se mide
+            // Con pocos préstamos activos se reservan los de la reescritura
+            std::size_t disponibles = activos.size() - siguiente - (fijos ? std::min<std::size_t>(activos.size(), 3) : 0);
+            std::size_t n = std::min<std::size_t>(disponibles, fijos ? 5000 : 3);
+            resultados.push_back(medirOperaciones(fijos ? "devolver_en_lugar" : "devolver_reescritura", n, 1,
+                                                  [&](std::size_t i) {
+                sumidero = sumidero + c.base.devolverPrestamo(activos[siguiente + i], fecha);
+            }));
+            siguiente += n;
+        }
+        c.base.setPrestamosAnchoFijo(false);
+        c.base.setDirectorio(DIRECTORIO);
+        c.base.cargarDatos(); // Descarta las devoluciones
+        return resultados;
+    }});
+    // Escritura diferida con un volcado por segundo como máximo
+    agregar("prestar_devolver_diferido", [](Contexto& c) {
+        SilenciarCout silencio;
+        return prestarDevolver("prestar_devolver_diferido", std::min<std::size_t>(c.filas, 100000),
+                               ESCRITURA_DIFERIDA);
+    });
+    agregar("prestar_devolver_inmediato", [](Contexto&) {
+        // Cada operación reescribe prestamos.txt completo: pocas repeticiones bastan
+        SilenciarCout silencio;
+        return prestarDevolver("prestar_devolver_inmediato", 10, ESCRITURA_INMEDIATA);
+    });
+
+    // Escalado de lecturas concurrentes con un escritor activo: Left-Right frente a un
+    // cerrojo de lectura/escritura, de un hilo lector hasta los núcleos disponibles
+    lista.push_back({"concurrente", [](Contexto&) {
+        SilenciarCout silencio; // Préstamos rechazados (libro ya prestado)
+        unsigned nucleos = std::max(1u, std::thread::hardware_concurrency());
+        std::vector<unsigned> hilos;
+        for (unsigned h = 1; h < nucleos; h *= 2) hilos.push_back(h);
+        hilos.push_back(nucleos);
+        std::vector<Resultado> resultados;
+        BibliotecaConcurrente concurrente;
+        concurrente.setDirectorio(DIRECTORIO);
+        concurrente.cargarDatos();
+        concurrente.setDirectorio(TRABAJO); // Como en prepararTrabajo: los datos generados no se tocan
+        concurrente.modificar([](BibliotecaDB& db) {
+            db.iniciarLote();
+            return true;
+        });
+        BaseConCerrojo conCerrojo;
+        prepararTrabajo(conCerrojo.db);
+        conCerrojo.db.iniciarLote();
+        for (unsigned h : hilos) {
+            std::string sufijo = "_" + std::to_string(h) + "h";
+            for (auto& r : lecturasConcurrentes("concurrente_left_right" + sufijo, concurrente, h)) {
+                resultados.push_back(r);
+            }
+            for (auto& r : lecturasConcurrentes("concurrente_shared_mutex" + sufijo, conCerrojo, h)) {
+                resultados.push_back(r);
+            }
+        }
+        return resultados;
+    }});
+
+    // Modo fragmentado con 1, 2, 4 y 8 fragmentos: carga en paralelo y préstamos/s de varios
+    // clientes, en memoria (lote) y reescribiendo en cada operación el archivo del fragmento
+    lista.push_back({"fragmentos", [](Contexto& c) {
+        SilenciarCout silencio; // Préstamos rechazados (libro ya prestado)
+        unsigned hilos = std::max(4u, std::thread::hardware_concurrency());
+        int numLibros = static_cast<int>(c.base.libros.size());
+        int numEst = static_cast<int>(c.base.estudiantes.size());
+        std::vector<Resultado> resultados;
+        for (std::size_t n : {1, 2, 4, 8}) {
+            std::string sufijo = "_" + std::to_string(n) + "f";
+            std::string dir = TRABAJO + "/fragmentos" + sufijo;
+            std::filesystem::remove_all(dir);
+            {
+                BibliotecaFragmentada division(n);
+                division.setDirectorio(dir);
+                division.dividir(c.base);
+            }
+            resultados.push_back(medirRepeticiones("fragmentos_carga" + sufijo, 3, 2 * c.filas, [&] {
+                BibliotecaFragmentada f(n);
+                f.setDirectorio(dir);
+                f.cargarDatos();
+            }));
+            BibliotecaFragmentada fragmentada(n);
+            fragmentada.setDirectorio(dir);
+            fragmentada.cargarDatos();
+            resultados.push_back(prestamosFragmentados("fragmentos_prestar_inmediato" + sufijo, fragmentada,
+                                                       numLibros, numEst, hilos));
+            fragmentada.modificarTodos([](BibliotecaDB& db) {
+                db.iniciarLote();
+                return true;
+            });
+            resultados.push_back(prestamosFragmentados("fragmentos_prestar_lote" + sufijo, fragmentada,
+                                                       numLibros, numEst, hilos));
+            std::filesystem::remove_all(dir); // Se termina sin escribir el lote
+        }
+        return resultados;
+    }});
+
+    // Validadores frente a expresiones regulares
+    lista.push_back({"validar_fecha", [](Contexto&) {
+        return compararValidador("validar_fecha", "\\d{4}-\\d{2}-\\d{2}",
+                                 {"2025-10-01", "2024-02-29", "1999-12-31", "2025-1-01", "fecha"}, esFechaValida);
+    }});
+    lista.push_back({"validar_isbn", [](Contexto&) {
+        return compararValidador("validar_isbn", "^[0-9]{10}(-[0-9]{3})?$|^[0-9]{13}$",
+                                 {"9788437604947", "978-84-376-0494-7", "0306406152", "123456789X", "12-34"},
+                                 esIsbnValido);
+    }});
+    lista.push_back({"validar_nombre", [](Contexto&) {
+        return compararValidador("validar_nombre", "^[A-Za-z ]+$",
+                                 {"Gabriel Garcia Marquez", "Ana", "Juan 2", "Maria Lopez Hernandez"}, esNombreValido);
+    }});
+    lista.push_back({"validar_texto", [](Contexto&) {
+        return compararValidador("validar_texto", "^[A-Za-z0-9 ]+$",
+                                 {"Cien anios de soledad", "Fahrenheit 451", "5to Bachillerato", "Titulo, con coma"},
+                                 esTextoValido);
+    }});
+    return lista;
+}
+
+// true si 'nombre' coincide con algún filtro (prefijo) de la lista separada por comas
+bool seleccionado(const std::string& nombre, const std::string& filtros) {
+    if (filtros.empty()) return true;
+    std::size_t inicio = 0;
+    while (inicio <= filtros.size()) {
+        std::size_t fin = filtros.find(',', inicio);
+        if (fin == std::string::npos) fin = filtros.size();
+        std::string filtro = filtros.substr(inicio, fin - inicio);
+        if (!filtro.empty() && nombre.compare(0, filtro.size(), filtro) == 0) return true;
+        inicio = fin + 1;
+    }
+    return false;
+}
+
+} // namespace
+
+/* Uso: benchmark.exe [filas] [--escenarios a,b,...] [--salida resultados.csv]
+ * Genera (o reutiliza) los datos sintéticos de 'filas' libros/préstamos y ejecuta los
+ * escenarios seleccionados (por prefijo de nombre; todos por omisión). Los resultados se
+ * escriben en CSV por la salida estándar y, con --salida, se anexan al archivo indicado.
+ */
+int main(int argc, char* argv[]) {
+    int filas = 1000000;
+    std::string filtros;
+    std::string archivoSalida;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--escenarios" && i + 1 < argc) {
+            filtros = argv[++i];
+        } else if (arg == "--salida" && i + 1 < argc) {
+            archivoSalida = argv[++i];
+        } else if (!arg.empty() && std::all_of(arg.begin(), arg.end(), ::isdigit) && std::stoi(arg) > 0) {
+            filas = std::stoi(arg);
+        } else {
+            std::cerr << "Uso: benchmark.exe [filas] [--escenarios a,b,...] [--salida archivo.csv]\n";
+            return 1;
+        }
+    }
+
+    generarDatos(filas);
+    std::cerr << "Datos: " << filas << " libros/prestamos, " << bytesDatos() / (1024.0 * 1024.0) << " MB\n";
+
+    Contexto c;
+    c.filas = filas;
+    c.base.setDirectorio(DIRECTORIO);
+    c.base.cargarDatos();
+
+    std::ofstream archivo;
+    if (!archivoSalida.empty()) {
+        bool nuevo = !std::filesystem::exists(archivoSalida) || std::filesystem::file_size(archivoSalida) == 0;
+        archivo.open(archivoSalida, std::ios::app);
+        if (nuevo) archivo << CABECERA << "\n";
+    }
+    std::cout << CABECERA << "\n";
+    for (const auto& e : escenarios()) {
+        if (!seleccionado(e.nombre, filtros)) continue;
+        std::cerr << "Ejecutando " << e.nombre << "...\n";
+        for (const auto& r : e.ejecutar(c)) {
+            reportar(std::cout, filas, r);
+            if (archivo) reportar(archivo, filas, r);
+        }
+    }
+    std::filesystem::remove_all(TRABAJO);
+    if (verificacionesFallidas.load() > 0) {
+        std::cerr << "FALLA: " << verificacionesFallidas.load() << " lecturas inconsistentes en total\n";
+        return 1;
+    }
+    return 0;
+}
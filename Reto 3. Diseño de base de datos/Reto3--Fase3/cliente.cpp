@@ -0,0 +1,171 @@
+#include "Red.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Generador de carga para el modo servidor de biblioteca.exe: abre varias conexiones
+// locales, envía una mezcla de consultas y préstamos/devoluciones y mide el rendimiento
+// total y la latencia de cada petición (ida y vuelta).
+
+namespace {
+
+struct Opciones {
+    std::string host = "127.0.0.1";
+    int puerto = 5050;
+    int conexiones = 8;
+    int peticiones = 10000;   // Por conexión
+    int escrituras = 10;      // Porcentaje de peticiones que modifican datos
+};
+
+// Resultado de una conexión
+struct Medicion {
+    std::vector<double> latencias; // ns por petición
+    std::size_t errores = 0;       // Respuestas "ERROR" o conexiones fallidas
+};
+
+// Envía una línea y espera su respuesta; retorna false si la conexión se pierde
+bool peticion(red::Socket s, red::LectorLineas& lector, const std::string& linea, std::string& respuesta) {
+    std::string datos = linea + "\n";
+    return red::enviar(s, datos.data(), datos.size()) && lector.siguiente(respuesta);
+}
+
+// Bucle de un cliente: alterna consultas al azar y pares prestar/devolver
+void simularCliente(const Opciones& op, int semilla, int libros, int estudiantes, int prestamos, Medicion& m) {
+    red::Socket s = red::conectar(op.host, op.puerto);
+    if (s == red::SOCKET_INVALIDO) {
+        m.errores = static_cast<std::size_t>(op.peticiones);
+        return;
+    }
+    red::LectorLineas lector(s);
+    std::mt19937 rng(static_cast<unsigned>(semilla));
+    std::string linea, respuesta;
+    int prestamoPendiente = 0; // Préstamo creado por este cliente que falta devolver
+    m.latencias.reserve(static_cast<std::size_t>(op.peticiones));
+
+    for (int i = 0; i < op.peticiones; ++i) {
+        if (static_cast<int>(rng() % 100) < op.escrituras) {
+            if (prestamoPendiente) {
+                linea = "devolver " + std::to_string(prestamoPendiente);
+            } else {
+                linea = "prestar " + std::to_string(rng() % libros + 1) + " " + std::to_string(rng() % estudiantes + 1);
+            }
+        } else {
+            switch (rng() % 3) {
+                case 0: linea = "libro " + std::to_string(rng() % libros + 1); break;
+                case 1: linea = "prestamo " + std::to_string(rng() % prestamos + 1); break;
+                default: linea = "activo " + std::to_string(rng() % libros + 1); break;
+            }
+        }
+
+        auto inicio = std::chrono::steady_clock::now();
+        if (!peticion(s, lector, linea, respuesta)) {
+            m.errores += static_cast<std::size_t>(op.peticiones - i);
+            break;
+        }
+        m.latencias.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - inicio).count());
+
+        bool ok = respuesta.compare(0, 2, "OK") == 0;
+        if (!ok) ++m.errores;
+        if (linea.compare(0, 8, "devolver") == 0) {
+            prestamoPendiente = 0;
+        } else if (ok && linea.compare(0, 7, "prestar") == 0) {
+            prestamoPendiente = std::atoi(respuesta.c_str() + 3);
+        }
+    }
+    if (prestamoPendiente) peticion(s, lector, "devolver " + std::to_string(prestamoPendiente), respuesta);
+    peticion(s, lector, "salir", respuesta);
+    red::cerrar(s);
+}
+
+// Percentil 'q' (0..1) de un vector ya ordenado
+double percentil(const std::vector<double>& ordenadas, double q) {
+    if (ordenadas.empty()) return 0.0;
+    std::size_t i = static_cast<std::size_t>(q * static_cast<double>(ordenadas.size()));
+    return ordenadas[std::min(i, ordenadas.size() - 1)];
+}
+
+} // namespace
+
+/* Uso: cliente.exe [--host h] [--puerto p] [--conexiones n] [--peticiones n] [--escrituras pct] [--apagar]
+ * Requiere un servidor en marcha (biblioteca.exe --servidor <puerto>). Imprime una fila CSV
+ * con peticiones/s y percentiles de latencia; con --apagar detiene el servidor al terminar.
+ */
+int main(int argc, char* argv[]) {
+    Opciones op;
+    bool apagar = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hayValor = i + 1 < argc;
+        if (arg == "--host" && hayValor) {
+            op.host = argv[++i];
+        } else if (arg == "--puerto" && hayValor) {
+            op.puerto = std::atoi(argv[++i]);
+        } else if (arg == "--conexiones" && hayValor) {
+            op.conexiones = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--peticiones" && hayValor) {
+            op.peticiones = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--escrituras" && hayValor) {
+            op.escrituras = std::min(100, std::max(0, std::atoi(argv[++i])));
+        } else if (arg == "--apagar") {
+            apagar = true;
+        } else {
+            std::cerr << "Opcion desconocida: " << arg << "\n";
+            return 1;
+        }
+    }
+    if (!red::iniciar()) return 1;
+
+    // El tamaño de las tablas define el rango de IDs a consultar
+    red::Socket control = red::conectar(op.host, op.puerto);
+    if (control == red::SOCKET_INVALIDO) {
+        std::cerr << "Error: no se pudo conectar con " << op.host << ":" << op.puerto << ".\n";
+        return 1;
+    }
+    red::LectorLineas lector(control);
+    std::string respuesta;
+    int estudiantes = 0, autores = 0, editoriales = 0, libros = 0, prestamos = 0;
+    if (!peticion(control, lector, "resumen", respuesta) || respuesta.compare(0, 3, "OK ") != 0) {
+        std::cerr << "Error: respuesta inesperada del servidor.\n";
+        return 1;
+    }
+    std::istringstream(respuesta.substr(3)) >> estudiantes >> autores >> editoriales >> libros >> prestamos;
+    libros = std::max(libros, 1);
+    estudiantes = std::max(estudiantes, 1);
+    prestamos = std::max(prestamos, 1);
+
+    std::vector<Medicion> mediciones(static_cast<std::size_t>(op.conexiones));
+    std::vector<std::thread> hilos;
+    auto inicio = std::chrono::steady_clock::now();
+    for (int c = 0; c < op.conexiones; ++c) {
+        hilos.emplace_back(simularCliente, std::cref(op), c + 1, libros, estudiantes, prestamos,
+                           std::ref(mediciones[static_cast<std::size_t>(c)]));
+    }
+    for (auto& h : hilos) h.join();
+    double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+
+    std::vector<double> todas;
+    std::size_t errores = 0;
+    for (const auto& m : mediciones) {
+        todas.insert(todas.end(), m.latencias.begin(), m.latencias.end());
+        errores += m.errores;
+    }
+    std::sort(todas.begin(), todas.end());
+
+    std::cout << "conexiones,peticiones,escrituras_pct,segundos,ops_por_s,p50_ns,p90_ns,p99_ns,p999_ns,max_ns,errores\n"
+              << std::fixed << std::setprecision(6) << op.conexiones << "," << todas.size() << "," << op.escrituras
+              << "," << segundos << "," << std::setprecision(1)
+              << (segundos > 0 ? static_cast<double>(todas.size()) / segundos : 0.0) << ","
+              << percentil(todas, 0.50) << "," << percentil(todas, 0.90) << "," << percentil(todas, 0.99) << ","
+              << percentil(todas, 0.999) << "," << (todas.empty() ? 0.0 : todas.back()) << "," << errores << "\n";
+
+    if (apagar) peticion(control, lector, "apagar", respuesta);
+    red::cerrar(control);
+    return 0;
+}
@@ -1,9 +1,18 @@
 #include "Biblioteca.h"
+#include "BibliotecaConcurrente.h"
+#include "Lote.h"
+#include "Servidor.h"
+#include "Validacion.h"
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
 #include <iostream>
 #include <limits>
 #include <string>
-#include <regex>
-#include <sstream>
+#include <thread>
+#include <vector>
 
 /* Valida que la entrada para opciones de menú sea un número entero no negativo (>= 0).
  * Parámetros:
@@ -47,7 +56,6 @@ bool leerEnteroPositivo(int& valor) {
  */
 std::string leerNombreValido(const std::string& mensaje, const std::string& tipo) {
     std::string input;
-    std::regex patron("^[A-Za-z ]+$");
     while (true) {
         std::cout << mensaje;
         std::getline(std::cin, input);
@@ -55,7 +63,7 @@ std::string leerNombreValido(const std::string& mensaje, const std::string& tipo
             std::cout << "Error: " << tipo << " no puede estar vacio.\n";
             continue;
         }
-        if (std::regex_match(input, patron)) {
+        if (esNombreValido(input)) {
             return input;
         } else {
             std::cout << "Error: " << tipo << " solo puede contener letras y espacios.\n";
@@ -71,7 +79,6 @@ std::string leerNombreValido(const std::string& mensaje, const std::string& tipo
  */
 std::string leerCadenaValida(const std::string& mensaje, const std::string& tipo) {
     std::string input;
-    std::regex patron("^[A-Za-z0-9 ]+$");
     while (true) {
         std::cout << mensaje;
         std::getline(std::cin, input);
@@ -79,7 +86,7 @@ std::string leerCadenaValida(const std::string& mensaje, const std::string& tipo
             std::cout << "Error: " << tipo << " no puede estar vacio.\n";
             continue;
         }
-        if (std::regex_match(input, patron)) {
+        if (esTextoValido(input)) {
             return input;
         } else {
             std::cout << "Error: " << tipo << " solo puede contener letras, espacios y numeros.\n";
@@ -87,21 +94,21 @@ std::string leerCadenaValida(const std::string& mensaje, const std::string& tipo
     }
 }
 
-/* Valida que una entrada de ISBN tenga 10 o 13 dígitos, con guiones opcionales.
+/* Valida que una entrada de ISBN tenga 10 o 13 dígitos, con guiones opcionales y dígito de control correcto.
  * Parámetros:
  *   - mensaje: Texto a mostrar para solicitar la entrada.
- * Retorna: ISBN válido en el formato especificado.
+ * Retorna: ISBN válido, normalizado (ver Isbn.h).
  */
-std::string leerISBN(const std::string& mensaje) {
+Isbn leerISBN(const std::string& mensaje) {
     std::string input;
-    std::regex patron("^[0-9]{10}(-[0-9]{3})?$|^[0-9]{13}$");
     while (true) {
         std::cout << mensaje;
         std::getline(std::cin, input);
-        if (std::regex_match(input, patron)) {
-            return input;
+        Isbn isbn;
+        if (esIsbnValido(input) && Isbn::parsear(input, isbn)) {
+            return isbn;
         } else {
-            std::cout << "Error: ISBN debe tener 10 o 13 digitos (guiones opcionales, ej. 1234567890 o 123-456-789-0123).\n";
+            std::cout << "Error: ISBN debe tener 10 o 13 digitos con digito de control valido (guiones opcionales, ej. 0-306-40615-2 o 978-84-376-0494-7).\n";
         }
     }
 }
@@ -109,30 +116,27 @@ std::string leerISBN(const std::string& mensaje) {
 /* Lee y valida una fecha en formato YYYY-MM-DD, usando la fecha actual si se omite.
  * Parámetros:
  *   - mensaje: Texto a mostrar para solicitar la entrada.
- *   - db: Instancia de BibliotecaDB para obtener la fecha actual.
- * Retorna: Fecha válida en formato YYYY-MM-DD.
+ * Retorna: Fecha válida (entre 1900 y el año actual).
  */
-std::string leerFecha(const std::string& mensaje, BibliotecaDB& db) {
+Fecha leerFecha(const std::string& mensaje) {
     std::string input;
-    std::regex dateRegex("\\d{4}-\\d{2}-\\d{2}");
+    int anioActual, mesActual, diaActual;
+    Fecha::hoy().aCivil(anioActual, mesActual, diaActual);
     while (true) {
         std::cout << mensaje;
         std::getline(std::cin, input);
         if (input.empty()) {
-            return db.fechaHoy(); // Usar fecha actual si no se ingresa nada.
+            return Fecha::hoy(); // Usar fecha actual si no se ingresa nada.
         }
-        // Validar formato de fecha.
-        if (!std::regex_match(input, dateRegex)) {
+        // Validar formato de fecha y extraer sus componentes.
+        int year, month, day;
+        if (!descomponerFecha(input, year, month, day)) {
             std::cout << "Error: Formato de fecha invalido (use YYYY-MM-DD).\n";
             continue;
         }
-        int year, month, day;
-        char dash1, dash2;
-        std::istringstream iss(input);
-        iss >> year >> dash1 >> month >> dash2 >> day;
         // Validar componentes de la fecha.
-        if (dash1 != '-' || dash2 != '-' || year < 1900 || year > 2025 || month < 1 || month > 12 || day < 1 || day > 31) {
-            std::cout << "Error: Fecha invalida (use anios entre 1900 y 2025, meses 1-12, dias 1-31).\n";
+        if (year < 1900 || year > anioActual || month < 1 || month > 12 || day < 1 || day > 31) {
+            std::cout << "Error: Fecha invalida (use anios entre 1900 y " << anioActual << ", meses 1-12, dias 1-31).\n";
             continue;
         }
         // Validar días según el mes.
@@ -147,7 +151,46 @@ std::string leerFecha(const std::string& mensaje, BibliotecaDB& db) {
                 continue;
             }
         }
-        return input;
+        return Fecha::desdeCivil(year, month, day);
+    }
+}
+
+/* Autocompletado por prefijo: cada línea ingresada es un nuevo prefijo (o el anterior
+ * con más letras) y se muestran las primeras coincidencias; "+" muestra las siguientes.
+ * Parámetros:
+ *   - db: Instancia de BibliotecaDB para acceder a los datos.
+ *   - libros: true para títulos de libros, false para nombres de estudiantes.
+ */
+void autocompletar(const BibliotecaDB& db, bool libros) {
+    const std::size_t porPagina = 10;
+    std::string prefijo, input;
+    std::size_t mostrados = 0;
+    while (true) {
+        std::cout << (libros ? "Titulo" : "Nombre") << " (inicio; + para ver mas, vacio para volver): ";
+        std::getline(std::cin, input);
+        if (input.empty()) return;
+        if (input == "+") {
+            if (prefijo.empty()) continue;
+        } else {
+            prefijo = input;
+            mostrados = 0;
+        }
+        std::vector<int> ids = libros ? db.completarLibros(prefijo, porPagina, mostrados)
+                                      : db.completarEstudiantes(prefijo, porPagina, mostrados);
+        for (int id : ids) {
+            if (libros) {
+                std::optional<Libro> l = db.buscarLibroPorId(id);
+                if (l) std::cout << "  ID: " << l->id << " | Titulo: " << l->titulo << "\n";
+            } else {
+                const Estudiante* e = db.buscarEstudiantePorId(id);
+                if (e) {
+                    std::cout << "  ID: " << e->id << " | Nombre: " << e->nombre << " | Grado: " << db.textoGrado(e->grado)
+                              << "\n";
+                }
+            }
+        }
+        if (ids.empty()) std::cout << (mostrados == 0 ? "  Sin coincidencias.\n" : "  No hay mas coincidencias.\n");
+        mostrados += ids.size();
     }
 }
 
@@ -163,6 +206,8 @@ void menuEstudiantes(BibliotecaDB& db) {
                   << "3) Buscar estudiante por ID\n"
                   << "4) Actualizar estudiante\n"
                   << "5) Eliminar estudiante\n"
+                  << "6) Buscar estudiante por nombre (autocompletar)\n"
+                  << "7) Cantidad de estudiantes por grado\n"
                   << "0) Volver\n"
                   << "Opcion: ";
         int op;
@@ -170,12 +215,11 @@ void menuEstudiantes(BibliotecaDB& db) {
         if (op == 0) break; // Salir del submenú.
         switch (op) {
             case 1: {
-                Estudiante e;
-                e.id = db.nextEstudianteId();
-                e.nombre = leerNombreValido("Nombre: ", "Nombre");
-                e.grado = leerCadenaValida("Grado: ", "Grado");
-                if (db.agregarEstudiante(e)) {
-                    std::cout << "Estudiante agregado con ID " << e.id << ".\n";
+                int id = db.nextEstudianteId();
+                std::string nombre = leerNombreValido("Nombre: ", "Nombre");
+                std::string grado = leerCadenaValida("Grado: ", "Grado");
+                if (db.agregarEstudiante(id, nombre, grado)) {
+                    std::cout << "Estudiante agregado con ID " << id << ".\n";
                 } else {
                     std::cout << "Error al agregar estudiante.\n";
                 }
@@ -188,9 +232,9 @@ void menuEstudiantes(BibliotecaDB& db) {
                 int id;
                 std::cout << "ID: ";
                 if (!leerEnteroPositivo(id)) break;
-                Estudiante* e = db.buscarEstudiantePorId(id);
+                const Estudiante* e = db.buscarEstudiantePorId(id);
                 if (e) {
-                    std::cout << "ID: " << e->id << " | Nombre: " << e->nombre << " | Grado: " << e->grado << "\n";
+                    std::cout << "ID: " << e->id << " | Nombre: " << e->nombre << " | Grado: " << db.textoGrado(e->grado) << "\n";
                 } else {
                     std::cout << "Estudiante no encontrado.\n";
                 }
@@ -218,6 +262,12 @@ void menuEstudiantes(BibliotecaDB& db) {
                 }
                 break;
             }
+            case 6:
+                autocompletar(db, false);
+                break;
+            case 7:
+                db.listarEstudiantesPorGrado();
+                break;
             default:
                 std::cout << "Opcion invalida.\n";
         }
@@ -236,6 +286,8 @@ void menuAutores(BibliotecaDB& db) {
                   << "3) Buscar autor por ID\n"
                   << "4) Actualizar autor\n"
                   << "5) Eliminar autor\n"
+                  << "6) Listar libros del autor\n"
+                  << "7) Cantidad de autores por nacionalidad\n"
                   << "0) Volver\n"
                   << "Opcion: ";
         int op;
@@ -243,12 +295,11 @@ void menuAutores(BibliotecaDB& db) {
         if (op == 0) break; // Salir del submenú.
         switch (op) {
             case 1: {
-                Autor a;
-                a.id = db.nextAutorId();
-                a.nombre = leerNombreValido("Nombre: ", "Nombre");
-                a.nacionalidad = leerCadenaValida("Nacionalidad: ", "Nacionalidad");
-                if (db.agregarAutor(a)) {
-                    std::cout << "Autor agregado con ID " << a.id << ".\n";
+                int id = db.nextAutorId();
+                std::string nombre = leerNombreValido("Nombre: ", "Nombre");
+                std::string nacionalidad = leerCadenaValida("Nacionalidad: ", "Nacionalidad");
+                if (db.agregarAutor(id, nombre, nacionalidad)) {
+                    std::cout << "Autor agregado con ID " << id << ".\n";
                 } else {
                     std::cout << "Error al agregar autor.\n";
                 }
@@ -261,9 +312,10 @@ void menuAutores(BibliotecaDB& db) {
                 int id;
                 std::cout << "ID: ";
                 if (!leerEnteroPositivo(id)) break;
-                Autor* a = db.buscarAutorPorId(id);
+                const Autor* a = db.buscarAutorPorId(id);
                 if (a) {
-                    std::cout << "ID: " << a->id << " | Nombre: " << a->nombre << " | Nacionalidad: " << a->nacionalidad << "\n";
+                    std::cout << "ID: " << a->id << " | Nombre: " << a->nombre
+                              << " | Nacionalidad: " << db.textoNacionalidad(a->nacionalidad) << "\n";
                 } else {
                     std::cout << "Autor no encontrado.\n";
                 }
@@ -291,6 +343,16 @@ void menuAutores(BibliotecaDB& db) {
                 }
                 break;
             }
+            case 6: {
+                int id;
+                std::cout << "ID Autor: ";
+                if (!leerEnteroPositivo(id)) break;
+                db.listarLibrosPorAutor(id);
+                break;
+            }
+            case 7:
+                db.listarAutoresPorNacionalidad();
+                break;
             default:
                 std::cout << "Opcion invalida.\n";
         }
@@ -309,6 +371,7 @@ void menuEditoriales(BibliotecaDB& db) {
                   << "3) Buscar editorial por ID\n"
                   << "4) Actualizar editorial\n"
                   << "5) Eliminar editorial\n"
+                  << "6) Listar libros de la editorial\n"
                   << "0) Volver\n"
                   << "Opcion: ";
         int op;
@@ -318,7 +381,8 @@ void menuEditoriales(BibliotecaDB& db) {
             case 1: {
                 Editorial ed;
                 ed.id = db.nextEditorialId();
-                ed.nombre = leerCadenaValida("Nombre: ", "Nombre");
+                std::string nombre = leerCadenaValida("Nombre: ", "Nombre"); // 'ed' guarda solo una vista
+                ed.nombre = nombre;
                 if (db.agregarEditorial(ed)) {
                     std::cout << "Editorial agregada con ID " << ed.id << ".\n";
                 } else {
@@ -333,7 +397,7 @@ void menuEditoriales(BibliotecaDB& db) {
                 int id;
                 std::cout << "ID: ";
                 if (!leerEnteroPositivo(id)) break;
-                Editorial* ed = db.buscarEditorialPorId(id);
+                const Editorial* ed = db.buscarEditorialPorId(id);
                 if (ed) {
                     std::cout << "ID: " << ed->id << " | Nombre: " << ed->nombre << "\n";
                 } else {
@@ -363,12 +427,36 @@ void menuEditoriales(BibliotecaDB& db) {
                 }
                 break;
             }
+            case 6: {
+                int id;
+                std::cout << "ID Editorial: ";
+                if (!leerEnteroPositivo(id)) break;
+                db.listarLibrosPorEditorial(id);
+                break;
+            }
             default:
                 std::cout << "Opcion invalida.\n";
         }
     }
 }
 
+/* Muestra los datos de un libro con los nombres de su autor y editorial.
+ * Parámetros:
+ *   - db: Instancia de BibliotecaDB para acceder a los datos.
+ *   - l: Libro a mostrar; vacío si la búsqueda no lo encontró.
+ */
+void mostrarLibro(const BibliotecaDB& db, const std::optional<Libro>& l) {
+    if (!l) {
+        std::cout << "Libro no encontrado.\n";
+        return;
+    }
+    const Autor* a = db.buscarAutorPorId(l->id_autor);
+    const Editorial* ed = db.buscarEditorialPorId(l->id_editorial);
+    std::cout << "ID: " << l->id << " | Titulo: " << l->titulo << " | ISBN: " << l->isbn
+              << " | Anio: " << l->anio << " | Autor: " << (a ? a->nombre : "Desconocido")
+              << " | Editorial: " << (ed ? ed->nombre : "Desconocida") << "\n";
+}
+
 /* Muestra el submenú para gestionar libros, permitiendo operaciones CRUD.
  * Parámetros:
  *   - db: Instancia de BibliotecaDB para acceder a los datos.
@@ -381,6 +469,10 @@ void menuLibros(BibliotecaDB& db) {
                   << "3) Buscar libro por ID\n"
                   << "4) Actualizar libro\n"
                   << "5) Eliminar libro\n"
+                  << "6) Buscar por texto (titulo, autor o editorial)\n"
+                  << "7) Buscar libro por titulo (autocompletar)\n"
+                  << "8) Buscar libro por ISBN\n"
+                  << "9) Cantidad de libros por anio\n"
                   << "0) Volver\n"
                   << "Opcion: ";
         int op;
@@ -390,7 +482,8 @@ void menuLibros(BibliotecaDB& db) {
             case 1: {
                 Libro l;
                 l.id = db.nextLibroId(); // Generar ID único.
-                l.titulo = leerCadenaValida("Titulo: ", "Titulo");
+                std::string titulo = leerCadenaValida("Titulo: ", "Titulo"); // 'l' guarda solo una vista
+                l.titulo = titulo;
                 l.isbn = leerISBN("ISBN: ");
                 std::cout << "Anio de publicacion (1900-2025): ";
                 if (!leerEnteroPositivo(l.anio)) break;
@@ -417,16 +510,7 @@ void menuLibros(BibliotecaDB& db) {
                 int id;
                 std::cout << "ID: ";
                 if (!leerEnteroPositivo(id)) break;
-                Libro* l = db.buscarLibroPorId(id);
-                if (l) {
-                    Autor* a = db.buscarAutorPorId(l->id_autor);
-                    Editorial* ed = db.buscarEditorialPorId(l->id_editorial);
-                    std::cout << "ID: " << l->id << " | Titulo: " << l->titulo << " | ISBN: " << l->isbn
-                              << " | Anio: " << l->anio << " | Autor: " << (a ? a->nombre : "Desconocido")
-                              << " | Editorial: " << (ed ? ed->nombre : "Desconocida") << "\n";
-                } else {
-                    std::cout << "Libro no encontrado.\n";
-                }
+                mostrarLibro(db, db.buscarLibroPorId(id));
                 break;
             }
             case 4: {
@@ -451,6 +535,26 @@ void menuLibros(BibliotecaDB& db) {
                 }
                 break;
             }
+            case 6: {
+                std::string consulta;
+                std::cout << "Texto a buscar: ";
+                std::getline(std::cin, consulta);
+                db.mostrarBusquedaTexto(consulta);
+                break;
+            }
+            case 7:
+                autocompletar(db, true);
+                break;
+            case 8: {
+                std::string isbn;
+                std::cout << "ISBN (con o sin guiones): ";
+                std::getline(std::cin, isbn);
+                mostrarLibro(db, db.buscarLibroPorIsbn(isbn));
+                break;
+            }
+            case 9:
+                db.listarLibrosPorAnio();
+                break;
             default:
                 std::cout << "Opcion invalida.\n";
         }
@@ -470,6 +574,7 @@ void menuPrestamos(BibliotecaDB& db) {
                   << "4) Listar prestamos activos\n"
                   << "5) Buscar prestamo por ID\n"
                   << "6) Listar prestamos por estudiante\n"
+                  << "7) Listar prestamos por rango de fechas\n"
                   << "0) Volver\n"
                   << "Opcion: ";
         int op;
@@ -482,8 +587,7 @@ void menuPrestamos(BibliotecaDB& db) {
                 if (!leerEnteroPositivo(idlib)) break;
                 std::cout << "ID Estudiante: ";
                 if (!leerEnteroPositivo(idest)) break;
-                std::string fecha = db.fechaHoy();
-                fecha = leerFecha("Fecha de prestamo (" + fecha + "): ", db);
+                Fecha fecha = leerFecha("Fecha de prestamo (" + db.fechaHoy() + "): ");
                 if (db.prestarLibro(idlib, idest, fecha)) {
                     std::cout << "Prestamo registrado.\n";
                 } else {
@@ -512,14 +616,14 @@ void menuPrestamos(BibliotecaDB& db) {
                 int idp;
                 std::cout << "ID Prestamo: ";
                 if (!leerEnteroPositivo(idp)) break;
-                Prestamo* p = db.buscarPrestamoPorId(idp);
+                std::optional<Prestamo> p = db.buscarPrestamoPorId(idp);
                 if (p) {
-                    Libro* l = db.buscarLibroPorId(p->id_libro);
-                    Estudiante* e = db.buscarEstudiantePorId(p->id_estudiante);
+                    std::optional<Libro> l = db.buscarLibroPorId(p->id_libro);
+                    const Estudiante* e = db.buscarEstudiantePorId(p->id_estudiante);
                     std::cout << "ID Prestamo: " << p->id << " | Libro: " << (l ? l->titulo : "Desconocido")
                               << " | Estudiante: " << (e ? e->nombre : "Desconocido")
                               << " | Fecha Prestamo: " << p->fecha_prestamo
-                              << " | Fecha Devolucion: " << (p->fecha_devolucion.empty() ? "(Pendiente)" : p->fecha_devolucion) << "\n";
+                              << " | Fecha Devolucion: " << (p->fecha_devolucion.vacia() ? "(Pendiente)" : p->fecha_devolucion.texto()) << "\n";
                 } else {
                     std::cout << "Prestamo no encontrado.\n";
                 }
@@ -532,18 +636,127 @@ void menuPrestamos(BibliotecaDB& db) {
                 db.listarPrestamosPorEstudiante(id);
                 break;
             }
+            case 7: {
+                Fecha desde = leerFecha("Desde (" + db.fechaHoy() + "): ");
+                Fecha hasta = leerFecha("Hasta (" + db.fechaHoy() + "): ");
+                db.listarPrestamosEntre(desde, hasta);
+                break;
+            }
             default:
                 std::cout << "Opcion invalida.\n";
         }
     }
 }
 
+/* Modo servidor: atiende clientes TCP locales sobre una BibliotecaConcurrente, así las
+ * consultas no esperan a las modificaciones (los datos ocupan el doble de memoria).
+ * Reescribir el CSV en cada cambio serializaría a todos los clientes, así que la copia
+ * principal usa el diario; al apagar se compactan los diarios con registros.
+ * Parámetros:
+ *   - persistencia: Configura la persistencia de la copia principal (opciones de la línea de comandos).
+ * Retorna: código de salida del programa.
+ */
+int ejecutarServidor(int puerto, int hilos, bool usarBinario, const std::function<bool(BibliotecaDB&)>& persistencia) {
+    BibliotecaConcurrente base;
+    bool configurada = base.configurar([&](BibliotecaDB& db) {
+        return persistencia(db) && (db.modoDiarioActivo() || db.activarDiario());
+    });
+    if (!configurada) return 1;
+    bool vigente = usarBinario && base.leer([](const BibliotecaDB& db) { return db.snapshotBinarioVigente(); });
+    if (!vigente || !base.cargarDatosBinario()) {
+        if (!base.cargarDatos()) std::cout << "Advertencia: algunos datos no se pudieron cargar.\n";
+    }
+    Servidor servidor(base, hilos > 0 ? static_cast<std::size_t>(hilos) : 1);
+    if (!servidor.iniciar(puerto)) {
+        std::cout << "Error: no se pudo escuchar en el puerto " << puerto << ".\n";
+        return 1;
+    }
+    std::cout << "Servidor escuchando en 127.0.0.1:" << puerto << " (" << hilos
+              << " hilos). Envie \"apagar\" para detenerlo.\n";
+    servidor.ejecutar();
+    base.configurar([&](BibliotecaDB& db) {
+        db.guardarCambios(); // Compacta los diarios con registros
+        if (usarBinario) db.guardarDatosBinario();
+        return true;
+    });
+    std::cout << "Servidor detenido. Datos guardados.\n";
+    return 0;
+}
+
 /* Punto de entrada del sistema de gestión de biblioteca.
  * Inicializa la base de datos, carga datos desde archivos y muestra el menú principal.
+ * Opciones:
+ *   --diario: registra cada cambio en un diario (*.log) en lugar de reescribir los archivos.
+ *   --binario: arranca desde biblioteca.bin si está vigente y lo actualiza al salir.
+ *   --diferido [segundos]: los cambios se escriben al guardar, al salir o (si se indica)
+ *     pasados esos segundos desde la última escritura, en lugar de en cada cambio.
+ *   --ancho-fijo: prestamos.txt se escribe con registros de ancho fijo y cada devolución
+ *     reescribe solo el suyo (ver BibliotecaDB::setPrestamosAnchoFijo).
  */
-int main() {
+int main(int argc, char* argv[]) {
     BibliotecaDB db;
-    db.cargarDatos(); // Cargar datos iniciales desde archivos.
+    bool usarBinario = false;
+    bool usarDiario = false;
+    bool anchoFijo = false;
+    int segundosDiferido = -1;         // --diferido [segundos]; -1 sin escritura diferida
+    const char* archivoLote = nullptr; // --lote <archivo|->: modo no interactivo
+    int puertoServidor = 0;            // --servidor <puerto>: atiende clientes TCP locales
+    int hilosServidor = static_cast<int>(std::thread::hardware_concurrency());
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--diario") {
+            usarDiario = true;
+        } else if (arg == "--binario") {
+            usarBinario = true;
+        } else if (arg == "--ancho-fijo") {
+            anchoFijo = true;
+        } else if (arg == "--diferido") {
+            segundosDiferido = 0;
+            if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0]))) segundosDiferido = std::atoi(argv[++i]);
+        } else if (arg == "--lote" && i + 1 < argc) {
+            archivoLote = argv[++i];
+        } else if (arg == "--servidor" && i + 1 < argc) {
+            puertoServidor = std::atoi(argv[++i]);
+        } else if (arg == "--hilos" && i + 1 < argc) {
+            hilosServidor = std::atoi(argv[++i]);
+        } else {
+            std::cout << "Opcion desconocida: " << arg << "\n";
+            return 1;
+        }
+    }
+    // Persistencia elegida en la línea de comandos (en el servidor, la de su copia principal)
+    auto persistencia = [&](BibliotecaDB& base) {
+        base.setPrestamosAnchoFijo(anchoFijo);
+        if (usarDiario && !base.activarDiario()) return false;
+        if (segundosDiferido >= 0) base.activarEscrituraDiferida(std::chrono::seconds(segundosDiferido));
+        return true;
+    };
+    if (puertoServidor > 0) return ejecutarServidor(puertoServidor, hilosServidor, usarBinario, persistencia);
+    if (!persistencia(db)) return 1;
+
+    // Cargar datos iniciales: snapshot binario si no hay CSV/diarios más nuevos, si no los CSV.
+    // Un CSV dañado sin generación anterior válida se conserva como <archivo>.danado.
+    if (!usarBinario || !db.snapshotBinarioVigente() || !db.cargarDatosBinario()) {
+        if (!db.cargarDatos()) std::cout << "Advertencia: algunos datos no se pudieron cargar.\n";
+    }
+
+    // Modo por lotes: aplica el archivo de comandos y termina sin mostrar el menú.
+    if (archivoLote) {
+        ResultadoLote r;
+        if (std::string(archivoLote) == "-") {
+            r = ejecutarLote(db, std::cin, std::cout);
+        } else {
+            std::ifstream entrada(archivoLote);
+            if (!entrada) {
+                std::cout << "Error al abrir " << archivoLote << ".\n";
+                return 1;
+            }
+            r = ejecutarLote(db, entrada, std::cout);
+        }
+        if (usarBinario) db.guardarDatosBinario();
+        return r.persistido && r.fallidos == 0 ? 0 : 1;
+    }
+
     std::cout << "Bienvenido al Sistema de Gestion de Biblioteca\n";
 
     while (true) {
@@ -555,12 +768,16 @@ int main() {
                   << "5) Gestion de Prestamos\n"
                   << "6) Guardar datos\n"
                   << "7) Cargar datos\n"
+                  << "8) Guardar snapshot binario\n"
+                  << "9) Cargar snapshot binario\n"
                   << "0) Salir\n"
                   << "Opcion: ";
         int op;
         if (!leerOpcionMenu(op)) continue; // Validar entrada numérica.
+        db.volcarSiVencido(); // Con --diferido y un intervalo, escribe lo pendiente si ya venció
         if (op == 0) {
-            db.guardarDatos(); // Guardar datos antes de salir.
+            db.guardarCambios(); // Guardar datos antes de salir (solo las tablas modificadas).
+            if (usarBinario) db.guardarDatosBinario();
             std::cout << "Datos guardados. Saliendo...\n";
             break;
         }
@@ -581,12 +798,18 @@ int main() {
                 menuPrestamos(db);
                 break;
             case 6:
-                db.guardarDatos();
-                std::cout << "Datos guardados.\n";
+                // Solo se reescriben las tablas modificadas desde la última escritura
+                std::cout << (db.guardarCambios() ? "Datos guardados.\n" : "Error: no se pudieron guardar los datos.\n");
                 break;
             case 7:
-                db.cargarDatos();
-                std::cout << "Datos cargados.\n";
+                std::cout << (db.cargarDatos() ? "Datos cargados.\n" : "Advertencia: algunos datos no se pudieron cargar.\n");
+                break;
+            case 8:
+                if (db.guardarDatosBinario()) std::cout << "Snapshot binario guardado.\n";
+                break;
+            case 9:
+                // Reescribe los CSV para que coincidan con el snapshot restaurado.
+                if (db.cargarDatosBinario() && db.guardarDatos()) std::cout << "Snapshot binario cargado.\n";
                 break;
             default:
                 std::cout << "Opcion invalida.\n";
@@ -0,0 +1,655 @@
+#include "Biblioteca.h"
+#include "BibliotecaConcurrente.h"
+#include "BibliotecaFragmentada.h"
+#include "IndiceTexto.h"
+#include "Lote.h"
+#include "Validacion.h"
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Pruebas de comportamiento de BibliotecaDB: cada prueba trabaja en su propio directorio
+// bajo pruebas_datos/ y verifica lo que queda en disco y lo que se recupera al recargar
+// (diario, snapshots, escrituras interrumpidas...). Termina con código 1 si alguna falla.
+
+namespace {
+
+const std::string DIRECTORIO = "pruebas_datos";
+
+int fallosPrueba = 0;   // Verificaciones fallidas de la prueba en curso
+
+// Como assert, pero registra el fallo y sigue con la prueba (también con NDEBUG)
+#define VERIFICAR(condicion) verificar((condicion), #condicion, __FILE__, __LINE__)
+
+void verificar(bool condicion, const char* texto, const char* archivo, int linea) {
+    if (condicion) return;
+    ++fallosPrueba;
+    std::cerr << "  " << archivo << ":" << linea << ": falla " << texto << "\n";
+}
+
+// Descarta los mensajes que BibliotecaDB escribe en std::cout mientras existe
+class Silencio {
+public:
+    Silencio() : anterior(std::cout.rdbuf(nulo.rdbuf())) {}
+    ~Silencio() { std::cout.rdbuf(anterior); }
+    Silencio(const Silencio&) = delete;
+    Silencio& operator=(const Silencio&) = delete;
+
+private:
+    std::ostringstream nulo;
+    std::streambuf* anterior;
+};
+
+std::string leerArchivo(const std::string& ruta) {
+    std::ifstream f(ruta, std::ios::binary);
+    std::stringstream s;
+    s << f.rdbuf();
+    return s.str();
+}
+
+// Directorio vacío para una prueba
+std::string directorioPrueba(const std::string& nombre) {
+    std::string dir = DIRECTORIO + "/" + nombre + "/";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    return dir;
+}
+
+// Libro i del autor 1 y la editorial 1, con un ISBN-13 válido y distinto para cada i.
+// El título es una vista: su texto queda en 'titulos' hasta el final del programa
+Libro libroDePrueba(int i) {
+    static std::set<std::string> titulos;
+    std::string doce = "978" + std::to_string(100000000 + i);
+    int suma = 0;
+    for (std::size_t k = 0; k < doce.size(); ++k) suma += (doce[k] - '0') * (k % 2 == 0 ? 1 : 3);
+    Libro l{i, *titulos.insert("Libro " + std::to_string(i)).first, {}, 2000, 1, 1};
+    Isbn::parsear(doce + static_cast<char>('0' + (10 - suma % 10) % 10), l.isbn);
+    return l;
+}
+
+// Estudiante 1, autor 1, editorial 1 y los libros 1..libros
+void poblar(BibliotecaDB& db, int libros = 1) {
+    db.agregarEstudiante({1, "Ana Lopez", db.codificarGrado("1ro")});
+    db.agregarAutor({1, "Autor Uno", db.codificarNacionalidad("MX")});
+    db.agregarEditorial({1, "Editorial Uno"});
+    for (int i = 1; i <= libros; ++i) db.agregarLibro(libroDePrueba(i));
+}
+
+// --- Pruebas ---
+
+// Un registro confirmado llega al archivo antes de retornar: otra base lo ve sin que la
+// primera cierre ni sincronice el diario, como tras un kill -9
+void diarioSinCerrar() {
+    std::string dir = directorioPrueba("diario_sin_cerrar");
+    BibliotecaDB db;
+    db.setDirectorio(dir);
+    poblar(db);
+    VERIFICAR(db.activarDiario());
+    VERIFICAR(db.prestarLibro(1, 1, Fecha::desdeCivil(2025, 1, 1)));
+    VERIFICAR(!leerArchivo(dir + "prestamos.log").empty());
+    BibliotecaDB tras;
+    tras.setDirectorio(dir);
+    VERIFICAR(tras.cargarDatos());
+    VERIFICAR(tras.prestamoActivoDeLibro(1) == 1);
+}
+
+// Altas, modificaciones y bajas del diario se aplican sobre los CSV al cargar
+void diarioReproduce() {
+    std::string dir = directorioPrueba("diario_reproduce");
+    {
+        BibliotecaDB db;
+        db.setDirectorio(dir);
+        poblar(db, 2);
+        VERIFICAR(db.activarDiario());
+        VERIFICAR(db.prestarLibro(1, 1, Fecha::desdeCivil(2025, 1, 1)));
+        VERIFICAR(db.devolverPrestamo(1, Fecha::desdeCivil(2025, 1, 9)));
+        VERIFICAR(db.eliminarLibro(2));
+        VERIFICAR(db.agregarEditorial({2, "Editorial Dos"}));
+        db.desactivarDiario();
+    }
+    BibliotecaDB db;
+    db.setDirectorio(dir);
+    VERIFICAR(db.cargarDatos());
+    auto p = db.buscarPrestamoPorId(1);
+    VERIFICAR(p && p->fecha_devolucion == Fecha::desdeCivil(2025, 1, 9));
+    VERIFICAR(db.prestamoActivoDeLibro(1) == 0);
+    VERIFICAR(!db.buscarLibroPorId(2) && db.buscarLibroPorId(1));
+    VERIFICAR(db.buscarEditorialPorId(2) != nullptr);
+}
+
+// Una última línea sin '\n' (escritura interrumpida) se descarta y las anteriores se aplican
+void diarioTruncado() {
+    std::string dir = directorioPrueba("diario_truncado");
+    {
+        BibliotecaDB db;
+        db.setDirectorio(dir);
+        poblar(db);
+        VERIFICAR(db.activarDiario());
+        VERIFICAR(db.agregarEditorial({2, "Editorial Dos"}));
+        db.desactivarDiario();
+    }
+    { std::ofstream(dir + "editoriales.log", std::ios::app) << "A,3,Editorial Tr"; }
+    BibliotecaDB db;
+    db.setDirectorio(dir);
+    VERIFICAR(db.cargarDatos());
+    VERIFICAR(db.buscarEditorialPorId(2) != nullptr);
+    VERIFICAR(db.buscarEditorialPorId(3) == nullptr);
+}
+
+// Altas rechazadas o revertidas no dejan valores nuevos en los diccionarios (que también
+// se guardan en el snapshot binario)
+void diccionarioSinRechazados() {
+    std::string dir = directorioPrueba("diccionario_sin_rechazados");
+    BibliotecaDB db;
+    db.setDirectorio(dir);
+    poblar(db);
+    VERIFICAR(!db.agregarEstudiante(1, "Luis Perez", "Grado Nuevo"));
+    VERIFICAR(!db.agregarAutor(1, "Autor Dos", "Nacionalidad Nueva"));
+    std::istringstream entrada("agregar estudiante Luis 2,Grado Nuevo\n"
+                               "transaccion\nagregar estudiante Luis Perez,Grado Nuevo\n"
+                               "agregar autor Autor Dos,Nacionalidad Nueva\nrevertir\n");
+    std::ostringstream salida;
+    ejecutarLote(db, entrada, salida);
+    VERIFICAR(db.estudiantes.size() == 1 && db.autores.size() == 1);
+    VERIFICAR(db.textoGrado(1).empty() && db.textoNacionalidad(1).empty());
+    VERIFICAR(db.agregarEstudiante(2, "Luis Perez", "Grado Nuevo"));
+    VERIFICAR(db.textoGrado(1) == "Grado Nuevo");
+}
+
+// La poda de buscar no cambia el resultado: los k primeros coinciden con los de una
+// búsqueda sin poda (k = todos los documentos), aunque los mejores tengan IDs altos
+void textoTopK() {
+    IndiceTexto indice;
+    const char* palabras[] = {"comun", "tomo", "historia", "mar", "viaje", "noche"};
+    const int documentos = 20000;
+    for (int id = 1; id < documentos; ++id) {
+        std::string texto = "comun relleno";
+        for (int j = 0; j < 4; ++j) {
+            if ((id * 7 + j * 13) % (j + 2) == 0) texto += std::string(" ") + palabras[(id + j) % 6] + std::to_string(j);
+        }
+        indice.agregar(id, texto + (id % 3 == 0 ? " mar0 mar1" : ""));
+    }
+    indice.agregar(documentos, "comun");          // El más corto: el mejor para "comun"
+    indice.agregar(documentos + 1, "raro comun");
+    std::vector<std::vector<std::string>> consultas = {
+        {"comun"}, {"raro", "comun"}, {"mar0", "tomo1"}, {"historia2", "viaje3", "noche0"}, {"noexiste", "mar1"}};
+    for (const auto& terminos : consultas) {
+        std::vector<Acierto> todos = indice.buscar(terminos, documentos + 2);
+        for (std::size_t k : {1, 10, 100}) {
+            std::vector<Acierto> mejores = indice.buscar(terminos, k);
+            VERIFICAR(mejores.size() == std::min(k, todos.size()));
+            for (std::size_t i = 0; i < mejores.size() && i < todos.size(); ++i) {
+                VERIFICAR(mejores[i].id == todos[i].id && mejores[i].puntaje == todos[i].puntaje);
+            }
+        }
+    }
+    VERIFICAR(indice.buscar({"comun"}, 1).front().id == documentos);
+    VERIFICAR(indice.buscar({"raro", "comun"}, 1).front().id == documentos + 1);
+    indice.eliminar(documentos, "comun");
+    VERIFICAR(indice.buscar({"comun"}, 1).front().id != documentos);
+    VERIFICAR(indice.documentos() == static_cast<std::size_t>(documentos));
+}
+
+// Un ISBN con dígito de control incorrecto se rechaza en los lotes y al cargar los CSV
+// solo se advierte (la fila se conserva)
+void isbnControl() {
+    Isbn isbn;
+    VERIFICAR(Isbn::parsear("978-84-376-0494-7", isbn) && isbn.controlValido());
+    VERIFICAR(Isbn::parsear("0-306-40615-2", isbn) && isbn.controlValido());
+    VERIFICAR(Isbn::parsear("9788437604948", isbn) && !isbn.controlValido());
+    VERIFICAR(Isbn::parsear("0306406153", isbn) && !isbn.controlValido());
+
+    std::string dir = directorioPrueba("isbn_control");
+    {
+        BibliotecaDB db;
+        db.setDirectorio(dir);
+        poblar(db);
+        VERIFICAR(!ejecutarComando(db, "agregar libro Otro libro,9788437604948,2001,1,1"));
+        VERIFICAR(ejecutarComando(db, "agregar libro Otro libro,9788437604947,2001,1,1"));
+        VERIFICAR(db.libros.size() == 2);
+    }
+    {
+        // Un CSV heredado, sin línea de control
+        std::string filas = leerArchivo(dir + "libros.txt");
+        std::ofstream(dir + "libros.txt", std::ios::trunc) << filas.substr(filas.find('\n') + 1)
+                                                           << "3,Heredado,9788437604948,1990,1,1\n";
+    }
+    std::ostringstream mensajes;
+    std::streambuf* anterior = std::cout.rdbuf(mensajes.rdbuf());
+    BibliotecaDB db;
+    db.setDirectorio(dir);
+    db.cargarDatos();
+    std::cout.rdbuf(anterior);
+    VERIFICAR(db.buscarLibroPorId(3).has_value());
+    VERIFICAR(mensajes.str().find("ISBN con digito de control incorrecto (p. ej. libro ID 3)") != std::string::npos);
+}
+
+// Una edición con un ISBN rechazado (inválido o de otro libro) no cambia nada: ni el título
+// ingresado antes ni sus índices, en memoria ni al volver a cargar
+void actualizarLibroRechazado() {
+    std::string dir = directorioPrueba("actualizar_libro_rechazado");
+    {
+        BibliotecaDB db;
+        db.setDirectorio(dir);
+        poblar(db, 2);
+        for (std::string isbn : {std::string("9788437604948"), libroDePrueba(2).isbn.texto()}) {
+            std::istringstream entrada("\nTitulo nuevo\n" + isbn + "\n");
+            std::streambuf* anterior = std::cin.rdbuf(entrada.rdbuf());
+            bool actualizado = db.actualizarLibro(1);
+            std::cin.rdbuf(anterior);
+            VERIFICAR(!actualizado);
+        }
+        VERIFICAR(db.buscarLibroPorId(1)->titulo == "Libro 1");
+        VERIFICAR(db.completarLibros("titulo").empty() && db.completarLibros("libro").size() == 2);
+        auto l = db.buscarLibroPorIsbn(libroDePrueba(1).isbn.texto());
+        VERIFICAR(l && l->id == 1);
+    }
+    BibliotecaDB db;
+    db.setDirectorio(dir);
+    VERIFICAR(db.cargarDatos());
+    VERIFICAR(db.buscarLibroPorId(1)->titulo == "Libro 1");
+}
+
+// Mientras un escritor presta y devuelve sin pausa, ninguna lectura de BibliotecaConcurrente
+// ve una escritura a medias: a lo sumo un préstamo abierto, el préstamo activo de cada libro
+// es suyo y sigue abierto, y el último ID asignado existe
+void concurrenteConsistente() {
+    const int libros = 8;
+    const unsigned lectores = 4;
+    std::string dir = directorioPrueba("concurrente_consistente");
+    {
+        BibliotecaDB db;
+        db.setDirectorio(dir);
+        poblar(db, libros);
+    }
+    BibliotecaConcurrente base;
+    base.setDirectorio(dir);
+    VERIFICAR(base.cargarDatos());
+    base.modificar([](BibliotecaDB& db) {
+        db.iniciarLote();
+        return true;
+    });
+
+    std::atomic<bool> fin{false};
+    std::atomic<std::size_t> inconsistentes{0};
+    std::atomic<std::size_t> lecturas{0};
+    std::size_t fallosEscritor = 0;
+    std::thread escritor([&] {
+        Fecha fecha = Fecha::desdeCivil(2026, 1, 15);
+        for (int i = 0; !fin.load(); ++i) {
+            int libro = i % libros + 1;
+            int id = 0;
+            bool prestado = base.modificar([&](BibliotecaDB& db) {
+                id = db.nextPrestamoId();
+                return db.prestarLibro(libro, 1, fecha);
+            });
+            bool devuelto = base.modificar([&](BibliotecaDB& db) { return db.devolverPrestamo(id, fecha); });
+            if (!prestado || !devuelto) ++fallosEscritor;
+        }
+    });
+    std::vector<std::thread> hilos;
+    for (unsigned h = 0; h < lectores; ++h) {
+        hilos.emplace_back([&] {
+            while (!fin.load()) {
+                bool ok = base.leer([](const BibliotecaDB& db) {
+                    int ultimo = db.nextPrestamoId() - 1;
+                    if (ultimo > 0 && !db.buscarPrestamoPorId(ultimo)) return false;
+                    int abiertos = 0;
+                    for (int libro = 1; libro <= libros; ++libro) {
+                        int activo = db.prestamoActivoDeLibro(libro);
+                        if (!activo) continue;
+                        ++abiertos;
+                        std::optional<Prestamo> p = db.buscarPrestamoPorId(activo);
+                        if (!p || p->id_libro != libro || !p->fecha_devolucion.vacia()) return false;
+                    }
+                    return abiertos <= 1;
+                });
+                if (!ok) inconsistentes.fetch_add(1);
+                lecturas.fetch_add(1);
+            }
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    fin.store(true);
+    for (auto& t : hilos) t.join();
+    escritor.join();
+
+    VERIFICAR(inconsistentes.load() == 0);
+    VERIFICAR(lecturas.load() > 0);
+    VERIFICAR(fallosEscritor == 0);
+    // Al terminar, las dos copias coinciden: ningún libro queda prestado
+    VERIFICAR(base.leer([](const BibliotecaDB& db) {
+        for (int libro = 1; libro <= libros; ++libro) {
+            if (db.prestamoActivoDeLibro(libro)) return false;
+        }
+        return db.nextPrestamoId() > 1;
+    }));
+}
+
+// Con registros de ancho fijo una devolución solo reescribe bytes de su registro: el resto
+// de prestamos.txt y su generación anterior no cambian, y al recargar se ve devuelto
+void devolucionEnLugar() {
+    std::string dir = directorioPrueba("devolucion_en_lugar");
+    const std::size_t registro = 64; // LARGO_REGISTRO; la cabecera ocupa el primero
+    {
+        BibliotecaDB db;
+        db.setDirectorio(dir);
+        db.setPrestamosAnchoFijo(true);
+        poblar(db, 3);
+        for (int libro = 1; libro <= 3; ++libro) VERIFICAR(db.prestarLibro(libro, 1, Fecha::desdeCivil(2025, 2, 1)));
+        std::string antes = leerArchivo(dir + "prestamos.txt");
+        std::string anterior = leerArchivo(dir + "prestamos.txt.anterior");
+        VERIFICAR(antes.compare(0, 6, "#fijo,") == 0 && antes.size() == 4 * registro);
+        VERIFICAR(db.devolverPrestamo(2, Fecha::desdeCivil(2025, 2, 10)));
+        std::string despues = leerArchivo(dir + "prestamos.txt");
+        VERIFICAR(despues.size() == antes.size());
+        VERIFICAR(despues.compare(0, 2 * registro, antes, 0, 2 * registro) == 0);
+        VERIFICAR(despues.compare(3 * registro, registro, antes, 3 * registro, registro) == 0);
+        VERIFICAR(despues != antes);
+        VERIFICAR(leerArchivo(dir + "prestamos.txt.anterior") == anterior);
+    }
+    BibliotecaDB db;
+    db.setDirectorio(dir);
+    VERIFICAR(db.cargarDatos());
+    auto p = db.buscarPrestamoPorId(2);
+    VERIFICAR(p && p->fecha_devolucion == Fecha::desdeCivil(2025, 2, 10));
+    VERIFICAR(db.prestamoActivoDeLibro(1) == 1 && db.prestamoActivoDeLibro(2) == 0 && db.prestamoActivoDeLibro(3) == 3);
+}
+
+// Una devolución en el lugar interrumpida solo deja mal el checksum de todo el registro: ese
+// préstamo sigue activo, el archivo no se aparta como dañado y el registro se reescribe en
+// disco, así que la siguiente carga ya no advierte nada. Un byte alterado fuera de la fecha
+// de devolución no lo deja una devolución: el archivo se aparta y se carga la generación anterior
+void registroInterrumpido() {
+    std::string dir = directorioPrueba("registro_interrumpido");
+    const std::size_t registro = 64;
+    const std::size_t devolucion = 44; // Desplazamiento de la fecha de devolución
+    {
+        BibliotecaDB db;
+        db.setDirectorio(dir);
+        db.setPrestamosAnchoFijo(true);
+        poblar(db, 3);
+        for (int libro = 1; libro <= 3; ++libro) VERIFICAR(db.prestarLibro(libro, 1, Fecha::desdeCivil(2025, 2, 1)));
+        VERIFICAR(db.devolverPrestamo(2, Fecha::desdeCivil(2025, 2, 10)));
+        VERIFICAR(db.devolverPrestamo(3, Fecha::desdeCivil(2025, 2, 11)));
+    }
+    auto alterar = [&](std::size_t posicion, const char* bytes) {
+        std::string archivo = leerArchivo(dir + "prestamos.txt");
+        archivo.replace(posicion, std::strlen(bytes), bytes);
+        std::ofstream(dir + "prestamos.txt", std::ios::binary | std::ios::trunc) << archivo;
+    };
+    auto cargar = [&](BibliotecaDB& db, std::string& mensajes) {
+        std::ostringstream salida;
+        std::streambuf* anterior = std::cout.rdbuf(salida.rdbuf());
+        db.setDirectorio(dir);
+        bool cargada = db.cargarDatos();
+        std::cout.rdbuf(anterior);
+        mensajes = salida.str();
+        return cargada;
+    };
+    alterar(2 * registro + devolucion + 6, "    "); // Préstamo 2: fecha a medias
+    for (int carga = 0; carga < 2; ++carga) {
+        BibliotecaDB db;
+        std::string mensajes;
+        VERIFICAR(cargar(db, mensajes));
+        VERIFICAR((mensajes.find("registro 2 de prestamos.txt") != std::string::npos) == (carga == 0));
+        VERIFICAR(!std::filesystem::exists(dir + "prestamos.txt.danado"));
+        VERIFICAR(db.prestamos.size() == 3);
+        VERIFICAR(db.prestamoActivoDeLibro(1) == 1 && db.prestamoActivoDeLibro(2) == 2);
+        auto p = db.buscarPrestamoPorId(3);
+        VERIFICAR(p && p->fecha_devolucion == Fecha::desdeCivil(2025, 2, 11));
+    }
+    // Préstamo 3: id_libro 3 pasa a 2, que pasaría por un préstamo válido si solo se resellara
+    alterar(3 * registro + 11 + 9, "2");
+    BibliotecaDB db;
+    std::string mensajes;
+    VERIFICAR(cargar(db, mensajes));
+    VERIFICAR(mensajes.find("se interrumpio") == std::string::npos);
+    VERIFICAR(std::filesystem::exists(dir + "prestamos.txt.danado"));
+    VERIFICAR(mensajes.find("generacion anterior de prestamos.txt") != std::string::npos);
+    VERIFICAR(db.prestamos.size() == 2); // Antes del tercer préstamo
+    VERIFICAR(db.prestamoActivoDeLibro(1) == 1 && db.prestamoActivoDeLibro(2) == 2);
+}
+
+// biblioteca.bin conserva las cinco tablas, los diccionarios y las fechas, y los índices se
+// reconstruyen al cargarlo; un byte alterado hace fallar la carga en lugar de dar datos incorrectos
+void snapshotBinario() {
+    std::string dir = directorioPrueba("snapshot_binario");
+    {
+        BibliotecaDB db;
+        db.setDirectorio(dir);
+        poblar(db, 3);
+        VERIFICAR(db.agregarEstudiante(2, "Beto Diaz", "2do"));
+        VERIFICAR(db.prestarLibro(1, 2, Fecha::desdeCivil(2025, 3, 1)));
+        VERIFICAR(db.devolverPrestamo(1, Fecha::desdeCivil(2025, 3, 4)));
+        VERIFICAR(db.prestarLibro(2, 1, Fecha::desdeCivil(2025, 3, 5)));
+        VERIFICAR(db.guardarDatosBinario());
+    }
+    {
+        BibliotecaDB db;
+        db.setDirectorio(dir);
+        VERIFICAR(db.snapshotBinarioVigente());
+        VERIFICAR(db.cargarDatosBinario());
+        VERIFICAR(db.estudiantes.size() == 2 && db.libros.size() == 3 && db.prestamos.size() == 2);
+        auto e = db.buscarEstudiantePorId(2);
+        VERIFICAR(e && e->nombre == "Beto Diaz" && db.textoGrado(e->grado) == "2do");
+        auto devuelto = db.buscarPrestamoPorId(1);
+        VERIFICAR(devuelto && devuelto->fecha_devolucion == Fecha::desdeCivil(2025, 3, 4));
+        VERIFICAR(db.prestamoActivoDeLibro(2) == 2 && db.prestamoActivoDeLibro(1) == 0);
+        auto l = db.buscarLibroPorIsbn(libroDePrueba(3).isbn.texto());
+        VERIFICAR(l && l->id == 3);
+        VERIFICAR(db.nextPrestamoId() == 3);
+    }
+    std::string bin = leerArchivo(dir + "biblioteca.bin");
+    bin[bin.size() / 2] ^= 1;
+    std::ofstream(dir + "biblioteca.bin", std::ios::binary | std::ios::trunc) << bin;
+    BibliotecaDB db;
+    db.setDirectorio(dir);
+    VERIFICAR(!db.cargarDatosBinario());
+}
+
+// Un CSV alterado (p. ej. escrito a medias por otro programa) se aparta como .danado y se
+// carga su generación anterior; sin ninguna válida, la tabla queda vacía y se reporta
+void generacionAnterior() {
+    std::string dir = directorioPrueba("generacion_anterior");
+    {
+        BibliotecaDB db;
+        db.setDirectorio(dir);
+        poblar(db, 1);
+        VERIFICAR(db.agregarLibro(libroDePrueba(2)));
+    }
+    auto alterar = [&](const std::string& archivo) {
+        std::string contenido = leerArchivo(dir + archivo);
+        contenido[contenido.size() - 3] ^= 1;
+        std::ofstream(dir + archivo, std::ios::binary | std::ios::trunc) << contenido;
+    };
+    alterar("libros.txt");
+    {
+        BibliotecaDB db;
+        db.setDirectorio(dir);
+        VERIFICAR(db.cargarDatos());
+        VERIFICAR(db.libros.size() == 1 && db.buscarLibroPorId(1));
+        VERIFICAR(std::filesystem::exists(dir + "libros.txt.danado"));
+        VERIFICAR(!std::filesystem::exists(dir + "libros.txt.anterior"));
+        VERIFICAR(db.buscarEstudiantePorId(1) != nullptr); // Las demás tablas no se tocan
+    }
+    alterar("libros.txt");
+    BibliotecaDB db;
+    db.setDirectorio(dir);
+    VERIFICAR(!db.cargarDatos());
+    VERIFICAR(db.libros.empty() && db.buscarEstudiantePorId(1));
+}
+
+// Una escritura de varias tablas interrumpida después de confirmarse (escritura.commit con
+// sus temporales) se completa al cargar; sin la confirmación, los temporales se descartan
+void escrituraInterrumpida() {
+    std::string dir = directorioPrueba("escritura_interrumpida");
+    std::string estudiantesA, librosA, estudiantesB, librosB;
+    {
+        BibliotecaDB db;
+        db.setDirectorio(dir);
+        poblar(db, 1);
+        estudiantesA = leerArchivo(dir + "estudiantes.txt");
+        librosA = leerArchivo(dir + "libros.txt");
+        VERIFICAR(db.iniciarTransaccion());
+        VERIFICAR(db.agregarEstudiante(2, "Beto Diaz", "2do"));
+        VERIFICAR(db.agregarLibro(libroDePrueba(2)));
+        VERIFICAR(db.confirmarTransaccion());
+        estudiantesB = leerArchivo(dir + "estudiantes.txt");
+        librosB = leerArchivo(dir + "libros.txt");
+    }
+    auto escribir = [&](const std::string& archivo, const std::string& contenido) {
+        std::ofstream(dir + archivo, std::ios::binary | std::ios::trunc) << contenido;
+    };
+    // Corte tras confirmar: los temporales tienen la escritura nueva, los CSV la anterior
+    escribir("estudiantes.txt", estudiantesA);
+    escribir("libros.txt", librosA);
+    escribir("estudiantes.txt.tmp", estudiantesB);
+    escribir("libros.txt.tmp", librosB);
+    escribir("escritura.commit", "0\n3\n");
+    {
+        BibliotecaDB db;
+        db.setDirectorio(dir);
+        VERIFICAR(db.cargarDatos());
+        VERIFICAR(db.buscarEstudiantePorId(2) && db.buscarLibroPorId(2));
+        VERIFICAR(!std::filesystem::exists(dir + "escritura.commit"));
+        VERIFICAR(!std::filesystem::exists(dir + "libros.txt.tmp"));
+    }
+    // Corte antes de confirmar: solo un temporal, que no debe aplicarse
+    escribir("estudiantes.txt", estudiantesA);
+    escribir("libros.txt", librosA);
+    escribir("libros.txt.tmp", librosB);
+    BibliotecaDB db;
+    db.setDirectorio(dir);
+    VERIFICAR(db.cargarDatos());
+    VERIFICAR(!db.buscarEstudiantePorId(2) && !db.buscarLibroPorId(2) && db.buscarLibroPorId(1));
+    VERIFICAR(!std::filesystem::exists(dir + "libros.txt.tmp"));
+}
+
+// Los validadores sin std::regex aceptan y rechazan lo mismo que los patrones que reemplazaron
+void validadores() {
+    VERIFICAR(esFechaValida("2024-02-29") && !esFechaValida("2023-02-29"));
+    VERIFICAR(!esFechaValida("2024-13-01") && !esFechaValida("2024-1-01") && !esFechaValida(""));
+    VERIFICAR(esIsbnValido("978-84-376-0494-7") && esIsbnValido("0-306-40615-2"));
+    VERIFICAR(!esIsbnValido("978-84-376-0494-8") && !esIsbnValido("0306406153") && !esIsbnValido("978-"));
+    VERIFICAR(esNombreValido("Ana Lopez") && !esNombreValido("") && !esNombreValido("Ana3"));
+    VERIFICAR(esTextoValido("Tomo 2") && !esTextoValido("") && !esTextoValido("a,b"));
+}
+
+// Altas concurrentes sin ID en una base fragmentada: cada una recibe un ID distinto.
+// Después, un préstamo con el libro y el estudiante en fragmentos distintos bloquea la baja
+// del estudiante hasta devolverse, y todo sobrevive a guardar y recargar
+void fragmentosPrestamoCruzado() {
+    const int hilos = 4;
+    const int porHilo = 25;
+    std::string dir = directorioPrueba("fragmentos_prestamo_cruzado");
+    std::vector<std::vector<int>> estudiantes(hilos), libros(hilos);
+    {
+        BibliotecaFragmentada base(3);
+        base.setDirectorio(dir);
+        VERIFICAR(base.guardarDatos());
+        VERIFICAR(base.agregarAutor(1, "Autor Uno", "MX"));
+        VERIFICAR(base.agregarEditorial({1, "Editorial Uno"}));
+        std::vector<std::thread> t;
+        for (int h = 0; h < hilos; ++h) {
+            t.emplace_back([&, h] {
+                for (int i = 0; i < porHilo; ++i) {
+                    estudiantes[h].push_back(base.agregarEstudiante("Estudiante", "1ro"));
+                    libros[h].push_back(base.agregarLibroNuevo(libroDePrueba(h * porHilo + i + 1)));
+                }
+            });
+        }
+        for (auto& hilo : t) hilo.join();
+        std::set<int> idsEstudiante, idsLibro;
+        for (int h = 0; h < hilos; ++h) {
+            idsEstudiante.insert(estudiantes[h].begin(), estudiantes[h].end());
+            idsLibro.insert(libros[h].begin(), libros[h].end());
+        }
+        VERIFICAR(idsEstudiante.size() == hilos * porHilo && !idsEstudiante.count(0));
+        VERIFICAR(idsLibro.size() == hilos * porHilo && !idsLibro.count(0));
+        VERIFICAR(base.nextEstudianteId() == hilos * porHilo + 1);
+
+        // Un ID explícito adelanta el contador
+        VERIFICAR(base.agregarEstudiante(500, "Importado", "2do"));
+        VERIFICAR(base.agregarEstudiante("Siguiente", "2do") == 501);
+
+        int estudiante = 2, libro = 3;
+        VERIFICAR(base.fragmentoDe(estudiante) != base.fragmentoDe(libro));
+        int prestamo = base.prestarLibro(libro, estudiante, Fecha::desdeCivil(2026, 3, 1));
+        VERIFICAR(prestamo != 0);
+        VERIFICAR(base.leer(libro, [&](const BibliotecaDB& db) { return db.prestamoActivoDeLibro(libro); }) == prestamo);
+        VERIFICAR(!base.eliminarEstudiante(estudiante));
+        VERIFICAR(base.devolverPrestamo(prestamo, Fecha::desdeCivil(2026, 3, 8)));
+        VERIFICAR(base.prestarLibro(libro, estudiante, Fecha::desdeCivil(2026, 3, 9)) != 0);
+    }
+    BibliotecaFragmentada base(3);
+    base.setDirectorio(dir);
+    VERIFICAR(base.cargarDatos());
+    VERIFICAR(base.nextEstudianteId() == 502);
+    VERIFICAR(base.nextLibroId() == hilos * porHilo + 1);
+    VERIFICAR(base.leer(3, [](const BibliotecaDB& db) {
+        std::optional<Prestamo> p = db.buscarPrestamoPorId(db.prestamoActivoDeLibro(3));
+        return p && p->id_estudiante == 2 && p->fecha_prestamo == Fecha::desdeCivil(2026, 3, 9);
+    }));
+    VERIFICAR(!base.eliminarEstudiante(2));
+}
+
+struct Prueba {
+    std::string nombre;
+    std::function<void()> ejecutar;
+};
+
+std::vector<Prueba> pruebas() {
+    return {
+        {"diario_sin_cerrar", diarioSinCerrar},
+        {"diario_reproduce", diarioReproduce},
+        {"diario_truncado", diarioTruncado},
+        {"diccionario_sin_rechazados", diccionarioSinRechazados},
+        {"texto_top_k", textoTopK},
+        {"isbn_control", isbnControl},
+        {"actualizar_libro_rechazado", actualizarLibroRechazado},
+        {"devolucion_en_lugar", devolucionEnLugar},
+        {"registro_interrumpido", registroInterrumpido},
+        {"snapshot_binario", snapshotBinario},
+        {"generacion_anterior", generacionAnterior},
+        {"escritura_interrumpida", escrituraInterrumpida},
+        {"validadores", validadores},
+        {"concurrente_consistente", concurrenteConsistente},
+        {"fragmentos_prestamo_cruzado", fragmentosPrestamoCruzado},
+    };
+}
+
+} // namespace
+
+/* Uso: pruebas.exe [prefijo ...]
+ * Ejecuta las pruebas cuyo nombre empieza por alguno de los prefijos (todas por omisión)
+ * y reporta las fallidas; el código de salida es 1 si alguna falla.
+ */
+int main(int argc, char* argv[]) {
+    int ejecutadas = 0, fallidas = 0;
+    for (const auto& p : pruebas()) {
+        bool elegida = argc == 1;
+        for (int i = 1; i < argc; ++i) elegida = elegida || p.nombre.compare(0, std::string(argv[i]).size(), argv[i]) == 0;
+        if (!elegida) continue;
+        fallosPrueba = 0;
+        {
+            Silencio silencio;
+            p.ejecutar();
+        }
+        ++ejecutadas;
+        if (fallosPrueba != 0) ++fallidas;
+        std::cout << (fallosPrueba == 0 ? "ok    " : "FALLA ") << p.nombre << "\n";
+    }
+    std::filesystem::remove_all(DIRECTORIO);
+    std::cout << ejecutadas - fallidas << "/" << ejecutadas << " pruebas correctas\n";
+    return fallidas == 0 ? 0 : 1;
+}